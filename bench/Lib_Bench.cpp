@@ -0,0 +1,1343 @@
+//? Microbenchmarks of "Math.hpp", "Math_Wide.hpp" and "Allocators.hpp" primitives, separate executable from the platform layers.
+//? Every op is measured in two ways:
+//?   batch - op over 1024 independent inputs (L1 resident), results stored to memory: throughput under batch use,
+//?           the compiler is free to interleave or vectorize iterations like it would in real loops
+//?   chain - result of an op is its next input: latency of a single op, reported only when result type == input type.
+//?           Chains of plain adds are left out, with "-ffast-math" the compiler reassociates them into parallel sums
+//? Allocator ops are timed as runs of "op_count" calls on a freshly reset allocator.
+//? Cycles are TSC (reference) cycles, best of "-reps" runs. Comparison groups ("dot4 ...", "clamp ...") settle
+//? design TODOs of Math.hpp by measuring the alternative implementations side by side
+
+// Standard headers go first, "internal" macro of Utils.hpp collides with identifiers inside of them
+#include <chrono>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cassert>
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+#include "Utils.hpp"
+#include "Math.hpp"
+#include "Math_Wide.hpp"
+#include "Vertex_Transform.hpp"
+#include "Culling.hpp"
+#include "Allocators.hpp"
+#include "VM_Array.hpp"
+#include "VM_Pages.hpp"
+
+constexpr u32 BENCH_BATCH = 1024;        // inputs of every batch, power of 2
+constexpr u32 BENCH_BATCH_PASSES = 64;   // passes over the batch per measured run
+constexpr u32 BENCH_CHAIN_LENGTH = 1 << 16;
+constexpr u32 BENCH_MAX_RESULTS = 512;
+constexpr u32 BENCH_MAX_ACCURACIES = 64;
+
+#if defined(_MSC_VER)
+#define BenchClobber() _ReadWriteBarrier()
+inline void bench_escape(const void *p) { static const void *volatile sink; sink = p; _ReadWriteBarrier(); }
+#else
+//? Compiler must assume all memory is read and written here, so stores before it are never dropped
+#define BenchClobber() asm volatile("" ::: "memory")
+inline void bench_escape(const void *p) { asm volatile("" : : "g"(p) : "memory"); }
+#endif
+
+struct Bench_Result
+{
+	const char *group;
+	const char *name;
+	const char *mode; // "batch", "chain", "alloc" or "stream" (one pass over memory sized data)
+	u64 op_count;     // ops of a single run
+	f64 cycles_per_op;
+	f64 ns_per_op;
+};
+
+//? Error of an approximation against a double precision reference over the bench inputs
+struct Bench_Accuracy
+{
+	const char *group;
+	const char *name;
+	f64 max_abs_error;
+	f64 max_rel_error;
+	u32 sample_count;
+};
+
+struct Bench_Suite
+{
+	Bench_Result results[BENCH_MAX_RESULTS];
+	u32 result_count;
+	Bench_Accuracy accuracies[BENCH_MAX_ACCURACIES];
+	u32 accuracy_count;
+	u32 reps;
+	u32 failed_checks; // results of optimized paths that differ from their reference, lib_bench exits with 1 then
+	const char *filter; // only groups containing this substring
+	f64 tsc_per_ns;
+};
+
+struct Bench_Inputs
+{
+	f32 f[BENCH_BATCH];
+	lib::Vec2 v2[2][BENCH_BATCH];
+	lib::Vec3 v3[2][BENCH_BATCH];
+	lib::Vec4 v4[2][BENCH_BATCH];
+	lib::Mat4 m4[2][BENCH_BATCH];
+	lib::Trans4 t4[2][BENCH_BATCH];
+	f32 v3_soa[2][3][BENCH_BATCH]; // "v3" as x, y, z streams, unaligned loads (inputs are calloc-ed)
+	f32 v4_soa[2][4][BENCH_BATCH]; // "v4" as x, y, z, w streams
+	f32 unit[BENCH_BATCH];         // [0, 1], interpolation factors
+	lib::Quat q[2][BENCH_BATCH];
+	lib::DualQuat dq[2][BENCH_BATCH];
+};
+
+internal f64 bench_now_ns()
+{
+	return std::chrono::duration<f64, std::nano>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+internal b32 bench_is_enabled(const Bench_Suite *suite, const char *group)
+{
+	return !suite->filter || strstr(group, suite->filter);
+}
+
+//? Times "reps" runs of "body" (each doing "op_count" ops), "reset" is called untimed before every run.
+//? Best run wins - it is the one least disturbed by interrupts and frequency changes
+template <typename R, typename F>
+internal void bench_measure(Bench_Suite *suite, const char *group, const char *name, const char *mode, u64 op_count,
+                            const R &reset, const F &body)
+{
+	if (suite->result_count >= BENCH_MAX_RESULTS)
+		return;
+
+	f64 best_cycles = 1e300;
+	f64 best_ns = 1e300;
+	for (u32 rep = 0; rep < suite->reps; ++rep)
+	{
+		reset();
+		BenchClobber();
+		f64 ns_start = bench_now_ns();
+		u64 tsc_start = __rdtsc();
+		body();
+		BenchClobber();
+		u64 tsc_end = __rdtsc();
+		f64 ns_end = bench_now_ns();
+
+		if ((f64)(tsc_end - tsc_start) < best_cycles)
+		{
+			best_cycles = (f64)(tsc_end - tsc_start);
+			best_ns = ns_end - ns_start;
+		}
+	}
+
+	suite->results[suite->result_count++] = { group, name, mode, op_count, best_cycles / (f64)op_count, best_ns / (f64)op_count };
+}
+
+//? "op(i)" computes result from i-th inputs of the batch
+template <typename F>
+internal void bench_batch(Bench_Suite *suite, const char *group, const char *name, const F &op)
+{
+	using T = decltype(op(0u));
+	alignas(64) static T out[BENCH_BATCH];
+	bench_measure(suite, group, name, "batch", (u64)BENCH_BATCH * BENCH_BATCH_PASSES, [] {}, [&]
+	{
+		for (u32 pass = 0; pass < BENCH_BATCH_PASSES; ++pass)
+		{
+			for (u32 i = 0; i < BENCH_BATCH; ++i)
+				out[i] = op(i);
+			bench_escape(out);
+		}
+	});
+}
+
+//? "op(i)" computes 8 results from inputs i..i+7 (Math_Wide.hpp types), cost is reported per element
+//? so it compares directly with "bench_batch" of the scalar op
+template <typename F>
+internal void bench_wide_batch(Bench_Suite *suite, const char *group, const char *name, const F &op)
+{
+	static_assert(BENCH_BATCH % lib::WIDE_LANES == 0);
+	using T = decltype(op(0u));
+	alignas(64) static T out[BENCH_BATCH / lib::WIDE_LANES];
+	bench_measure(suite, group, name, "batch", (u64)BENCH_BATCH * BENCH_BATCH_PASSES, [] {}, [&]
+	{
+		for (u32 pass = 0; pass < BENCH_BATCH_PASSES; ++pass)
+		{
+			for (u32 i = 0; i < BENCH_BATCH; i += lib::WIDE_LANES)
+				out[i / lib::WIDE_LANES] = op(i);
+			bench_escape(out);
+		}
+	});
+}
+
+//? "op(x)" returns next x of the dependency chain
+template <typename T, typename F>
+internal void bench_chain(Bench_Suite *suite, const char *group, const char *name, const T seed, const F &op)
+{
+	bench_measure(suite, group, name, "chain", BENCH_CHAIN_LENGTH, [] {}, [&]
+	{
+		T x = seed;
+		for (u32 i = 0; i < BENCH_CHAIN_LENGTH; ++i)
+			x = op(x);
+		bench_escape(&x);
+	});
+}
+
+internal void bench_accuracy(Bench_Suite *suite, const char *group, const char *name, f64 max_abs_error, f64 max_rel_error, u32 sample_count)
+{
+	assert(suite->accuracy_count < BENCH_MAX_ACCURACIES);
+	suite->accuracies[suite->accuracy_count++] = { group, name, max_abs_error, max_rel_error, sample_count };
+}
+
+//? Optimized path must give exactly what its reference gives, checked before it is timed
+internal void bench_check(Bench_Suite *suite, const char *group, const char *name, b32 is_matching)
+{
+	if (is_matching)
+		return;
+	fprintf(stderr, "%s: %s differs from its reference\n", group, name);
+	suite->failed_checks++;
+}
+
+// ===============================================================================================================================
+// ======================================================= INPUT DATA ============================================================
+// ===============================================================================================================================
+internal f32 bench_random(u32 *state)
+{
+	*state ^= *state << 13;
+	*state ^= *state >> 17;
+	*state ^= *state << 5;
+	return (f32)(*state & 0xFFFFFF) / (f32)0xFFFFFF * 2.0f - 1.0f; // [-1, 1]
+}
+
+//? Rotation around normalized random axis, uniform scale and translation - what "Trans4" is meant to hold
+internal lib::Trans4 bench_random_transform(u32 *state)
+{
+	lib::Vec3 axis = lib::normalize(lib::Vec3{ bench_random(state), bench_random(state), bench_random(state) + 2.0f });
+	f32 angle = bench_random(state) * PI32;
+	f32 scale = 1.5f + bench_random(state);
+	f32 c = cosf(angle), s = sinf(angle), t = 1.0f - c;
+
+	lib::Trans4 out = lib::create_diagonal_transform(1.0f);
+	out.e[0][0] = scale * (t * axis.x * axis.x + c);
+	out.e[0][1] = scale * (t * axis.x * axis.y + s * axis.z);
+	out.e[0][2] = scale * (t * axis.x * axis.z - s * axis.y);
+	out.e[1][0] = scale * (t * axis.x * axis.y - s * axis.z);
+	out.e[1][1] = scale * (t * axis.y * axis.y + c);
+	out.e[1][2] = scale * (t * axis.y * axis.z + s * axis.x);
+	out.e[2][0] = scale * (t * axis.x * axis.z + s * axis.y);
+	out.e[2][1] = scale * (t * axis.y * axis.z - s * axis.x);
+	out.e[2][2] = scale * (t * axis.z * axis.z + c);
+	out.e[3][0] = 10.0f * bench_random(state);
+	out.e[3][1] = 10.0f * bench_random(state);
+	out.e[3][2] = 10.0f * bench_random(state);
+	return out;
+}
+
+internal void bench_fill_inputs(Bench_Inputs *in)
+{
+	u32 state = 0x2545F491u;
+	for (u32 i = 0; i < BENCH_BATCH; ++i)
+	{
+		in->f[i] = 1.0f + 4.0f * lib::abs(bench_random(&state));
+		for (u32 k = 0; k < 2; ++k)
+		{
+			in->v2[k][i] = { bench_random(&state), bench_random(&state) };
+			in->v3[k][i] = { bench_random(&state), bench_random(&state), bench_random(&state) };
+			in->v4[k][i] = { bench_random(&state), bench_random(&state), bench_random(&state), bench_random(&state) };
+			for (u32 c = 0; c < 4; ++c)
+				in->m4[k][i][c] = { bench_random(&state), bench_random(&state), bench_random(&state), bench_random(&state) };
+			in->t4[k][i] = bench_random_transform(&state);
+			for (u32 c = 0; c < 3; ++c)
+				in->v3_soa[k][c][i] = in->v3[k][i][c];
+			for (u32 c = 0; c < 4; ++c)
+				in->v4_soa[k][c][i] = in->v4[k][i][c];
+
+			lib::Vec3 axis = lib::normalize(lib::Vec3{ bench_random(&state), bench_random(&state), bench_random(&state) });
+			in->q[k][i] = lib::create_quat(axis, bench_random(&state) * PI32);
+			in->dq[k][i] = lib::create_dual_quat(in->q[k][i], 10.0f * in->v3[k][i]);
+		}
+		in->unit[i] = lib::abs(bench_random(&state));
+	}
+}
+
+// ===============================================================================================================================
+// ========================================================= MATH ================================================================
+// ===============================================================================================================================
+internal void bench_scalar(Bench_Suite *suite, const Bench_Inputs *in)
+{
+	const char *group = "scalar";
+	if (!bench_is_enabled(suite, group))
+		return;
+
+	const f32 *f = in->f;
+	bench_batch(suite, group, "load (loop overhead)", [&](u32 i) { return f[i]; });
+	bench_batch(suite, group, "sqrt", [&](u32 i) { return lib::sqrt(f[i]); });
+	bench_chain(suite, group, "sqrt", f[0], [](f32 x) { return lib::sqrt(x); });
+	bench_batch(suite, group, "rsqrt", [&](u32 i) { return lib::rsqrt(f[i]); });
+	bench_chain(suite, group, "rsqrt", f[0], [](f32 x) { return lib::rsqrt(x); });
+	bench_batch(suite, group, "ceil", [&](u32 i) { return lib::ceil(f[i]); });
+	bench_batch(suite, group, "floor", [&](u32 i) { return lib::floor(f[i]); });
+	bench_batch(suite, group, "round", [&](u32 i) { return lib::round(f[i]); });
+	bench_batch(suite, group, "trunc", [&](u32 i) { return lib::trunc(f[i]); });
+	bench_batch(suite, group, "min", [&](u32 i) { return lib::min(f[i], 2.5f); });
+	bench_batch(suite, group, "max", [&](u32 i) { return lib::max(f[i], 2.5f); });
+	bench_batch(suite, group, "abs", [&](u32 i) { return lib::abs(f[i] - 2.5f); });
+	bench_batch(suite, group, "lerp", [&](u32 i) { return lib::lerp(f[i], 3.0f, 0.25f); });
+	bench_chain(suite, group, "lerp", f[0], [](f32 x) { return lib::lerp(x, 3.0f, 0.25f); });
+	bench_batch(suite, group, "inv_lerp", [&](u32 i) { return lib::inv_lerp(1.0f, 5.0f, f[i]); });
+	bench_batch(suite, group, "remap_range", [&](u32 i) { return lib::remap_range(1.0f, 5.0f, -1.0f, 1.0f, f[i]); });
+
+	// "Naive solutions produce better assembly in optimized than SIMD version for clamp, min, max, abs, lerp"
+	group = "clamp naive vs sse";
+	bench_batch(suite, group, "lib::clamp", [&](u32 i) { return lib::clamp(f[i], 2.0f, 4.0f); });
+	bench_chain(suite, group, "lib::clamp", f[0], [](f32 x) { return lib::clamp(x * 1.5f, 2.0f, 4.0f); });
+	bench_batch(suite, group, "minss/maxss", [&](u32 i)
+	{
+		return _mm_cvtss_f32(_mm_min_ss(_mm_max_ss(_mm_set_ss(f[i]), _mm_set_ss(2.0f)), _mm_set_ss(4.0f)));
+	});
+	bench_chain(suite, group, "minss/maxss", f[0], [](f32 x)
+	{
+		return _mm_cvtss_f32(_mm_min_ss(_mm_max_ss(_mm_set_ss(x * 1.5f), _mm_set_ss(2.0f)), _mm_set_ss(4.0f)));
+	});
+}
+
+internal void bench_vec2(Bench_Suite *suite, const Bench_Inputs *in)
+{
+	const char *group = "vec2";
+	if (!bench_is_enabled(suite, group))
+		return;
+
+	const lib::Vec2 *a = in->v2[0], *b = in->v2[1];
+	lib::Vec2 n = lib::normalize(b[0]);
+	bench_batch(suite, group, "add", [&](u32 i) { return a[i] + b[i]; });
+	bench_batch(suite, group, "mul", [&](u32 i) { return a[i] * b[i]; });
+	bench_batch(suite, group, "scale", [&](u32 i) { return a[i] * 0.5f; });
+	bench_batch(suite, group, "dot", [&](u32 i) { return lib::dot(a[i], b[i]); });
+	bench_batch(suite, group, "length", [&](u32 i) { return lib::length_vec(a[i]); });
+	bench_batch(suite, group, "normalize", [&](u32 i) { return lib::normalize(a[i]); });
+	bench_chain(suite, group, "normalize", a[0], [&](lib::Vec2 x) { return lib::normalize(x + n); });
+	bench_batch(suite, group, "normalize_fast", [&](u32 i) { return lib::normalize_fast(a[i]); });
+	bench_chain(suite, group, "normalize_fast", a[0], [&](lib::Vec2 x) { return lib::normalize_fast(x + n); });
+	bench_batch(suite, group, "perp", [&](u32 i) { return lib::perp(a[i]); });
+	bench_batch(suite, group, "perp_dot", [&](u32 i) { return lib::perp_dot(a[i], b[i]); });
+	bench_batch(suite, group, "reflect", [&](u32 i) { return lib::reflect(a[i], n); });
+	bench_chain(suite, group, "reflect", a[0], [&](lib::Vec2 x) { return lib::reflect(x, n); });
+	bench_batch(suite, group, "refract", [&](u32 i) { return lib::refract(a[i], n, 0.75f); });
+	bench_batch(suite, group, "project", [&](u32 i) { return lib::project(a[i], b[i]); });
+	bench_batch(suite, group, "project_norm", [&](u32 i) { return lib::project_norm(a[i], n); });
+	bench_batch(suite, group, "reject", [&](u32 i) { return lib::reject(a[i], b[i]); });
+}
+
+internal void bench_vec3(Bench_Suite *suite, const Bench_Inputs *in)
+{
+	const char *group = "vec3";
+	if (!bench_is_enabled(suite, group))
+		return;
+
+	const lib::Vec3 *a = in->v3[0], *b = in->v3[1];
+	lib::Vec3 n = lib::normalize(b[0]);
+	bench_batch(suite, group, "add", [&](u32 i) { return a[i] + b[i]; });
+	bench_batch(suite, group, "mul", [&](u32 i) { return a[i] * b[i]; });
+	bench_batch(suite, group, "scale", [&](u32 i) { return a[i] * 0.5f; });
+	bench_batch(suite, group, "dot", [&](u32 i) { return lib::dot(a[i], b[i]); });
+	bench_batch(suite, group, "length", [&](u32 i) { return lib::length_vec(a[i]); });
+	bench_batch(suite, group, "normalize", [&](u32 i) { return lib::normalize(a[i]); });
+	bench_chain(suite, group, "normalize", a[0], [&](lib::Vec3 x) { return lib::normalize(x + n); });
+	bench_batch(suite, group, "normalize_fast", [&](u32 i) { return lib::normalize_fast(a[i]); });
+	bench_chain(suite, group, "normalize_fast", a[0], [&](lib::Vec3 x) { return lib::normalize_fast(x + n); });
+	bench_batch(suite, group, "cross", [&](u32 i) { return lib::cross(a[i], b[i]); });
+	bench_chain(suite, group, "cross", a[0], [&](lib::Vec3 x) { return lib::cross(x, n) + n; });
+	bench_batch(suite, group, "reflect", [&](u32 i) { return lib::reflect(a[i], n); });
+	bench_chain(suite, group, "reflect", a[0], [&](lib::Vec3 x) { return lib::reflect(x, n); });
+	bench_batch(suite, group, "refract", [&](u32 i) { return lib::refract(a[i], n, 0.75f); });
+	bench_batch(suite, group, "project", [&](u32 i) { return lib::project(a[i], b[i]); });
+	bench_batch(suite, group, "project_norm", [&](u32 i) { return lib::project_norm(a[i], n); });
+	bench_batch(suite, group, "reject", [&](u32 i) { return lib::reject(a[i], b[i]); });
+}
+
+internal void bench_vec4(Bench_Suite *suite, const Bench_Inputs *in)
+{
+	const char *group = "vec4";
+	if (bench_is_enabled(suite, group))
+	{
+		const lib::Vec4 *a = in->v4[0], *b = in->v4[1];
+		lib::Vec4 n = lib::normalize(b[0]);
+		bench_batch(suite, group, "add", [&](u32 i) { return a[i] + b[i]; });
+		bench_batch(suite, group, "mul", [&](u32 i) { return a[i] * b[i]; });
+		bench_batch(suite, group, "scale", [&](u32 i) { return a[i] * 0.5f; });
+		bench_batch(suite, group, "div", [&](u32 i) { return a[i] / 3.0f; });
+		bench_batch(suite, group, "dot", [&](u32 i) { return lib::dot(a[i], b[i]); });
+		bench_batch(suite, group, "length", [&](u32 i) { return lib::length_vec(a[i]); });
+		bench_batch(suite, group, "normalize", [&](u32 i) { return lib::normalize(a[i]); });
+		bench_chain(suite, group, "normalize", a[0], [&](lib::Vec4 x) { return lib::normalize(x + n); });
+		bench_batch(suite, group, "normalize_fast", [&](u32 i) { return lib::normalize_fast(a[i]); });
+		bench_chain(suite, group, "normalize_fast", a[0], [&](lib::Vec4 x) { return lib::normalize_fast(x + n); });
+		bench_batch(suite, group, "cross", [&](u32 i) { return lib::cross(a[i], b[i]); });
+		bench_chain(suite, group, "cross", a[0], [&](lib::Vec4 x) { return lib::cross(x, n) + n; });
+		bench_batch(suite, group, "reflect", [&](u32 i) { return lib::reflect(a[i], n); });
+		bench_chain(suite, group, "reflect", a[0], [&](lib::Vec4 x) { return lib::reflect(x, n); });
+		bench_batch(suite, group, "refract", [&](u32 i) { return lib::refract(a[i], n, 0.75f); });
+		bench_batch(suite, group, "project", [&](u32 i) { return lib::project(a[i], b[i]); });
+		bench_batch(suite, group, "reject", [&](u32 i) { return lib::reject(a[i], b[i]); });
+	}
+
+	// "Test whether it is faster for Vec4 to do single dots for projection etc. or is it better to do two dots at once",
+	// cost is per single dot product in all three variants
+	group = "dot4 scalar vs simd";
+	if (bench_is_enabled(suite, group))
+	{
+		const lib::Vec4 *a = in->v4[0], *b = in->v4[1];
+		bench_batch(suite, group, "lib::dot (scalar)", [&](u32 i) { return lib::dot(a[i], b[i]); });
+		bench_batch(suite, group, "_mm_dp_ps", [&](u32 i) { return _mm_cvtss_f32(_mm_dp_ps(a[i].simd, b[i].simd, 0xF1)); });
+		bench_batch(suite, group, "mul + hadd", [&](u32 i)
+		{
+			__m128 m = _mm_mul_ps(a[i].simd, b[i].simd);
+			m = _mm_hadd_ps(m, m);
+			return _mm_cvtss_f32(_mm_hadd_ps(m, m));
+		});
+		// Four dots of consecutive pairs at once via transpose, result lane k is dot of pair i+k, every 4th "i" does the work
+		static_assert(BENCH_BATCH % 4 == 0);
+		bench_measure(suite, group, "4 at once (transpose)", "batch", (u64)BENCH_BATCH * BENCH_BATCH_PASSES, [] {}, [&]
+		{
+			alignas(64) static lib::Vec4 out[BENCH_BATCH / 4];
+			for (u32 pass = 0; pass < BENCH_BATCH_PASSES; ++pass)
+			{
+				for (u32 i = 0; i < BENCH_BATCH; i += 4)
+				{
+					__m128 a0 = a[i].simd, a1 = a[i + 1].simd, a2 = a[i + 2].simd, a3 = a[i + 3].simd;
+					__m128 b0 = b[i].simd, b1 = b[i + 1].simd, b2 = b[i + 2].simd, b3 = b[i + 3].simd;
+					_MM_TRANSPOSE4_PS(a0, a1, a2, a3);
+					_MM_TRANSPOSE4_PS(b0, b1, b2, b3);
+					__m128 dots = _mm_mul_ps(a0, b0);
+					dots = _mm_add_ps(dots, _mm_mul_ps(a1, b1));
+					dots = _mm_add_ps(dots, _mm_mul_ps(a2, b2));
+					dots = _mm_add_ps(dots, _mm_mul_ps(a3, b3));
+					out[i / 4].simd = dots;
+				}
+				bench_escape(out);
+			}
+		});
+	}
+}
+
+//? Gauss-Jordan with partial pivoting in doubles, returns determinant
+internal f64 bench_reference_inverse(const lib::Mat4 &m, f64 out[4][4])
+{
+	f64 a[4][8];
+	for (s32 r = 0; r < 4; ++r)
+	{
+		for (s32 c = 0; c < 4; ++c)
+		{
+			a[r][c] = m(r, c);
+			a[r][c + 4] = r == c ? 1.0 : 0.0;
+		}
+	}
+
+	f64 det = 1.0;
+	for (s32 c = 0; c < 4; ++c)
+	{
+		s32 pivot = c;
+		for (s32 r = c + 1; r < 4; ++r)
+			pivot = fabs(a[r][c]) > fabs(a[pivot][c]) ? r : pivot;
+		if (pivot != c)
+		{
+			for (s32 k = 0; k < 8; ++k)
+			{
+				f64 temp = a[c][k];
+				a[c][k] = a[pivot][k];
+				a[pivot][k] = temp;
+			}
+			det = -det;
+		}
+
+		det *= a[c][c];
+		f64 r_pivot = 1.0 / a[c][c];
+		for (s32 k = 0; k < 8; ++k)
+			a[c][k] *= r_pivot;
+		for (s32 r = 0; r < 4; ++r)
+		{
+			f64 factor = a[r][c];
+			for (s32 k = 0; r != c && k < 8; ++k)
+				a[r][k] -= factor * a[c][k];
+		}
+	}
+
+	for (s32 r = 0; r < 4; ++r)
+		for (s32 c = 0; c < 4; ++c)
+			out[r][c] = a[r][c + 4];
+	return det;
+}
+
+//? Relative error is normwise (largest element error / largest element of reference), random matrices include
+//? ill-conditioned ones, so their error is dominated by conditioning and not by the method
+template <typename T>
+internal void bench_mat4_inverse_accuracy(Bench_Suite *suite, const char *group, const char *name, const T *matrices)
+{
+	if (!bench_is_enabled(suite, group))
+		return;
+
+	f64 max_abs = 0.0, max_rel = 0.0;
+	f64 det_max_abs = 0.0, det_max_rel = 0.0;
+	for (u32 i = 0; i < BENCH_BATCH; ++i)
+	{
+		lib::Mat4 m = (lib::Mat4)matrices[i];
+		f64 reference[4][4];
+		f64 det = bench_reference_inverse(m, reference);
+		lib::Mat4 inv = lib::inverse(m);
+
+		f64 abs_error = 0.0, norm = 0.0;
+		for (s32 r = 0; r < 4; ++r)
+		{
+			for (s32 c = 0; c < 4; ++c)
+			{
+				abs_error = lib::max(abs_error, fabs((f64)inv(r, c) - reference[r][c]));
+				norm = lib::max(norm, fabs(reference[r][c]));
+			}
+		}
+		max_abs = lib::max(max_abs, abs_error);
+		max_rel = lib::max(max_rel, abs_error / norm);
+		f64 det_error = fabs((f64)lib::determinant(m) - det);
+		det_max_abs = lib::max(det_max_abs, det_error);
+		det_max_rel = lib::max(det_max_rel, det_error / fabs(det));
+	}
+	bench_accuracy(suite, group, name, max_abs, max_rel, BENCH_BATCH);
+	bench_accuracy(suite, group, strstr(name, "random") ? "determinant (random)" : "determinant (transforms)", det_max_abs, det_max_rel, BENCH_BATCH);
+}
+
+internal void bench_mat4(Bench_Suite *suite, const Bench_Inputs *in)
+{
+	const char *group = "mat4";
+	if (bench_is_enabled(suite, group))
+	{
+		const lib::Mat4 *a = in->m4[0], *b = in->m4[1];
+		const lib::Vec4 *v = in->v4[0];
+		bench_batch(suite, group, "add", [&](u32 i) { return a[i] + b[i]; });
+		bench_batch(suite, group, "sub", [&](u32 i) { return a[i] - b[i]; });
+		bench_batch(suite, group, "scale", [&](u32 i) { return a[i] * 0.5f; });
+		bench_batch(suite, group, "div", [&](u32 i) { return a[i] / 3.0f; });
+		bench_batch(suite, group, "mul mat4", [&](u32 i) { return a[i] * b[i]; });
+		bench_chain(suite, group, "mul mat4", a[0], [&](lib::Mat4 x) { return x * b[0]; });
+		bench_batch(suite, group, "mul vec4", [&](u32 i) { return a[i] * v[i]; });
+		bench_chain(suite, group, "mul vec4", v[0], [&](lib::Vec4 x) { return a[0] * x; });
+		bench_batch(suite, group, "transpose", [&](u32 i) { return lib::transpose(a[i]); });
+		bench_chain(suite, group, "transpose", a[0], [](lib::Mat4 x) { return lib::transpose(x); });
+		bench_batch(suite, group, "determinant", [&](u32 i) { return lib::determinant(a[i]); });
+		bench_batch(suite, group, "adjugate", [&](u32 i) { return lib::adjugate(a[i]); });
+		bench_batch(suite, group, "inverse", [&](u32 i) { return lib::inverse(a[i]); });
+		bench_chain(suite, group, "inverse", a[0], [](lib::Mat4 x) { return lib::inverse(x); });
+		bench_measure(suite, group, "inverse batch (2 per avx op)", "batch", (u64)BENCH_BATCH * BENCH_BATCH_PASSES, [] {}, [&]
+		{
+			alignas(64) static lib::Mat4 out[BENCH_BATCH];
+			for (u32 pass = 0; pass < BENCH_BATCH_PASSES; ++pass)
+			{
+				lib::inverse(a, out, BENCH_BATCH);
+				bench_escape(out);
+			}
+		});
+		bench_mat4_inverse_accuracy(suite, group, "inverse (random)", a);
+		bench_mat4_inverse_accuracy(suite, group, "inverse (transforms)", in->t4[0]);
+	}
+
+	group = "trans4";
+	if (bench_is_enabled(suite, group))
+	{
+		const lib::Trans4 *a = in->t4[0], *b = in->t4[1];
+		const lib::Vec3 *p = in->v3[0];
+		bench_batch(suite, group, "mul trans4", [&](u32 i) { return a[i] * b[i]; });
+		bench_chain(suite, group, "mul trans4", a[0], [&](lib::Trans4 x) { return x * b[0]; });
+		bench_batch(suite, group, "mul mat4 (same data)", [&](u32 i) { return (lib::Mat4)a[i] * (lib::Mat4)b[i]; });
+		bench_batch(suite, group, "inverse", [&](u32 i) { return lib::inverse(a[i]); });
+		bench_chain(suite, group, "inverse", a[0], [](lib::Trans4 x) { return lib::inverse(x); });
+		bench_batch(suite, group, "inverse as mat4", [&](u32 i) { return lib::inverse((lib::Mat4)a[i]); });
+		bench_batch(suite, group, "normal_matrix", [&](u32 i) { return lib::normal_matrix(a[i]); });
+		bench_batch(suite, group, "transpose(inverse) as mat4", [&](u32 i) { return lib::transpose(lib::inverse((lib::Mat4)a[i])); });
+		bench_batch(suite, group, "mul_vec", [&](u32 i) { return lib::mul_vec(a[i], p[i]); });
+		bench_chain(suite, group, "mul_vec", p[0], [&](lib::Vec3 x) { return lib::mul_vec(a[0], x); });
+		bench_batch(suite, group, "mul_point", [&](u32 i) { return lib::mul_point(a[i], p[i]); });
+		bench_chain(suite, group, "mul_point", p[0], [&](lib::Vec3 x) { return lib::mul_point(a[0], x); });
+	}
+}
+
+//? Same ops as "vec3" and "trans4" groups over the same data in SoA streams, 8 elements per call, cycles per element
+internal void bench_wide(Bench_Suite *suite, const Bench_Inputs *in)
+{
+	const char *group = "vec3x8";
+	if (bench_is_enabled(suite, group))
+	{
+		auto a = [&](u32 i) { return lib::load_vec3x8(&in->v3_soa[0][0][i], &in->v3_soa[0][1][i], &in->v3_soa[0][2][i]); };
+		auto b = [&](u32 i) { return lib::load_vec3x8(&in->v3_soa[1][0][i], &in->v3_soa[1][1][i], &in->v3_soa[1][2][i]); };
+		lib::Vec3x8 n = lib::splat(lib::normalize(in->v3[1][0]));
+		bench_wide_batch(suite, group, "add", [&](u32 i) { return a(i) + b(i); });
+		bench_wide_batch(suite, group, "dot", [&](u32 i) { return lib::dot(a(i), b(i)); });
+		bench_wide_batch(suite, group, "length", [&](u32 i) { return lib::length_vec(a(i)); });
+		bench_wide_batch(suite, group, "normalize", [&](u32 i) { return lib::normalize(a(i)); });
+		bench_wide_batch(suite, group, "normalize_fast", [&](u32 i) { return lib::normalize_fast(a(i)); });
+		bench_wide_batch(suite, group, "cross", [&](u32 i) { return lib::cross(a(i), b(i)); });
+		bench_wide_batch(suite, group, "reflect", [&](u32 i) { return lib::reflect(a(i), n); });
+		bench_wide_batch(suite, group, "refract", [&](u32 i) { return lib::refract(a(i), n, 0.75f); });
+		bench_wide_batch(suite, group, "project", [&](u32 i) { return lib::project(a(i), b(i)); });
+		bench_wide_batch(suite, group, "lerp", [&](u32 i) { return lib::lerp(a(i), b(i), lib::splat(0.25f)); });
+	}
+
+	group = "trans4x8";
+	if (bench_is_enabled(suite, group))
+	{
+		auto p = [&](u32 i) { return lib::load_vec3x8(&in->v3_soa[0][0][i], &in->v3_soa[0][1][i], &in->v3_soa[0][2][i]); };
+		auto v = [&](u32 i)
+		{
+			return lib::load_vec4x8(&in->v4_soa[0][0][i], &in->v4_soa[0][1][i], &in->v4_soa[0][2][i], &in->v4_soa[0][3][i]);
+		};
+		lib::Trans4_Wide t = lib::broadcast(in->t4[0][0]);
+		lib::Mat4_Wide m = lib::broadcast(in->m4[0][0]);
+		bench_wide_batch(suite, group, "mul_vec", [&](u32 i) { return lib::mul_vec(t, p(i)); });
+		bench_wide_batch(suite, group, "mul_point", [&](u32 i) { return lib::mul_point(t, p(i)); });
+		bench_wide_batch(suite, group, "mat4 mul_point", [&](u32 i) { return lib::mul_point(m, p(i)); });
+		bench_wide_batch(suite, group, "mat4 mul vec4", [&](u32 i) { return m * v(i); });
+	}
+}
+
+//? Max error of 8-wide "op" against double precision "reference" over "count" evenly spaced x in [lo, hi].
+//? Relative error is against max(|reference|, "rel_floor"): 1 for functions with zeros inside the range (sin, cos, atan2),
+//? whose error is absolute there, tiny for the rest
+template <typename F, typename R>
+internal void bench_wide_accuracy(Bench_Suite *suite, const char *group, const char *name, f64 lo, f64 hi, f64 rel_floor,
+                                  const F &op, const R &reference)
+{
+	constexpr u32 count = 1 << 18;
+	alignas(32) f32 x[lib::WIDE_LANES], y[lib::WIDE_LANES];
+	f64 max_abs = 0.0, max_rel = 0.0;
+	for (u32 i = 0; i < count; i += lib::WIDE_LANES)
+	{
+		for (u32 k = 0; k < lib::WIDE_LANES; ++k)
+			x[k] = (f32)(lo + (hi - lo) * (i + k) / (count - 1));
+		_mm256_store_ps(y, op(_mm256_load_ps(x)));
+		for (u32 k = 0; k < lib::WIDE_LANES; ++k)
+		{
+			f64 expected = reference((f64)x[k]);
+			f64 error = fabs(y[k] - expected);
+			max_abs = lib::max(max_abs, error);
+			max_rel = lib::max(max_rel, error / lib::max(fabs(expected), rel_floor));
+		}
+	}
+	bench_accuracy(suite, group, name, max_abs, max_rel, count);
+}
+
+//? Transcendentals of "Math_Wide.hpp" in both precisions next to scalar libm over the same inputs, cycles per element.
+//? With "-ffast-math" GCC on glibc vectorizes some libm loops itself (libmvec "sinf", "log2f"), the others stay scalar.
+//? Inputs: angles in [-4pi, 4pi], positive x in [0.05, 1] (and y in [1, 5] for pow), points around the origin for atan2
+internal void bench_transcendental(Bench_Suite *suite, const Bench_Inputs *in)
+{
+	const char *group = "transcendental x8";
+	if (!bench_is_enabled(suite, group))
+		return;
+
+	alignas(32) static f32 angle[BENCH_BATCH], positive[BENCH_BATCH];
+	for (u32 i = 0; i < BENCH_BATCH; ++i)
+	{
+		angle[i] = 4.0f * PI32 * in->v3_soa[0][0][i];
+		positive[i] = 0.05f + 0.95f * lib::abs(in->v3_soa[0][1][i]);
+	}
+	const f32 *exponent = in->f, *px = in->v3_soa[1][0], *py = in->v3_soa[1][1];
+	auto a = [&](u32 i) { return _mm256_load_ps(angle + i); };
+	auto x = [&](u32 i) { return _mm256_load_ps(positive + i); };
+	auto e = [&](u32 i) { return _mm256_loadu_ps(exponent + i); };
+	constexpr lib::Precision fast = lib::Precision::Fast;
+
+	bench_wide_batch(suite, group, "sin", [&](u32 i) { return lib::sin(a(i)); });
+	bench_wide_batch(suite, group, "sin fast", [&](u32 i) { return lib::sin<fast>(a(i)); });
+	bench_batch(suite, group, "sinf (libm)", [&](u32 i) { return sinf(angle[i]); });
+	bench_wide_batch(suite, group, "cos", [&](u32 i) { return lib::cos(a(i)); });
+	bench_wide_batch(suite, group, "cos fast", [&](u32 i) { return lib::cos<fast>(a(i)); });
+	bench_wide_batch(suite, group, "sincos (sin + cos)", [&](u32 i)
+	{
+		__m256 s, c;
+		lib::sincos(a(i), &s, &c);
+		return _mm256_add_ps(s, c);
+	});
+	bench_wide_batch(suite, group, "exp2", [&](u32 i) { return lib::exp2(e(i)); });
+	bench_wide_batch(suite, group, "exp2 fast", [&](u32 i) { return lib::exp2<fast>(e(i)); });
+	bench_batch(suite, group, "exp2f (libm)", [&](u32 i) { return exp2f(exponent[i]); });
+	bench_wide_batch(suite, group, "log2", [&](u32 i) { return lib::log2(x(i)); });
+	bench_wide_batch(suite, group, "log2 fast", [&](u32 i) { return lib::log2<fast>(x(i)); });
+	bench_batch(suite, group, "log2f (libm)", [&](u32 i) { return log2f(positive[i]); });
+	bench_wide_batch(suite, group, "pow", [&](u32 i) { return lib::pow(x(i), e(i)); });
+	bench_wide_batch(suite, group, "pow fast", [&](u32 i) { return lib::pow<fast>(x(i), e(i)); });
+	bench_batch(suite, group, "powf (libm)", [&](u32 i) { return powf(positive[i], exponent[i]); });
+	bench_wide_batch(suite, group, "atan2", [&](u32 i) { return lib::atan2(_mm256_loadu_ps(py + i), _mm256_loadu_ps(px + i)); });
+	bench_wide_batch(suite, group, "atan2 fast", [&](u32 i) { return lib::atan2<fast>(_mm256_loadu_ps(py + i), _mm256_loadu_ps(px + i)); });
+	bench_batch(suite, group, "atan2f (libm)", [&](u32 i) { return atan2f(py[i], px[i]); });
+	bench_wide_batch(suite, group, "rsqrt", [&](u32 i) { return lib::rsqrt(x(i)); });
+	bench_wide_batch(suite, group, "rsqrt fast", [&](u32 i) { return lib::rsqrt<fast>(x(i)); });
+	bench_wide_batch(suite, group, "1 / sqrt", [&](u32 i) { return _mm256_div_ps(_mm256_set1_ps(1.0f), lib::sqrt(x(i))); });
+
+	// atan2 sweeps the angle of a unit vector, (x, y) are rounded to floats before both atan2 and the reference see them
+	auto atan2_of_angle = [](__m256 t, auto op)
+	{
+		alignas(32) f32 angles[lib::WIDE_LANES], ys[lib::WIDE_LANES], xs[lib::WIDE_LANES];
+		_mm256_store_ps(angles, t);
+		for (u32 k = 0; k < lib::WIDE_LANES; ++k)
+		{
+			ys[k] = (f32)sin((f64)angles[k]);
+			xs[k] = (f32)cos((f64)angles[k]);
+		}
+		return op(_mm256_load_ps(ys), _mm256_load_ps(xs));
+	};
+	auto atan2_reference = [](f64 t) { return atan2((f64)(f32)sin(t), (f64)(f32)cos(t)); };
+	bench_wide_accuracy(suite, group, "sin [-pi, pi]", -PI32, PI32, 1.0, [](__m256 t) { return lib::sin(t); }, [](f64 t) { return sin(t); });
+	bench_wide_accuracy(suite, group, "sin [-1e4, 1e4]", -1e4, 1e4, 1.0, [](__m256 t) { return lib::sin(t); }, [](f64 t) { return sin(t); });
+	bench_wide_accuracy(suite, group, "sin fast [-1e4, 1e4]", -1e4, 1e4, 1.0, [](__m256 t) { return lib::sin<fast>(t); }, [](f64 t) { return sin(t); });
+	bench_wide_accuracy(suite, group, "cos [-pi, pi]", -PI32, PI32, 1.0, [](__m256 t) { return lib::cos(t); }, [](f64 t) { return cos(t); });
+	bench_wide_accuracy(suite, group, "cos fast [-1e4, 1e4]", -1e4, 1e4, 1.0, [](__m256 t) { return lib::cos<fast>(t); }, [](f64 t) { return cos(t); });
+	bench_wide_accuracy(suite, group, "exp2 [-126, 127]", -126.0, 127.0, 1e-38, [](__m256 t) { return lib::exp2(t); }, [](f64 t) { return exp2(t); });
+	bench_wide_accuracy(suite, group, "exp2 fast [-126, 127]", -126.0, 127.0, 1e-38, [](__m256 t) { return lib::exp2<fast>(t); }, [](f64 t) { return exp2(t); });
+	bench_wide_accuracy(suite, group, "log2 [0.01, 4]", 0.01, 4.0, 1e-38, [](__m256 t) { return lib::log2(t); }, [](f64 t) { return log2(t); });
+	bench_wide_accuracy(suite, group, "log2 fast [0.01, 4]", 0.01, 4.0, 1e-38, [](__m256 t) { return lib::log2<fast>(t); }, [](f64 t) { return log2(t); });
+	bench_wide_accuracy(suite, group, "pow [0.1, 1], y = 32", 0.1, 1.0, 1e-38, [](__m256 t) { return lib::pow(t, _mm256_set1_ps(32.0f)); },
+	                    [](f64 t) { return pow(t, 32.0); });
+	bench_wide_accuracy(suite, group, "pow fast [0.1, 1], y = 32", 0.1, 1.0, 1e-38, [](__m256 t) { return lib::pow<fast>(t, _mm256_set1_ps(32.0f)); },
+	                    [](f64 t) { return pow(t, 32.0); });
+	bench_wide_accuracy(suite, group, "atan2 (unit circle)", -PI32, PI32, 1.0,
+	                    [&](__m256 t) { return atan2_of_angle(t, [](__m256 y, __m256 x) { return lib::atan2(y, x); }); }, atan2_reference);
+	bench_wide_accuracy(suite, group, "atan2 fast (unit circle)", -PI32, PI32, 1.0,
+	                    [&](__m256 t) { return atan2_of_angle(t, [](__m256 y, __m256 x) { return lib::atan2<fast>(y, x); }); }, atan2_reference);
+	bench_wide_accuracy(suite, group, "rsqrt [1e-3, 1e3]", 1e-3, 1e3, 1e-38, [](__m256 t) { return lib::rsqrt(t); }, [](f64 t) { return 1.0 / sqrt(t); });
+	bench_wide_accuracy(suite, group, "rsqrt fast [1e-3, 1e3]", 1e-3, 1e3, 1e-38, [](__m256 t) { return lib::rsqrt<fast>(t); }, [](f64 t) { return 1.0 / sqrt(t); });
+}
+
+//? Interpolation weights of "slerp" against sin(t*theta) / sin(theta) in doubles, over the bench quaternion pairs
+//? (shorter arc, all angles up to 180 degrees between the rotations) and interpolation factors
+internal void bench_slerp_accuracy(Bench_Suite *suite, const char *group, const lib::Quat *a, const lib::Quat *b, const f32 *t,
+                                   const lib::Quat *result, const char *name)
+{
+	f64 max_abs = 0.0, max_rel = 0.0;
+	for (u32 i = 0; i < BENCH_BATCH; ++i)
+	{
+		f64 cos_theta = (f64)a[i].x * b[i].x + (f64)a[i].y * b[i].y + (f64)a[i].z * b[i].z + (f64)a[i].w * b[i].w;
+		f64 sign = cos_theta < 0.0 ? -1.0 : 1.0;
+		f64 theta = acos(lib::min(fabs(cos_theta), 1.0));
+		f64 weight_a = theta < 1e-9 ? 1.0 - t[i] : sin((1.0 - t[i]) * theta) / sin(theta);
+		f64 weight_b = theta < 1e-9 ? t[i] : sin(t[i] * theta) / sin(theta);
+		for (u32 c = 0; c < 4; ++c)
+		{
+			f64 reference = weight_a * a[i].e[c] + sign * weight_b * b[i].e[c];
+			f64 error = fabs(result[i].e[c] - reference);
+			max_abs = lib::max(max_abs, error);
+			max_rel = lib::max(max_rel, error / lib::max(fabs(reference), 1e-3));
+		}
+	}
+	bench_accuracy(suite, group, name, max_abs, max_rel, BENCH_BATCH);
+}
+
+//? Scalar ops of "Quat" / "DualQuat" and batches of "Math_Wide.hpp" over the same pairs, cycles per quaternion.
+//? "slerp" is the acos/sin-free series, "slerp libm" the textbook version for comparison
+internal void bench_quat(Bench_Suite *suite, const Bench_Inputs *in)
+{
+	const lib::Quat *qa = in->q[0], *qb = in->q[1];
+	const f32 *t = in->unit;
+	const lib::Vec3 *p = in->v3[0];
+
+	const char *group = "quat";
+	if (bench_is_enabled(suite, group))
+	{
+		bench_batch(suite, group, "mul", [&](u32 i) { return qa[i] * qb[i]; });
+		bench_chain(suite, group, "mul", qa[0], [&](lib::Quat x) { return x * qb[0]; });
+		bench_batch(suite, group, "normalize", [&](u32 i) { return lib::normalize(qa[i]); });
+		bench_batch(suite, group, "rotate", [&](u32 i) { return lib::rotate(qa[i], p[i]); });
+		bench_chain(suite, group, "rotate", p[0], [&](lib::Vec3 x) { return lib::rotate(qa[0], x); });
+		bench_batch(suite, group, "nlerp", [&](u32 i) { return lib::nlerp(qa[i], qb[i], t[i]); });
+		bench_batch(suite, group, "slerp", [&](u32 i) { return lib::slerp(qa[i], qb[i], t[i]); });
+		bench_chain(suite, group, "slerp", qa[0], [&](lib::Quat x) { return lib::slerp(x, qb[0], 0.25f); });
+		bench_batch(suite, group, "slerp libm", [&](u32 i)
+		{
+			f32 cos_theta = lib::dot(qa[i], qb[i]);
+			lib::Quat end = cos_theta < 0.0f ? -qb[i] : qb[i];
+			f32 theta = acosf(lib::min(lib::abs(cos_theta), 1.0f));
+			f32 r_sin = 1.0f / sinf(theta);
+			return theta < 1e-4f ? lib::nlerp(qa[i], qb[i], t[i])
+			                     : (sinf((1.0f - t[i]) * theta) * r_sin) * qa[i] + (sinf(t[i] * theta) * r_sin) * end;
+		});
+		bench_batch(suite, group, "create_transform", [&](u32 i) { return lib::create_transform(qa[i]); });
+		bench_batch(suite, group, "get_rotation", [&](u32 i) { return lib::get_rotation(in->t4[0][i]); });
+
+		static lib::Quat slerped[BENCH_BATCH];
+		for (u32 i = 0; i < BENCH_BATCH; ++i)
+			slerped[i] = lib::slerp(qa[i], qb[i], t[i]);
+		bench_slerp_accuracy(suite, group, qa, qb, t, slerped, "slerp");
+	}
+
+	const lib::DualQuat *da = in->dq[0], *db = in->dq[1];
+	group = "dual quat";
+	if (bench_is_enabled(suite, group))
+	{
+		bench_batch(suite, group, "mul", [&](u32 i) { return da[i] * db[i]; });
+		bench_chain(suite, group, "mul", da[0], [&](lib::DualQuat x) { return x * db[0]; });
+		bench_batch(suite, group, "mul_point", [&](u32 i) { return lib::mul_point(da[i], p[i]); });
+		bench_chain(suite, group, "mul_point", p[0], [&](lib::Vec3 x) { return lib::mul_point(da[0], x); });
+		bench_batch(suite, group, "nlerp", [&](u32 i) { return lib::nlerp(da[i], db[i], t[i]); });
+		bench_batch(suite, group, "create_transform", [&](u32 i) { return lib::create_transform(da[i]); });
+		bench_batch(suite, group, "create_dual_quat(trans4)", [&](u32 i) { return lib::create_dual_quat(in->t4[0][i]); });
+	}
+
+	group = "quat batch";
+	if (bench_is_enabled(suite, group))
+	{
+		// Streams are not const in "Quat_Stream", so inputs are copied into their own memory: a, b, out (8 streams each) and t
+		f32 *memory = (f32 *)calloc(25 * BENCH_BATCH, sizeof(f32));
+		auto dual_stream = [&](u32 k)
+		{
+			f32 *s = memory + k * 8 * BENCH_BATCH;
+			return lib::DualQuat_Stream{ { s, s + BENCH_BATCH, s + 2 * BENCH_BATCH, s + 3 * BENCH_BATCH },
+			                             { s + 4 * BENCH_BATCH, s + 5 * BENCH_BATCH, s + 6 * BENCH_BATCH, s + 7 * BENCH_BATCH } };
+		};
+		lib::DualQuat_Stream a = dual_stream(0), b = dual_stream(1), out = dual_stream(2);
+		f32 *t_stream = memory + 24 * BENCH_BATCH;
+		for (u32 i = 0; i < BENCH_BATCH; ++i)
+		{
+			f32 *a_streams[8] = { a.real.x, a.real.y, a.real.z, a.real.w, a.dual.x, a.dual.y, a.dual.z, a.dual.w };
+			f32 *b_streams[8] = { b.real.x, b.real.y, b.real.z, b.real.w, b.dual.x, b.dual.y, b.dual.z, b.dual.w };
+			for (u32 c = 0; c < 4; ++c)
+			{
+				a_streams[c][i] = da[i].real.e[c];
+				a_streams[c + 4][i] = da[i].dual.e[c];
+				b_streams[c][i] = db[i].real.e[c];
+				b_streams[c + 4][i] = db[i].dual.e[c];
+			}
+			t_stream[i] = t[i];
+		}
+
+		auto measure = [&](const char *name, const auto &op)
+		{
+			bench_measure(suite, group, name, "batch", (u64)BENCH_BATCH * BENCH_BATCH_PASSES, [] {}, [&]
+			{
+				for (u32 pass = 0; pass < BENCH_BATCH_PASSES; ++pass)
+				{
+					op();
+					bench_escape(out.real.x);
+				}
+			});
+		};
+		alignas(64) static lib::Trans4 matrices[BENCH_BATCH];
+		measure("slerp", [&] { lib::slerp(a.real, b.real, t_stream, out.real, BENCH_BATCH); });
+		measure("slerp (one t)", [&] { lib::slerp(a.real, b.real, 0.25f, out.real, BENCH_BATCH); });
+		measure("nlerp", [&] { lib::nlerp(a.real, b.real, t_stream, out.real, BENCH_BATCH); });
+		measure("dual quat nlerp", [&] { lib::nlerp(a, b, t_stream, out, BENCH_BATCH); });
+		measure("dual quat mul", [&] { lib::mul(a, b, out, BENCH_BATCH); });
+		measure("create_transform", [&] { lib::create_transform(a.real, matrices, BENCH_BATCH); bench_escape(matrices); });
+		measure("dual create_transform", [&] { lib::create_transform(a, matrices, BENCH_BATCH); bench_escape(matrices); });
+
+		static lib::Quat slerped[BENCH_BATCH];
+		lib::slerp(a.real, b.real, t_stream, out.real, BENCH_BATCH);
+		for (u32 i = 0; i < BENCH_BATCH; ++i)
+			slerped[i] = lib::Quat{ out.real.x[i], out.real.y[i], out.real.z[i], out.real.w[i] };
+		bench_slerp_accuracy(suite, group, qa, qb, t, slerped, "slerp");
+
+		free(memory);
+	}
+}
+
+//? Batch entry points of "Vertex_Transform.hpp", cycles per vertex (Mops/s column is vertices per second on one core).
+//? Small batch is L1 resident, the big one streams from and to memory like a scene of millions of vertices does
+internal void bench_vertex_transform(Bench_Suite *suite, const Bench_Inputs *in)
+{
+	const char *group = "vertex transform";
+	if (!bench_is_enabled(suite, group))
+		return;
+
+	constexpr u32 big_count = 1 << 20;
+	u64 stream_bytes = (u64)big_count * sizeof(f32);
+	byte *memory = (byte *)calloc(stream_bytes * 7 + 64, 1);
+	f32 *streams = (f32 *)(AlignAddressPow2((u64)memory, 64));
+	Vertex_Stream3 big_in{ streams, streams + big_count, streams + 2 * big_count };
+	Vertex_Stream4 big_out{ streams + 3 * big_count, streams + 4 * big_count, streams + 5 * big_count, streams + 6 * big_count };
+	for (u32 i = 0; i < big_count; ++i)
+	{
+		const lib::Vec3 &p = in->v3[0][i % BENCH_BATCH];
+		big_in.x[i] = p.x;
+		big_in.y[i] = p.y;
+		big_in.z[i] = p.z + 3.0f;
+	}
+
+	// Perspective projection behind a model transform, points end up in front of the camera
+	lib::Mat4 mvp = lib::create_diagonal_matrix(1.0f);
+	mvp.e[2][3] = 1.0f;
+	mvp.e[3][3] = 0.0f;
+	mvp.e[3][2] = -0.1f;
+	mvp = mvp * (lib::Mat4)in->t4[0][0];
+	Viewport viewport{ 0.0f, 0.0f, 1920.0f, 1080.0f };
+
+	alignas(32) static f32 out[4][BENCH_BATCH];
+	Vertex_Stream3 soa_in{ (f32 *)in->v3_soa[0][0], (f32 *)in->v3_soa[0][1], (f32 *)in->v3_soa[0][2] };
+	Vertex_Stream4 small_out{ out[0], out[1], out[2], out[3] };
+	Vertex_Stream3 normals_out{ out[0], out[1], out[2] };
+	u64 op_count = (u64)BENCH_BATCH * BENCH_BATCH_PASSES;
+	bench_measure(suite, group, "scalar mat4 * vec4 + divide", "batch", op_count, [] {}, [&]
+	{
+		for (u32 pass = 0; pass < BENCH_BATCH_PASSES; ++pass)
+		{
+			for (u32 i = 0; i < BENCH_BATCH; ++i)
+			{
+				lib::Vec3 p = in->v3[0][i];
+				lib::Vec4 clip = mvp * lib::Vec4{ p.x, p.y, p.z, 1.0f };
+				f32 inv_w = 1.0f / clip.w;
+				out[0][i] = (clip.x * inv_w * 0.5f + 0.5f) * viewport.width;
+				out[1][i] = (0.5f - clip.y * inv_w * 0.5f) * viewport.height;
+				out[2][i] = clip.z * inv_w;
+				out[3][i] = inv_w;
+			}
+			bench_escape(out);
+		}
+	});
+	bench_measure(suite, group, "clip soa", "batch", op_count, [] {}, [&]
+	{
+		for (u32 pass = 0; pass < BENCH_BATCH_PASSES; ++pass)
+			vertex_transform_clip(mvp, soa_in, BENCH_BATCH, small_out);
+		bench_escape(out);
+	});
+	bench_measure(suite, group, "screen soa", "batch", op_count, [] {}, [&]
+	{
+		for (u32 pass = 0; pass < BENCH_BATCH_PASSES; ++pass)
+			vertex_transform_screen(mvp, viewport, soa_in, BENCH_BATCH, small_out);
+		bench_escape(out);
+	});
+	bench_measure(suite, group, "screen aos", "batch", op_count, [] {}, [&]
+	{
+		for (u32 pass = 0; pass < BENCH_BATCH_PASSES; ++pass)
+			vertex_transform_screen(mvp, viewport, in->v3[0], BENCH_BATCH, small_out);
+		bench_escape(out);
+	});
+	bench_measure(suite, group, "normals soa", "batch", op_count, [] {}, [&]
+	{
+		for (u32 pass = 0; pass < BENCH_BATCH_PASSES; ++pass)
+			vertex_transform_normals(in->t4[0][0], soa_in, BENCH_BATCH, normals_out);
+		bench_escape(out);
+	});
+	bench_measure(suite, group, "screen soa 1M (memory)", "stream", big_count, [] {}, [&]
+	{
+		vertex_transform_screen(mvp, viewport, big_in, big_count, big_out);
+		bench_escape(streams);
+	});
+
+	free(memory);
+}
+
+// ===============================================================================================================================
+// ======================================================= CULLING ===============================================================
+// ===============================================================================================================================
+//? Batched culling keeps exactly the bounds scalar "frustum_classify" does not reject, in increasing order
+template <typename Bound_At>
+internal b32 bench_cull_matches(const Frustum &frustum, u32 count, const u32 *visible, u32 visible_count, const Bound_At &bound_at)
+{
+	u32 expected = 0;
+	for (u32 i = 0; i < count; ++i)
+	{
+		if (frustum_classify(frustum, bound_at(i)) == Cull_Result::Outside)
+			continue;
+		if (expected >= visible_count || visible[expected] != i)
+			return false;
+		expected++;
+	}
+	return expected == visible_count;
+}
+
+//? City of randomly rotated boxes on a 1500 x 1500 ground, camera at the center sees roughly 12% of them
+internal void bench_culling(Bench_Suite *suite)
+{
+	const char *group = "culling";
+	if (!bench_is_enabled(suite, group))
+		return;
+
+	// D3D style perspective (fov 60, near 0.5, far 500) behind a camera looking along +z, slightly turned
+	f32 focal = 1.0f / tanf(PI32 / 6.0f);
+	f32 near_z = 0.5f;
+	f32 far_z = 500.0f;
+	lib::Mat4 projection{};
+	projection.e[0][0] = focal * 9.0f / 16.0f;
+	projection.e[1][1] = focal;
+	projection.e[2][2] = far_z / (far_z - near_z);
+	projection.e[3][2] = -near_z * far_z / (far_z - near_z);
+	projection.e[2][3] = 1.0f;
+	lib::Trans4 camera = lib::create_transform(lib::create_quat(lib::Vec3{ 0.0f, 1.0f, 0.0f }, 0.3f));
+	camera.e[3][1] = 20.0f;
+	Frustum frustum = frustum_from_matrix(projection * (lib::Mat4)lib::inverse(camera));
+
+	constexpr u32 big_count = 1 << 20;
+	u64 stream_bytes = (u64)big_count * sizeof(f32);
+	byte *memory = (byte *)calloc(stream_bytes * 16 + 64, 1);
+	f32 *streams = (f32 *)(AlignAddressPow2((u64)memory, 64));
+	Vertex_Stream3 center{ streams, streams + big_count, streams + 2 * big_count };
+	AABB_Stream aabbs{ center, { streams + 3 * big_count, streams + 4 * big_count, streams + 5 * big_count } };
+	Sphere_Stream spheres{ center, streams + 6 * big_count };
+	OBB_Stream obbs{ center, {} };
+	for (u32 axis = 0; axis < 3; ++axis)
+	{
+		f32 *base = streams + (7 + 3 * axis) * big_count;
+		obbs.axes[axis] = { base, base + big_count, base + 2 * big_count };
+	}
+
+	AABB *boxes = (AABB *)calloc(BENCH_BATCH, sizeof(AABB));
+	u32 state = 0xC0FFEE;
+	for (u32 i = 0; i < big_count; ++i)
+	{
+		lib::Vec3 c{ 750.0f * bench_random(&state), 20.0f * bench_random(&state), 750.0f * bench_random(&state) };
+		lib::Vec3 e{ 3.0f + 2.0f * bench_random(&state), 15.0f + 10.0f * bench_random(&state), 3.0f + 2.0f * bench_random(&state) };
+		lib::Trans4 model = lib::create_transform(lib::create_quat(lib::Vec3{ 0.0f, 1.0f, 0.0f }, PI32 * bench_random(&state)));
+		model.e[3][0] = c.x;
+		model.e[3][1] = c.y;
+		model.e[3][2] = c.z;
+		OBB obb = obb_from_aabb(model, AABB{ {}, e });
+		AABB aabb = aabb_transform(model, AABB{ {}, e });
+
+		center.x[i] = c.x;
+		center.y[i] = c.y;
+		center.z[i] = c.z;
+		aabbs.extent.x[i] = aabb.extent.x;
+		aabbs.extent.y[i] = aabb.extent.y;
+		aabbs.extent.z[i] = aabb.extent.z;
+		spheres.radius[i] = lib::length_vec(e);
+		for (u32 axis = 0; axis < 3; ++axis)
+		{
+			obbs.axes[axis].x[i] = obb.axes[axis].x;
+			obbs.axes[axis].y[i] = obb.axes[axis].y;
+			obbs.axes[axis].z[i] = obb.axes[axis].z;
+		}
+		if (i < BENCH_BATCH)
+			boxes[i] = aabb;
+	}
+
+	u32 *visible = (u32 *)calloc(cull_output_capacity(big_count), sizeof(u32));
+
+	// Whole scene and short ranges, none of the counts a multiple of 8 but the first two, so the masked tail is covered
+	auto sphere_at = [&](u32 i) { return Sphere{ { center.x[i], center.y[i], center.z[i] }, spheres.radius[i] }; };
+	auto aabb_at = [&](u32 i)
+	{
+		return AABB{ { center.x[i], center.y[i], center.z[i] }, { aabbs.extent.x[i], aabbs.extent.y[i], aabbs.extent.z[i] } };
+	};
+	auto obb_at = [&](u32 i)
+	{
+		OBB out{ { center.x[i], center.y[i], center.z[i] }, {} };
+		for (u32 axis = 0; axis < 3; ++axis)
+			out.axes[axis] = { obbs.axes[axis].x[i], obbs.axes[axis].y[i], obbs.axes[axis].z[i] };
+		return out;
+	};
+	constexpr u32 check_counts[] = { 8, 16, 1, 5, 13, 1021, big_count - 3 };
+	b32 sphere_matches = true, aabb_matches = true, obb_matches = true;
+	for (u32 count : check_counts)
+	{
+		sphere_matches &= bench_cull_matches(frustum, count, visible, frustum_cull(frustum, spheres, count, visible), sphere_at);
+		aabb_matches &= bench_cull_matches(frustum, count, visible, frustum_cull(frustum, aabbs, count, visible), aabb_at);
+		obb_matches &= bench_cull_matches(frustum, count, visible, frustum_cull(frustum, obbs, count, visible), obb_at);
+	}
+	bench_check(suite, group, "sphere x8", sphere_matches);
+	bench_check(suite, group, "aabb x8", aabb_matches);
+	bench_check(suite, group, "obb x8", obb_matches);
+
+	u64 op_count = (u64)BENCH_BATCH * BENCH_BATCH_PASSES;
+	bench_measure(suite, group, "scalar aabb", "batch", op_count, [] {}, [&]
+	{
+		for (u32 pass = 0; pass < BENCH_BATCH_PASSES; ++pass)
+		{
+			u32 visible_count = 0;
+			for (u32 i = 0; i < BENCH_BATCH; ++i)
+			{
+				if (frustum_classify(frustum, boxes[i]) != Cull_Result::Outside)
+					visible[visible_count++] = i;
+			}
+			bench_escape(visible);
+		}
+	});
+	bench_measure(suite, group, "sphere x8", "batch", op_count, [] {}, [&]
+	{
+		for (u32 pass = 0; pass < BENCH_BATCH_PASSES; ++pass)
+			frustum_cull(frustum, spheres, BENCH_BATCH, visible);
+		bench_escape(visible);
+	});
+	bench_measure(suite, group, "aabb x8", "batch", op_count, [] {}, [&]
+	{
+		for (u32 pass = 0; pass < BENCH_BATCH_PASSES; ++pass)
+			frustum_cull(frustum, aabbs, BENCH_BATCH, visible);
+		bench_escape(visible);
+	});
+	bench_measure(suite, group, "obb x8", "batch", op_count, [] {}, [&]
+	{
+		for (u32 pass = 0; pass < BENCH_BATCH_PASSES; ++pass)
+			frustum_cull(frustum, obbs, BENCH_BATCH, visible);
+		bench_escape(visible);
+	});
+	bench_measure(suite, group, "aabb x8 1M (memory)", "stream", big_count, [] {}, [&]
+	{
+		frustum_cull(frustum, aabbs, big_count, visible);
+		bench_escape(visible);
+	});
+	bench_measure(suite, group, "obb x8 1M (memory)", "stream", big_count, [] {}, [&]
+	{
+		frustum_cull(frustum, obbs, big_count, visible);
+		bench_escape(visible);
+	});
+
+	free(visible);
+	free(boxes);
+	free(memory);
+}
+
+// ===============================================================================================================================
+// ====================================================== ALLOCATORS =============================================================
+// ===============================================================================================================================
+internal void bench_allocators(Bench_Suite *suite)
+{
+	const char *group = "allocators";
+	if (!bench_is_enabled(suite, group))
+		return;
+
+	constexpr u32 op_count = 4096;
+	constexpr u64 block_size = 64;
+	u64 memory_size = MiB(4);
+	byte *memory = (byte *)calloc(memory_size * 3 + 64, 1);
+
+	Alloc_Arena arena{ .max_size = memory_size, .base = memory };
+	Alloc_Stack stack{ .max_size = memory_size, .base = memory + memory_size };
+	Alloc_Pool pool = create_pool(memory + memory_size * 2, memory_size, block_size, 64);
+	void *blocks[op_count];
+
+	auto arena_rewind = [&] { arena.curr_offset = 0; arena.prev_offset = 0; };
+	bench_measure(suite, group, "arena allocate 64B", "alloc", op_count, arena_rewind, [&]
+	{
+		for (u32 i = 0; i < op_count; ++i)
+			blocks[i] = allocate(&arena, block_size, 16);
+		bench_escape(blocks);
+	});
+	bench_measure(suite, group, "arena allocate 13B align 1..64", "alloc", op_count, arena_rewind, [&]
+	{
+		for (u32 i = 0; i < op_count; ++i)
+			blocks[i] = allocate(&arena, 13, 1ull << (i % 7));
+		bench_escape(blocks);
+	});
+	bench_measure(suite, group, "arena temp scope 64B", "alloc", op_count, arena_rewind, [&]
+	{
+		for (u32 i = 0; i < op_count; ++i)
+		{
+			arena_start_temp(&arena);
+			blocks[i] = allocate(&arena, block_size, 16);
+			arena_end_temp(&arena);
+		}
+		bench_escape(blocks);
+	});
+	// Reset is O(1) unless zeroing is asked for, "Zero" costs what was used since previous reset (all 4MiB here)
+	auto arena_fill = [&] { arena.curr_offset = memory_size; };
+	bench_measure(suite, group, "arena_reset", "alloc", 1, arena_fill, [&] { arena_reset(&arena); });
+	bench_measure(suite, group, "arena_reset Zero 4MiB", "alloc", 1, arena_fill, [&] { arena_reset(&arena, Arena_Reset::Zero); });
+
+	auto stack_rewind = [&] { stack.curr_offset = 0; stack.last_header_offset = 0; };
+	bench_measure(suite, group, "stack allocate 64B", "alloc", op_count, stack_rewind, [&]
+	{
+		for (u32 i = 0; i < op_count; ++i)
+			blocks[i] = allocate(&stack, block_size, 16);
+		bench_escape(blocks);
+	});
+	bench_measure(suite, group, "stack allocate + pop 64B", "alloc", op_count, stack_rewind, [&]
+	{
+		for (u32 i = 0; i < op_count; ++i)
+		{
+			blocks[i] = allocate(&stack, block_size, 16);
+			stack_pop(&stack);
+		}
+		bench_escape(blocks);
+	});
+	bench_measure(suite, group, "stack_reset 4MiB", "alloc", 1, [] {}, [&] { stack_reset(&stack); });
+
+	// Pool allocation zeroes the block, so it is measured together with the memset of "block_size"
+	auto pool_rewind = [&] { pool.head_block = pool.max_size / pool.block_size; reset_list(&pool); };
+	bench_measure(suite, group, "pool allocate 64B", "alloc", op_count, pool_rewind, [&]
+	{
+		for (u32 i = 0; i < op_count; ++i)
+			blocks[i] = allocate(&pool, block_size);
+		bench_escape(blocks);
+	});
+	bench_measure(suite, group, "pool allocate + free 64B", "alloc", op_count, pool_rewind, [&]
+	{
+		for (u32 i = 0; i < op_count; ++i)
+		{
+			blocks[i] = allocate(&pool, block_size);
+			free_block(&pool, blocks[i]);
+		}
+		bench_escape(blocks);
+	});
+	bench_measure(suite, group, "pool rebuild free list 4MiB", "alloc", 1, [] {}, pool_rewind);
+
+	free(memory);
+
+	// Reserved arena commits 2MiB chunks on its way up, first run includes every commit and page fault, later ones none
+	{
+		constexpr u64 reserved_size = MiB(64);
+		u32 reps = suite->reps;
+		suite->reps = 1;
+		Alloc_Arena reserved = arena_reserve(reserved_size);
+		bench_measure(suite, group, "reserved arena 4KiB (growing)", "alloc", reserved_size / KiB(4), [] {}, [&]
+		{
+			for (u64 i = 0; i < reserved_size / KiB(4); ++i)
+				*(u64 *)allocate(&reserved, KiB(4), 64) = i;
+		});
+		suite->reps = reps;
+		bench_measure(suite, group, "reserved arena 4KiB (committed)", "alloc", reserved_size / KiB(4), [&] { arena_reset(&reserved); }, [&]
+		{
+			for (u64 i = 0; i < reserved_size / KiB(4); ++i)
+				*(u64 *)allocate(&reserved, KiB(4), 64) = i;
+		});
+		// Parent takes the range of its sub-arena back on reset and allocates over pages the sub-arena never committed
+		bench_measure(suite, group, "reserved arena reset + reuse", "alloc", 1, [] {}, [&]
+		{
+			arena_reset(&reserved);
+			Alloc_Arena sub = arena_from_allocator(&reserved, MiB(16));
+			*(u64 *)allocate(&sub, KiB(4), 64) = 1;
+			arena_reset(&reserved);
+			byte *reused = (byte *)allocate(&reserved, MiB(8), 64);
+			reused[MiB(4)] = 1;
+			bench_escape(reused);
+		});
+		vm_pages_release(reserved.base, reserved.max_size);
+	}
+
+	// VM_Array grows by committing pages of its reservation, first run of the array includes every commit and page fault
+	constexpr u32 push_count = 1 << 18;
+	{
+		VM_Array<u32> array(MiB(64), 16);
+		bench_measure(suite, group, "VM_Array push u32 (committed)", "alloc", push_count, [&] { VMAllocGetHeader(array.origin)->size = 0; }, [&]
+		{
+			for (u32 i = 0; i < push_count; ++i)
+				array.push(i);
+			bench_escape(array.begin());
+		});
+	}
+	{
+		u32 reps = suite->reps;
+		suite->reps = 1;
+		VM_Array<u32> array(MiB(64), 16);
+		bench_measure(suite, group, "VM_Array push u32 (growing)", "alloc", push_count, [] {}, [&]
+		{
+			for (u32 i = 0; i < push_count; ++i)
+				array.push(i);
+			bench_escape(array.begin());
+		});
+		suite->reps = reps;
+	}
+}
+
+// ===============================================================================================================================
+// ========================================================= OUTPUT ==============================================================
+// ===============================================================================================================================
+internal b32 bench_write_json(const char *file_name, const Bench_Suite *suite)
+{
+	FILE *file = fopen(file_name, "wb");
+	if (!file)
+		return false;
+
+	fprintf(file, "{\n\t\"version\": 1,\n\t\"reps\": %u,\n\t\"tsc_ghz\": %.4f,\n\t\"results\": [", suite->reps, suite->tsc_per_ns);
+	for (u32 i = 0; i < suite->result_count; ++i)
+	{
+		const Bench_Result *r = &suite->results[i];
+		fprintf(file, "%s\n\t\t{\"group\": \"%s\", \"name\": \"%s\", \"mode\": \"%s\", \"op_count\": %llu, "
+		        "\"cycles_per_op\": %.4f, \"ns_per_op\": %.4f, \"mops_per_s\": %.3f}",
+		        i ? "," : "", r->group, r->name, r->mode, (unsigned long long)r->op_count,
+		        r->cycles_per_op, r->ns_per_op, 1000.0 / r->ns_per_op);
+	}
+	fprintf(file, "\n\t],\n\t\"accuracy\": [");
+	for (u32 i = 0; i < suite->accuracy_count; ++i)
+	{
+		const Bench_Accuracy *a = &suite->accuracies[i];
+		fprintf(file, "%s\n\t\t{\"group\": \"%s\", \"name\": \"%s\", \"max_abs_error\": %.6g, \"max_rel_error\": %.6g, \"samples\": %u}",
+		        i ? "," : "", a->group, a->name, a->max_abs_error, a->max_rel_error, a->sample_count);
+	}
+	fprintf(file, "\n\t]\n}\n");
+	return fclose(file) == 0;
+}
+
+internal void bench_print_usage(const char *exe)
+{
+	printf("usage: %s [-reps N] [-filter GROUP_SUBSTRING] [-json FILE]\n", exe);
+}
+
+int main(int argc, char **argv)
+{
+	Bench_Suite *suite = (Bench_Suite *)calloc(1, sizeof(Bench_Suite));
+	suite->reps = 15;
+	const char *json_file = "lib_bench.json";
+
+	for (s32 i = 1; i < argc; ++i)
+	{
+		const char *arg = argv[i];
+		const char *value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+		if (!strcmp(arg, "-reps") && value)
+			suite->reps = lib::max((u32)strtoul(value, nullptr, 10), 1u);
+		else if (!strcmp(arg, "-filter") && value)
+			suite->filter = value;
+		else if (!strcmp(arg, "-json") && value)
+			json_file = value;
+		else
+		{
+			bench_print_usage(argv[0]);
+			return !strcmp(arg, "-help") ? 0 : 1;
+		}
+		++i;
+	}
+
+	// Denormals would turn some chains into microcode assists, MSVC does not set this with /fp:fast
+	_mm_setcsr(_mm_getcsr() | 0x8040);
+
+	f64 ns_start = bench_now_ns();
+	u64 tsc_start = __rdtsc();
+	while (bench_now_ns() - ns_start < 20e6)
+		;
+	suite->tsc_per_ns = (f64)(__rdtsc() - tsc_start) / (bench_now_ns() - ns_start);
+
+	Bench_Inputs *inputs = (Bench_Inputs *)calloc(1, sizeof(Bench_Inputs));
+	bench_fill_inputs(inputs);
+
+	bench_scalar(suite, inputs);
+	bench_vec2(suite, inputs);
+	bench_vec3(suite, inputs);
+	bench_vec4(suite, inputs);
+	bench_mat4(suite, inputs);
+	bench_wide(suite, inputs);
+	bench_quat(suite, inputs);
+	bench_transcendental(suite, inputs);
+	bench_vertex_transform(suite, inputs);
+	bench_culling(suite);
+	bench_allocators(suite);
+
+	printf("TSC %.3f GHz, best of %u runs\n", suite->tsc_per_ns, suite->reps);
+	printf("%-20s %-32s %-6s %12s %10s %10s\n", "group", "name", "mode", "cycles/op", "ns/op", "Mops/s");
+	for (u32 i = 0; i < suite->result_count; ++i)
+	{
+		const Bench_Result *r = &suite->results[i];
+		printf("%-20s %-32s %-6s %12.2f %10.3f %10.1f\n", r->group, r->name, r->mode, r->cycles_per_op, r->ns_per_op, 1000.0 / r->ns_per_op);
+	}
+	if (suite->accuracy_count)
+	{
+		printf("\n%-20s %-32s %12s %12s %8s\n", "group", "name", "max abs err", "max rel err", "samples");
+		for (u32 i = 0; i < suite->accuracy_count; ++i)
+		{
+			const Bench_Accuracy *a = &suite->accuracies[i];
+			printf("%-20s %-32s %12.3g %12.3g %8u\n", a->group, a->name, a->max_abs_error, a->max_rel_error, a->sample_count);
+		}
+	}
+
+	int exit_code = 0;
+	if (suite->failed_checks)
+	{
+		fprintf(stderr, "%u optimized paths differ from their reference\n", suite->failed_checks);
+		exit_code = 1;
+	}
+	if (json_file)
+	{
+		if (bench_write_json(json_file, suite))
+			printf("results written to \"%s\"\n", json_file);
+		else
+		{
+			fprintf(stderr, "Could not write \"%s\"\n", json_file);
+			exit_code = 1;
+		}
+	}
+
+	free(inputs);
+	free(suite);
+	return exit_code;
+}
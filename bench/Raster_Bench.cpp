@@ -0,0 +1,877 @@
+//? Headless rasterizer throughput benchmark, separate executable from the platform layers.
+//? Renders a fixed set of canonical scenes at several resolutions and worker counts straight through "raster_render"
+//? (no frame ring, no present, no pacing) and reports throughput, scaling efficiency and frame time variance.
+//? Results are printed as a table and written as JSON, so runs of different versions can be diffed by scripts.
+//? Every configuration creates its own job system, so scaling is measured with exactly N workers
+
+// Standard headers go first, "internal" macro of Utils.hpp collides with identifiers inside of them
+#include <chrono>
+#include <thread>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Utils.hpp"
+#include "Allocators.hpp"
+#include "VM_Pages.hpp"
+#include "Job_System.hpp"
+#include "Cpu_Features.hpp"
+#include "../source/Raster.hpp"
+
+constexpr u32 BENCH_MAX_RESOLUTIONS = 8;
+constexpr u32 BENCH_MAX_THREAD_COUNTS = 16;
+constexpr u32 BENCH_MAX_FRAMES = 1024;
+constexpr u32 BENCH_MAX_RESULTS = 1024;
+constexpr u32 BENCH_OVERDRAW_LAYERS = 16;
+constexpr u32 BENCH_HUGE_TRIANGLES = 8;
+constexpr u32 BENCH_RANDOM_TRIANGLES = 2000;
+constexpr f32 BENCH_TINY_CELL = 4.0f;  // pixels, two triangles per cell
+constexpr f32 BENCH_MESH_CELL = 24.0f; // pixels, two triangles per cell
+constexpr u32 BENCH_GROUND_CELLS = 128; // per side, two triangles per cell
+constexpr u32 BENCH_SPHERES_X = 4;
+constexpr u32 BENCH_SPHERES_Y = 3;
+constexpr u32 BENCH_SPHERE_RINGS = 48; // segments around are twice that, two triangles per segment
+constexpr u32 BENCH_SPHERE_TRIANGLES = 2 * BENCH_SPHERE_RINGS * 2 * BENCH_SPHERE_RINGS;
+constexpr u32 BENCH_VALIDATE_SEEDS = 8; // shared-edge meshes of every cell size and resolution
+
+enum class Bench_Scene : u32
+{
+	Clear,          // no triangles, tile clear and resolve only
+	Tiny_Triangles, // ~2 pixel triangles over whole target, front-end and binning bound
+	Huge_Triangles, // few triangles each covering most of the target, back-end bound
+	Overdraw,       // fullscreen layers drawn back to front, every layer passes depth test
+	Mesh,           // closed shared-edge mesh, vertex-colored only (rasterizer has no texturing, nothing is sampled)
+	Random_Depth,   // overlapping random triangles with random depth per vertex, interpenetrating, depth test decides
+	Ground,         // perspective floor in clip space crossing near and far planes and the guard band, clipped every frame
+	Spheres,        // dense closed meshes with back-face culling, half of triangles face away, most are a few pixels
+	Count,
+};
+
+global_variable const char *g_scene_names[] = { "clear", "tiny_triangles", "huge_triangles", "overdraw", "mesh", "random_depth", "ground", "spheres" };
+static_assert(array_count_32(g_scene_names) == (u32)Bench_Scene::Count);
+
+struct Bench_Resolution
+{
+	u32 width;
+	u32 height;
+};
+
+struct Bench_Options
+{
+	Bench_Resolution resolutions[BENCH_MAX_RESOLUTIONS];
+	u32 resolution_count;
+	u32 thread_counts[BENCH_MAX_THREAD_COUNTS];
+	u32 thread_count_count;
+	u32 frames;        // measured frames of every configuration
+	u32 warmup_frames; // rendered before measuring, first frame touches all memory
+	const char *scene; // nullptr runs all scenes
+	const char *json_file;
+	b32 is_linear;
+	b32 is_validating; // checks coverage of shared-edge meshes instead of measuring
+	b32 is_comparing;  // every configuration is measured with the scalar reference kernel as well and must match it
+	Raster_Kernel kernel;
+	Cpu_Isa max_isa;   // caps raster kernels, so narrower ones can be measured on a wide machine
+};
+
+struct Bench_Result
+{
+	Bench_Scene scene;
+	Bench_Resolution resolution;
+	u32 threads;
+	u32 triangles;
+	u32 frames;
+
+	f64 min_ms;
+	f64 mean_ms;
+	f64 median_ms;
+	f64 max_ms;
+	f64 stddev_ms;
+
+	f64 mpixels_per_s;    // target pixels per second at median frame time
+	f64 mtriangles_per_s; // submitted triangles per second at median frame time
+	f64 speedup;          // single worker median / this median, 0 when single worker was not measured
+	f64 efficiency;       // speedup / threads
+
+	Raster_Stats stats;           // of the last frame
+	Raster_Clip_Stats clip_stats; // of the last frame, clip space scenes only
+
+	// "-compare" only
+	f64 scalar_median_ms;
+	u64 diff_pixels;       // of the last frame, scalar reference against measured kernel
+	u32 max_channel_delta;
+};
+
+// ===============================================================================================================================
+// ========================================================= SCENES ==============================================================
+// ===============================================================================================================================
+internal lib::Vec3 bench_palette(u32 i)
+{
+	f32 t = (f32)i * 0.618034f;
+	return { 0.5f + 0.5f * cosf(6.2831f * t), 0.5f + 0.5f * cosf(6.2831f * (t + 0.33f)), 0.5f + 0.5f * cosf(6.2831f * (t + 0.67f)) };
+}
+
+internal u32 bench_scene_max_triangles(Bench_Scene scene, u32 width, u32 height)
+{
+	switch (scene)
+	{
+		case Bench_Scene::Clear:
+			return 0;
+		case Bench_Scene::Tiny_Triangles:
+			return 2 * (u32)(lib::ceil((f32)width / BENCH_TINY_CELL) * lib::ceil((f32)height / BENCH_TINY_CELL));
+		case Bench_Scene::Huge_Triangles:
+			return BENCH_HUGE_TRIANGLES;
+		case Bench_Scene::Overdraw:
+			return 2 * BENCH_OVERDRAW_LAYERS;
+		case Bench_Scene::Random_Depth:
+			return BENCH_RANDOM_TRIANGLES;
+		case Bench_Scene::Mesh:
+			return 2 * ((u32)lib::ceil((f32)width / BENCH_MESH_CELL) + 2) * ((u32)lib::ceil((f32)height / BENCH_MESH_CELL) + 2);
+		case Bench_Scene::Ground:
+			return 2 * BENCH_GROUND_CELLS * BENCH_GROUND_CELLS * RASTER_CLIP_MAX_TRIANGLES;
+		case Bench_Scene::Spheres:
+			return BENCH_SPHERES_X * BENCH_SPHERES_Y * BENCH_SPHERE_TRIANGLES * RASTER_CLIP_MAX_TRIANGLES;
+		default:
+			return 0;
+	}
+}
+
+//? Scenes are static and deterministic, built once per resolution
+internal u32 bench_scene_build(Bench_Scene scene, Raster_Triangle *out, u32 width, u32 height)
+{
+	f32 w = (f32)width;
+	f32 h = (f32)height;
+	u32 count = 0;
+
+	switch (scene)
+	{
+		case Bench_Scene::Clear:
+			break;
+
+		case Bench_Scene::Tiny_Triangles:
+		{
+			u32 cells_x = (u32)lib::ceil(w / BENCH_TINY_CELL);
+			u32 cells_y = (u32)lib::ceil(h / BENCH_TINY_CELL);
+			for (u32 y = 0; y < cells_y; ++y)
+			{
+				for (u32 x = 0; x < cells_x; ++x)
+				{
+					f32 x0 = (f32)x * BENCH_TINY_CELL + 0.3f, y0 = (f32)y * BENCH_TINY_CELL + 0.3f;
+					f32 z = 0.1f + 0.8f * (f32)((x * 7 + y * 13) % 32) / 32.0f;
+					lib::Vec3 color = bench_palette(x * 3 + y * 5);
+					// Two slivers inside of the cell, neither shares an edge with the other
+					out[count++] = { { { { x0, y0, z }, color }, { { x0 + 2.0f, y0, z }, color }, { { x0, y0 + 2.0f, z }, color } } };
+					out[count++] = { { { { x0 + 3.4f, y0 + 1.4f, z }, color }, { { x0 + 3.4f, y0 + 3.4f, z }, color }, { { x0 + 1.4f, y0 + 3.4f, z }, color } } };
+				}
+			}
+			break;
+		}
+
+		case Bench_Scene::Huge_Triangles:
+		{
+			for (u32 i = 0; i < BENCH_HUGE_TRIANGLES; ++i)
+			{
+				// Alternating near and far, so both depth-accepted and HiZ-rejected paths are hit
+				f32 z = (i % 2) ? 0.2f + 0.05f * (f32)i : 0.8f - 0.05f * (f32)i;
+				f32 a = (f32)i * (2.0f * PI32 / (f32)BENCH_HUGE_TRIANGLES);
+				lib::Vec2 center = { 0.5f * w, 0.5f * h };
+				f32 radius = 1.2f * lib::max(w, h);
+				Raster_Triangle *tri = &out[count++];
+				for (u32 v = 0; v < 3; ++v)
+				{
+					f32 angle = a + (f32)v * (2.0f * PI32 / 3.0f);
+					tri->v[v].position = { center.x + radius * cosf(angle), center.y + radius * sinf(angle), z };
+					tri->v[v].color = bench_palette(i * 3 + v);
+				}
+			}
+			break;
+		}
+
+		case Bench_Scene::Overdraw:
+		{
+			for (u32 layer = 0; layer < BENCH_OVERDRAW_LAYERS; ++layer)
+			{
+				f32 z = 0.95f - 0.9f * (f32)layer / (f32)BENCH_OVERDRAW_LAYERS;
+				Raster_Vertex v00 = { { 0.0f, 0.0f, z }, bench_palette(layer * 4 + 0) };
+				Raster_Vertex v10 = { { w, 0.0f, z }, bench_palette(layer * 4 + 1) };
+				Raster_Vertex v01 = { { 0.0f, h, z }, bench_palette(layer * 4 + 2) };
+				Raster_Vertex v11 = { { w, h, z }, bench_palette(layer * 4 + 3) };
+				out[count++] = { v00, v10, v11 };
+				out[count++] = { v00, v11, v01 };
+			}
+			break;
+		}
+
+		case Bench_Scene::Mesh:
+		{
+			u32 cells_x = (u32)lib::ceil(w / BENCH_MESH_CELL) + 2;
+			u32 cells_y = (u32)lib::ceil(h / BENCH_MESH_CELL) + 2;
+			count = raster_build_shared_edge_mesh(out, cells_x, cells_y, w, h, 0x1234567u);
+			for (u32 i = 0; i < count; ++i)
+			{
+				for (u32 v = 0; v < 3; ++v)
+				{
+					lib::Vec3 p = out[i].v[v].position;
+					out[i].v[v].position.z = 0.3f + 0.2f * sinf(p.x * 0.01f) * cosf(p.y * 0.013f);
+					out[i].v[v].color = { p.x / w, p.y / h, 0.5f + 0.5f * sinf((p.x + p.y) * 0.02f) };
+				}
+			}
+			break;
+		}
+
+		case Bench_Scene::Random_Depth:
+		{
+			u32 seed = 0x9E3779B9u;
+			auto next_random = [&seed]()
+			{
+				seed ^= seed << 13;
+				seed ^= seed >> 17;
+				seed ^= seed << 5;
+				return (f32)(seed & 0xFFFFFF) / (f32)0xFFFFFF;
+			};
+			f32 size = 0.3f * lib::min(w, h);
+			for (u32 i = 0; i < BENCH_RANDOM_TRIANGLES; ++i)
+			{
+				lib::Vec2 center = { next_random() * w, next_random() * h };
+				Raster_Triangle *tri = &out[count++];
+				for (u32 v = 0; v < 3; ++v)
+				{
+					tri->v[v].position = { center.x + (next_random() - 0.5f) * size, center.y + (next_random() - 0.5f) * size, 0.05f + 0.9f * next_random() };
+					tri->v[v].color = bench_palette(i * 3 + v);
+				}
+			}
+			break;
+		}
+
+		default:
+			break;
+	}
+	return count;
+}
+
+//? Clip space scenes go through "raster_clip_triangles" every frame, "raster_render" gets only what it returns
+internal b32 bench_scene_is_clipped(Bench_Scene scene)
+{
+	return scene == Bench_Scene::Ground || scene == Bench_Scene::Spheres;
+}
+
+internal u32 bench_scene_max_clip_triangles(Bench_Scene scene)
+{
+	switch (scene)
+	{
+		case Bench_Scene::Ground:
+			return 2 * BENCH_GROUND_CELLS * BENCH_GROUND_CELLS;
+		case Bench_Scene::Spheres:
+			return BENCH_SPHERES_X * BENCH_SPHERES_Y * BENCH_SPHERE_TRIANGLES;
+		default:
+			return 0;
+	}
+}
+
+internal Raster_Cull_Mode bench_scene_cull_mode(Bench_Scene scene)
+{
+	return scene == Bench_Scene::Spheres ? Raster_Cull_Mode::Back : Raster_Cull_Mode::None;
+}
+
+//? D3D style perspective, fov 60
+internal lib::Mat4 bench_perspective(u32 width, u32 height, f32 near_z, f32 far_z)
+{
+	f32 focal = 1.0f / tanf(PI32 / 6.0f);
+	lib::Mat4 out{};
+	out.e[0][0] = focal * (f32)height / (f32)width;
+	out.e[1][1] = focal;
+	out.e[2][2] = far_z / (far_z - near_z);
+	out.e[3][2] = -near_z * far_z / (far_z - near_z);
+	out.e[2][3] = 1.0f;
+	return out;
+}
+
+//? Ground: camera 1.5 above a 600 x 600 floor, pitched down and turned, with far plane at 300: cells under the camera cross
+//? the near plane and reach past the guard band, far ones cross the far plane, most of the floor is outside of the frustum.
+//? Spheres: grid of them in front of the camera, vertices are shared by neighbouring triangles like in an indexed mesh
+internal u32 bench_scene_build_clip(Bench_Scene scene, Raster_Clip_Triangle *out, u32 width, u32 height)
+{
+	if (scene == Bench_Scene::Spheres)
+	{
+		lib::Mat4 projection = bench_perspective(width, height, 0.5f, 100.0f);
+		constexpr u32 segments = 2 * BENCH_SPHERE_RINGS;
+		u32 count = 0;
+		for (u32 sphere_y = 0; sphere_y < BENCH_SPHERES_Y; ++sphere_y)
+		{
+			for (u32 sphere_x = 0; sphere_x < BENCH_SPHERES_X; ++sphere_x)
+			{
+				lib::Vec3 center = { ((f32)sphere_x - 0.5f * (BENCH_SPHERES_X - 1)) * 3.2f, ((f32)sphere_y - 0.5f * (BENCH_SPHERES_Y - 1)) * 3.2f, 12.0f };
+				u32 sphere = sphere_y * BENCH_SPHERES_X + sphere_x;
+				auto vertex = [&](u32 segment, u32 ring)
+				{
+					f32 theta = PI32 * (f32)ring / BENCH_SPHERE_RINGS;
+					f32 phi = 2.0f * PI32 * (f32)segment / segments;
+					lib::Vec3 normal = { sinf(theta) * cosf(phi), cosf(theta), sinf(theta) * sinf(phi) };
+					lib::Vec3 p = center + 1.4f * normal;
+					lib::Vec3 color = 0.5f * normal + lib::Vec3{ 0.5f, 0.5f, 0.5f };
+					return Raster_Clip_Vertex{ projection * lib::Vec4{ p.x, p.y, p.z, 1.0f }, 0.6f * color + 0.4f * bench_palette(sphere) };
+				};
+
+				for (u32 ring = 0; ring < BENCH_SPHERE_RINGS; ++ring)
+				{
+					for (u32 segment = 0; segment < segments; ++segment)
+					{
+						Raster_Clip_Vertex v00 = vertex(segment, ring), v10 = vertex(segment + 1, ring);
+						Raster_Clip_Vertex v01 = vertex(segment, ring + 1), v11 = vertex(segment + 1, ring + 1);
+						out[count++] = { v00, v10, v11 };
+						out[count++] = { v00, v11, v01 };
+					}
+				}
+			}
+		}
+		return count;
+	}
+
+	if (scene != Bench_Scene::Ground)
+		return 0;
+
+	lib::Mat4 projection = bench_perspective(width, height, 0.5f, 300.0f);
+	lib::Trans4 camera = lib::create_transform(lib::create_quat(lib::Vec3{ 0.0f, 1.0f, 0.0f }, 0.2f)
+	                                           * lib::create_quat(lib::Vec3{ 1.0f, 0.0f, 0.0f }, 0.5f));
+	camera.e[3][1] = 1.5f;
+	lib::Mat4 view_projection = projection * (lib::Mat4)lib::inverse(camera);
+
+	constexpr f32 cell = 600.0f / BENCH_GROUND_CELLS;
+	auto vertex = [&](u32 x, u32 z)
+	{
+		lib::Vec4 p = { (f32)x * cell - 300.0f, 0.0f, (f32)z * cell - 100.0f, 1.0f };
+		return Raster_Clip_Vertex{ view_projection * p, bench_palette(x * 7 + z * 3) };
+	};
+
+	u32 count = 0;
+	for (u32 z = 0; z < BENCH_GROUND_CELLS; ++z)
+	{
+		for (u32 x = 0; x < BENCH_GROUND_CELLS; ++x)
+		{
+			Raster_Clip_Vertex v00 = vertex(x, z), v10 = vertex(x + 1, z), v01 = vertex(x, z + 1), v11 = vertex(x + 1, z + 1);
+			out[count++] = { v00, v10, v11 };
+			out[count++] = { v00, v11, v01 };
+		}
+	}
+	return count;
+}
+
+// ===============================================================================================================================
+// ====================================================== COMMAND LINE ===========================================================
+// ===============================================================================================================================
+internal void bench_print_usage(const char *exe)
+{
+	printf("usage: %s [-res WxH[,WxH...]] [-threads N[,N...]] [-frames N] [-warmup N] [-scene NAME] [-json FILE] [-linear]\n"
+	       "       [-isa sse42|avx2|avx512] [-kernel wide|scalar] [-compare] [-validate]\n", exe);
+	printf("scenes:");
+	for (const char *name : g_scene_names)
+		printf(" %s", name);
+	printf("\n");
+}
+
+internal Bench_Options bench_parse_options(int argc, char **argv)
+{
+	Bench_Options out
+	{
+		.resolutions = { { 1280, 720 }, { 1920, 1080 }, { 3840, 2160 } },
+		.resolution_count = 3,
+		.frames = 20,
+		.warmup_frames = 3,
+		.scene = nullptr,
+		.json_file = "raster_bench.json",
+		.is_linear = false,
+		.kernel = Raster_Kernel::Wide,
+		.max_isa = Cpu_Isa::AVX512,
+	};
+
+	// Powers of 2 up to all cores, plus all cores when that is not a power of 2
+	u32 cores_count = lib::max(std::thread::hardware_concurrency(), 1u);
+	for (u32 threads = 1; threads < cores_count && out.thread_count_count < BENCH_MAX_THREAD_COUNTS - 1; threads *= 2)
+		out.thread_counts[out.thread_count_count++] = threads;
+	out.thread_counts[out.thread_count_count++] = cores_count;
+
+	for (s32 i = 1; i < argc; ++i)
+	{
+		const char *arg = argv[i];
+		const char *value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+		b32 has_value = true;
+
+		if (!strcmp(arg, "-res") && value)
+		{
+			out.resolution_count = 0;
+			for (const char *at = value; *at && out.resolution_count < BENCH_MAX_RESOLUTIONS;)
+			{
+				char *end = nullptr;
+				Bench_Resolution *res = &out.resolutions[out.resolution_count++];
+				res->width = (u32)strtoul(at, &end, 10);
+				res->height = (*end == 'x') ? (u32)strtoul(end + 1, &end, 10) : 0;
+				at = (*end == ',') ? end + 1 : end;
+				if (!res->width || !res->height)
+				{
+					fprintf(stderr, "Invalid resolution list \"%s\"\n", value);
+					exit(1);
+				}
+			}
+		}
+		else if (!strcmp(arg, "-threads") && value)
+		{
+			out.thread_count_count = 0;
+			for (const char *at = value; *at && out.thread_count_count < BENCH_MAX_THREAD_COUNTS;)
+			{
+				char *end = nullptr;
+				u32 threads = (u32)strtoul(at, &end, 10);
+				if (!threads || threads > JOB_MAX_WORKERS)
+				{
+					fprintf(stderr, "Invalid thread count list \"%s\"\n", value);
+					exit(1);
+				}
+				out.thread_counts[out.thread_count_count++] = threads;
+				at = (*end == ',') ? end + 1 : end;
+			}
+		}
+		else if (!strcmp(arg, "-frames") && value)
+			out.frames = lib::clamp((u32)strtoul(value, nullptr, 10), 1u, BENCH_MAX_FRAMES);
+		else if (!strcmp(arg, "-warmup") && value)
+			out.warmup_frames = (u32)strtoul(value, nullptr, 10);
+		else if (!strcmp(arg, "-scene") && value)
+			out.scene = value;
+		else if (!strcmp(arg, "-json") && value)
+			out.json_file = value;
+		else if (!strcmp(arg, "-isa") && value)
+		{
+			if (!cpu_isa_parse(value, &out.max_isa))
+			{
+				fprintf(stderr, "Unknown ISA \"%s\"\n", value);
+				exit(1);
+			}
+		}
+		else if (!strcmp(arg, "-linear"))
+		{
+			out.is_linear = true;
+			has_value = false;
+		}
+		else if (!strcmp(arg, "-kernel") && value)
+		{
+			if (!strcmp(value, "wide"))
+				out.kernel = Raster_Kernel::Wide;
+			else if (!strcmp(value, "scalar"))
+				out.kernel = Raster_Kernel::Scalar;
+			else
+			{
+				fprintf(stderr, "Unknown kernel \"%s\"\n", value);
+				exit(1);
+			}
+		}
+		else if (!strcmp(arg, "-compare"))
+		{
+			out.is_comparing = true;
+			has_value = false;
+		}
+		else if (!strcmp(arg, "-validate"))
+		{
+			out.is_validating = true;
+			has_value = false;
+		}
+		else
+		{
+			has_value = false;
+			bench_print_usage(argv[0]);
+			exit(!strcmp(arg, "-help") ? 0 : 1);
+		}
+
+		if (has_value)
+			++i;
+	}
+	return out;
+}
+
+// ===============================================================================================================================
+// ======================================================== MEASURING ============================================================
+// ===============================================================================================================================
+internal f64 bench_now_ms()
+{
+	return std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//? Fills timing fields of "result" from raw frame times, sorts "frame_ms" in place
+internal void bench_summarize(Bench_Result *result, f64 *frame_ms, u32 frame_count)
+{
+	for (u32 i = 1; i < frame_count; ++i)
+	{
+		f64 value = frame_ms[i];
+		u32 j = i;
+		for (; j > 0 && frame_ms[j - 1] > value; --j)
+			frame_ms[j] = frame_ms[j - 1];
+		frame_ms[j] = value;
+	}
+
+	f64 sum = 0.0;
+	for (u32 i = 0; i < frame_count; ++i)
+		sum += frame_ms[i];
+	f64 mean = sum / frame_count;
+	f64 variance = 0.0;
+	for (u32 i = 0; i < frame_count; ++i)
+		variance += (frame_ms[i] - mean) * (frame_ms[i] - mean);
+	variance /= lib::max(frame_count, 2u) - 1;
+
+	result->frames = frame_count;
+	result->min_ms = frame_ms[0];
+	result->max_ms = frame_ms[frame_count - 1];
+	result->mean_ms = mean;
+	result->median_ms = (frame_count % 2) ? frame_ms[frame_count / 2] : 0.5 * (frame_ms[frame_count / 2 - 1] + frame_ms[frame_count / 2]);
+	result->stddev_ms = (f64)lib::sqrt((f32)variance);
+
+	f64 seconds = result->median_ms / 1000.0;
+	result->mpixels_per_s = (f64)result->resolution.width * result->resolution.height / seconds / 1e6;
+	result->mtriangles_per_s = (f64)result->triangles / seconds / 1e6;
+}
+
+internal b32 bench_write_json(const char *file_name, const Bench_Options *options, const Bench_Result *results, u32 result_count)
+{
+	FILE *file = fopen(file_name, "wb");
+	if (!file)
+		return false;
+
+	fprintf(file, "{\n\t\"version\": 1,\n\t\"layout\": \"%s\",\n\t\"frames\": %u,\n\t\"warmup_frames\": %u,\n\t\"hardware_threads\": %u,\n\t\"isa\": \"%s\",\n\t\"kernel\": \"%s\",\n\t\"cpu\": \"%s\",\n\t\"results\": [",
+	        options->is_linear ? "linear" : "tiled", options->frames, options->warmup_frames, std::thread::hardware_concurrency(),
+	        cpu_isa_name(g_cpu.isa), options->kernel == Raster_Kernel::Wide ? "wide" : "scalar", g_cpu.brand);
+	for (u32 i = 0; i < result_count; ++i)
+	{
+		const Bench_Result *r = &results[i];
+		fprintf(file, "%s\n\t\t{\"scene\": \"%s\", \"width\": %u, \"height\": %u, \"threads\": %u, \"triangles\": %u, \"frames\": %u, "
+		        "\"min_ms\": %.4f, \"mean_ms\": %.4f, \"median_ms\": %.4f, \"max_ms\": %.4f, \"stddev_ms\": %.4f, "
+		        "\"mpixels_per_s\": %.3f, \"mtriangles_per_s\": %.3f, \"speedup\": %.3f, \"efficiency\": %.3f, "
+		        "\"triangles_binned\": %llu, \"bin_entries\": %llu, \"blocks_rasterized\": %llu, \"blocks_hiz_rejected\": %llu, "
+		        "\"culled_facing\": %llu, \"culled_zero_area\": %llu, \"culled_bounds\": %llu, "
+		        "\"clip_culled\": %llu, \"clip_inside\": %llu, \"clip_guard_band\": %llu, \"clip_clipped\": %llu, \"clip_triangles_out\": %llu, "
+		        "\"scalar_median_ms\": %.4f, \"diff_pixels\": %llu, \"max_channel_delta\": %u}",
+		        i ? "," : "", g_scene_names[(u32)r->scene], r->resolution.width, r->resolution.height, r->threads, r->triangles, r->frames,
+		        r->min_ms, r->mean_ms, r->median_ms, r->max_ms, r->stddev_ms, r->mpixels_per_s, r->mtriangles_per_s, r->speedup, r->efficiency,
+		        (unsigned long long)r->stats.triangles_binned, (unsigned long long)r->stats.bin_entries,
+		        (unsigned long long)r->stats.blocks_rasterized, (unsigned long long)r->stats.blocks_hiz_rejected,
+		        (unsigned long long)r->stats.triangles_culled_facing, (unsigned long long)r->stats.triangles_culled_zero_area,
+		        (unsigned long long)r->stats.triangles_culled_bounds,
+		        (unsigned long long)r->clip_stats.culled, (unsigned long long)r->clip_stats.inside, (unsigned long long)r->clip_stats.guard_band,
+		        (unsigned long long)r->clip_stats.clipped, (unsigned long long)r->clip_stats.triangles_out,
+		        r->scalar_median_ms, (unsigned long long)r->diff_pixels, r->max_channel_delta);
+	}
+	fprintf(file, "\n\t]\n}\n");
+	return fclose(file) == 0;
+}
+
+// ===============================================================================================================================
+// ======================================================== VALIDATION ===========================================================
+// ===============================================================================================================================
+//? Jittered shared-edge meshes over the whole target must hit every pixel exactly once ("raster_validate_coverage"),
+//? at the measured resolutions and at odd ones that leave partial tiles and blocks. Every mesh is rendered with the kernels
+//? of every ISA up to the one of this CPU ("-isa" lowers it) and with the scalar reference, on all hardware threads.
+//? Returns false on any miss or double hit
+internal b32 bench_validate_coverage(const Bench_Options *options)
+{
+	constexpr f32 cell_sizes[] = { 2.5f, 7.0f, 33.0f, 150.0f }; // pixels
+	Bench_Resolution resolutions[BENCH_MAX_RESOLUTIONS + 5] = { { 1921, 1079 }, { 1000, 700 }, { 64, 64 }, { 37, 23 }, { 1, 1 } };
+	u32 resolution_count = 5;
+	for (u32 i = 0; i < options->resolution_count; ++i)
+		resolutions[resolution_count++] = options->resolutions[i];
+	u32 threads = lib::clamp(std::thread::hardware_concurrency(), 1u, RASTER_MAX_THREADS);
+
+	// Triangles, their depth ordered copy, setups and bins, and raster context with coverage counters and target
+	u64 memory_size = 0;
+	for (u32 r = 0; r < resolution_count; ++r)
+	{
+		u64 cells = (u64)(lib::ceil((f32)resolutions[r].width / cell_sizes[0]) + 2) * (u64)(lib::ceil((f32)resolutions[r].height / cell_sizes[0]) + 2);
+		u64 size = 2 * cells * (2 * sizeof(Raster_Triangle) + sizeof(Raster_Setup) + 16 * sizeof(u32)) + MiB(1)
+		         + raster_memory_size(resolutions[r].width, resolutions[r].height, threads)
+		         + 2 * tiled_texel_count(resolutions[r].width, resolutions[r].height) * sizeof(u32) + 4 * ARENA_COMMIT_CHUNK;
+		memory_size = size > memory_size ? size : memory_size;
+	}
+	Alloc_Arena memory = arena_reserve(memory_size);
+	Alloc_Arena job_memory = arena_reserve(job_system_memory_size(threads));
+	if (!memory.base || !job_memory.base)
+	{
+		fprintf(stderr, "Failed to reserve %llu MiB\n", (unsigned long long)(memory_size / MiB(1)));
+		return false;
+	}
+	Job_System jobs{};
+	job_system_create(&jobs, &job_memory, threads);
+
+	b32 is_valid = true;
+	for (u32 r = 0; r < resolution_count; ++r)
+	{
+		Bench_Resolution res = resolutions[r];
+		for (u32 k = 0; k <= (u32)g_cpu.isa + 1; ++k)
+		{
+			// Kernels of every ISA, then the scalar one
+			b32 is_scalar = k > (u32)g_cpu.isa;
+			Cpu_Isa isa = is_scalar ? g_cpu.isa : (Cpu_Isa)k;
+			Raster_Kernel kernel = is_scalar ? Raster_Kernel::Scalar : Raster_Kernel::Wide;
+			const char *kernel_name = is_scalar ? "scalar" : cpu_isa_name(isa);
+
+			u64 triangles_total = 0;
+			Raster_Coverage_Report total{};
+			for (f32 cell : cell_sizes)
+			{
+				u32 cells_x = (u32)lib::ceil((f32)res.width / cell) + 2;
+				u32 cells_y = (u32)lib::ceil((f32)res.height / cell) + 2;
+				for (u32 seed = 1; seed <= BENCH_VALIDATE_SEEDS; ++seed)
+				{
+					arena_reset(&memory);
+					Raster_Triangle *triangles = push_type<Raster_Triangle>(&memory, 2 * cells_x * cells_y);
+					u32 count = raster_build_shared_edge_mesh(triangles, cells_x, cells_y, (f32)res.width, (f32)res.height, seed);
+					Raster_Coverage_Report report = raster_validate_coverage(&memory, &jobs, isa, kernel, triangles, count,
+					                                                         res.width, res.height);
+					if (report.missing || report.double_hit)
+					{
+						printf("  %ux%u %s cell %.1f seed %u: %llu missing, %llu double hit\n", res.width, res.height, kernel_name,
+						       cell, seed, (unsigned long long)report.missing, (unsigned long long)report.double_hit);
+					}
+					triangles_total += count;
+					total.missing += report.missing;
+					total.double_hit += report.double_hit;
+				}
+			}
+
+			b32 is_kernel_valid = !total.missing && !total.double_hit;
+			is_valid &= is_kernel_valid;
+			printf("coverage %5ux%-5u %-6s %3u meshes %9llu triangles: %llu missing, %llu double hit %s\n", res.width, res.height,
+			       kernel_name, array_count_32(cell_sizes) * BENCH_VALIDATE_SEEDS, (unsigned long long)triangles_total,
+			       (unsigned long long)total.missing, (unsigned long long)total.double_hit, is_kernel_valid ? "ok" : "FAILED");
+		}
+	}
+
+	job_system_destroy(&jobs);
+	vm_pages_release(job_memory.base, job_memory.max_size);
+	vm_pages_release(memory.base, memory.max_size);
+	return is_valid;
+}
+
+int main(int argc, char **argv)
+{
+	Bench_Options options = bench_parse_options(argc, argv);
+	if (!cpu_init(options.max_isa))
+	{
+		fprintf(stderr, "CPU without SSE4.2 and POPCNT, this build can not run on it\n");
+		return 1;
+	}
+
+	if (options.is_validating)
+		return bench_validate_coverage(&options) ? 0 : 1;
+
+	u32 max_threads = 0;
+	for (u32 i = 0; i < options.thread_count_count; ++i)
+		max_threads = lib::max(max_threads, options.thread_counts[i]);
+	Bench_Resolution max_resolution{};
+	for (u32 i = 0; i < options.resolution_count; ++i)
+	{
+		max_resolution.width = lib::max(max_resolution.width, options.resolutions[i].width);
+		max_resolution.height = lib::max(max_resolution.height, options.resolutions[i].height);
+	}
+
+	u32 max_triangles = 1;
+	u32 max_clip_triangles = 0;
+	for (u32 s = 0; s < (u32)Bench_Scene::Count; ++s)
+	{
+		max_triangles = lib::max(max_triangles, bench_scene_max_triangles((Bench_Scene)s, max_resolution.width, max_resolution.height));
+		max_clip_triangles = lib::max(max_clip_triangles, bench_scene_max_clip_triangles((Bench_Scene)s));
+	}
+
+	// Target and raster surfaces are sized for the biggest resolution, frame arena for the worst binning of all scenes
+	u32 max_pitch = (u32)AlignAddressPow2(max_resolution.width * sizeof(u32), 256);
+	u64 target_size = lib::max(tiled_texel_count(max_resolution.width, max_resolution.height) * sizeof(u32), (u64)max_pitch * max_resolution.height);
+	u64 frame_memory_size = (u64)max_triangles * (sizeof(Raster_Setup) + 16 * sizeof(u32)) + MiB(16);
+	u64 memory_size = job_system_memory_size(max_threads) + raster_memory_size(max_resolution.width, max_resolution.height, max_threads)
+	                + target_size + frame_memory_size + (u64)max_triangles * sizeof(Raster_Triangle)
+	                + (u64)max_clip_triangles * (sizeof(Raster_Clip_Triangle) + 1) + MiB(1);
+	if (options.is_comparing)
+		memory_size += target_size; // frame of the measured kernel, scalar reference renders into the target after it
+
+	// Reserved like application memory, frame and clip arenas are sub-arenas rebuilt after every reset.
+	// Those begin and end on a commit chunk boundary, hence the slack
+	memory_size += 4 * ARENA_COMMIT_CHUNK;
+	Alloc_Arena memory = arena_reserve(memory_size);
+	if (!memory.base)
+	{
+		fprintf(stderr, "Failed to reserve %llu MiB\n", (unsigned long long)(memory_size / MiB(1)));
+		return 1;
+	}
+
+	Bench_Result *results = (Bench_Result *)calloc(BENCH_MAX_RESULTS, sizeof(Bench_Result));
+	u32 result_count = 0;
+	f64 frame_ms[BENCH_MAX_FRAMES];
+
+	printf("%s kernels (%s supported) on %s\n", cpu_isa_name(g_cpu.isa), cpu_isa_name(g_cpu.supported), g_cpu.brand);
+	if (options.is_comparing)
+		printf("%-15s %11s %7s %9s %9s %9s %8s %11s %9s\n",
+		       "scene", "resolution", "threads", "triangles", "median_ms", "scalar_ms", "speedup", "diff_pixels", "max_delta");
+	else
+		printf("%-15s %11s %7s %9s %9s %9s %8s %10s %10s %6s\n",
+		       "scene", "resolution", "threads", "triangles", "median_ms", "stddev_ms", "cv_%", "Mpix/s", "Mtri/s", "eff");
+	b32 is_matching = true;
+
+	for (u32 r = 0; r < options.resolution_count; ++r)
+	{
+		Bench_Resolution res = options.resolutions[r];
+		for (u32 s = 0; s < (u32)Bench_Scene::Count; ++s)
+		{
+			Bench_Scene scene = (Bench_Scene)s;
+			if (options.scene && strcmp(options.scene, g_scene_names[s]))
+				continue;
+
+			f64 single_thread_ms = 0.0;
+			for (u32 t = 0; t < options.thread_count_count && result_count < BENCH_MAX_RESULTS; ++t)
+			{
+				u32 threads = options.thread_counts[t];
+
+				// Everything is rebuilt inside of the same memory for every configuration
+				arena_reset(&memory);
+				Job_System jobs{};
+				job_system_create(&jobs, &memory, threads);
+				Raster_Context raster = raster_create(&memory, frame_memory_size, &jobs, res.width, res.height);
+				raster.cull_mode = bench_scene_cull_mode(scene);
+				raster.kernel = options.kernel;
+
+				u32 pitch = (u32)AlignAddressPow2(res.width * sizeof(u32), 256);
+				Game_Framebuffer target
+				{
+					.base = (u32 *)allocate(&memory, target_size, 256),
+					.width = res.width,
+					.height = res.height,
+					.max_width = res.width,
+					.max_height = res.height,
+					.pitch = options.is_linear ? pitch : 0,
+					.format = Game_Pixel_Format::RGBA8,
+					.layout = options.is_linear ? Game_Framebuffer_Layout::Linear : Game_Framebuffer_Layout::Tiled,
+					.tile_size = TILED_TILE_SIZE,
+					.block_size = TILED_BLOCK_SIZE,
+				};
+
+				// Clip space scenes are clipped into their own arena every frame, which holds the screen space triangles
+				b32 is_clipped = bench_scene_is_clipped(scene);
+				u64 max_scene_triangles = lib::max(bench_scene_max_triangles(scene, res.width, res.height), 1u);
+				Raster_Triangle *triangles = nullptr;
+				u32 triangle_count = 0;
+				Raster_Clip_Triangle *clip_triangles = nullptr;
+				Alloc_Arena clip_arena{};
+				if (is_clipped)
+				{
+					clip_triangles = push_type<Raster_Clip_Triangle>(&memory, bench_scene_max_clip_triangles(scene));
+					triangle_count = bench_scene_build_clip(scene, clip_triangles, res.width, res.height);
+					clip_arena = arena_from_allocator(&memory, triangle_count + max_scene_triangles * sizeof(Raster_Triangle) + 128);
+				}
+				else
+				{
+					triangles = push_type<Raster_Triangle>(&memory, (u32)max_scene_triangles);
+					triangle_count = bench_scene_build(scene, triangles, res.width, res.height);
+				}
+
+				Viewport viewport{ 0.0f, 0.0f, (f32)res.width, (f32)res.height };
+				Raster_Clip_Stats clip_stats{};
+				auto render_frame = [&]
+				{
+					if (!is_clipped)
+					{
+						raster_render(&raster, &target, 0xFF201810, triangles, triangle_count);
+						return;
+					}
+					arena_reset(&clip_arena);
+					clip_stats = {};
+					Raster_Clip_Output clipped = raster_clip_triangles(&clip_arena, viewport, clip_triangles, triangle_count, &clip_stats);
+					raster_render(&raster, &target, 0xFF201810, clipped.triangles, clipped.count);
+				};
+
+				for (u32 i = 0; i < options.warmup_frames; ++i)
+					render_frame();
+
+				for (u32 i = 0; i < options.frames; ++i)
+				{
+					f64 start = bench_now_ms();
+					render_frame();
+					frame_ms[i] = bench_now_ms() - start;
+				}
+
+				Bench_Result *result = &results[result_count++];
+				result->scene = scene;
+				result->resolution = res;
+				result->threads = threads;
+				result->triangles = triangle_count;
+				result->stats = raster.stats;
+				result->clip_stats = clip_stats;
+				bench_summarize(result, frame_ms, options.frames);
+
+				if (threads == 1)
+					single_thread_ms = result->median_ms;
+				if (single_thread_ms > 0.0)
+				{
+					result->speedup = single_thread_ms / result->median_ms;
+					result->efficiency = result->speedup / threads;
+				}
+
+				char resolution[32];
+				snprintf(resolution, sizeof(resolution), "%ux%u", res.width, res.height);
+				if (!options.is_comparing)
+				{
+					printf("%-15s %11s %7u %9u %9.3f %9.3f %8.2f %10.1f %10.2f %6.2f\n",
+					       g_scene_names[s], resolution, threads, triangle_count, result->median_ms, result->stddev_ms,
+					       100.0 * result->stddev_ms / result->mean_ms, result->mpixels_per_s, result->mtriangles_per_s, result->efficiency);
+				}
+				else
+				{
+					// Last frame of the measured kernel is kept, the scalar reference renders the same frame over it
+					u32 *measured = push_type<u32>(&memory, (u32)(target_size / sizeof(u32)));
+					memcpy(measured, target.base, target_size);
+					raster.kernel = Raster_Kernel::Scalar;
+					render_frame();
+					for (u32 i = 0; i < options.frames; ++i)
+					{
+						f64 start = bench_now_ms();
+						render_frame();
+						frame_ms[i] = bench_now_ms() - start;
+					}
+					Bench_Result scalar = *result;
+					bench_summarize(&scalar, frame_ms, options.frames);
+					result->scalar_median_ms = scalar.median_ms;
+
+					for (u64 i = 0; i < target_size / sizeof(u32); ++i)
+					{
+						u32 a = measured[i], b = target.base[i];
+						if (a == b)
+							continue;
+						result->diff_pixels++;
+						for (u32 shift = 0; shift < 32; shift += 8)
+						{
+							u32 delta = (u32)lib::abs((s32)((a >> shift) & 0xFF) - (s32)((b >> shift) & 0xFF));
+							result->max_channel_delta = lib::max(result->max_channel_delta, delta);
+						}
+					}
+					is_matching &= result->diff_pixels == 0;
+					printf("%-15s %11s %7u %9u %9.3f %9.3f %8.2f %11llu %9u\n",
+					       g_scene_names[s], resolution, threads, triangle_count, result->median_ms, result->scalar_median_ms,
+					       result->scalar_median_ms / result->median_ms, (unsigned long long)result->diff_pixels, result->max_channel_delta);
+				}
+
+				job_system_destroy(&jobs);
+			}
+		}
+	}
+
+	int exit_code = 0;
+	if (!is_matching)
+	{
+		fprintf(stderr, "Kernels do not match the scalar reference\n");
+		exit_code = 1;
+	}
+	if (options.json_file)
+	{
+		if (bench_write_json(options.json_file, &options, results, result_count))
+			printf("results written to \"%s\"\n", options.json_file);
+		else
+		{
+			fprintf(stderr, "Could not write \"%s\"\n", options.json_file);
+			exit_code = 1;
+		}
+	}
+
+	free(results);
+	vm_pages_release(memory.base, memory.max_size);
+	return exit_code;
+}
@@ -7,8 +7,10 @@ where /q cl || (
 
 set warnings=/WX /W4 /wd4201 /wd4100 /wd4189 /wd4505 /wd4701
 set includes=/I ../my_lib/
-set linkerFlags=/OUT:main.exe /INCREMENTAL:NO /OPT:REF /CGTHREADS:6 /STACK:0x100000,0x100000 user32.lib gdi32.lib winmm.lib dxgi.lib dxguid.lib d3d11.lib D3DCompiler.lib
-set common_compiler=/std:c++20 /MT /MP /arch:AVX2 /Oi /Ob3 /EHsc /fp:fast /fp:except- /openmp:llvm /nologo /GS- /Gs999999 /GR- /FC /Z7 /Qvec-report:2 %includes% %warnings%
+:: No /arch, baseline is SSE4.2 and wider kernels are picked at runtime (see "Cpu_Features.hpp"), math micro-benchmarks stay AVX2
+set lib_bench_flags=/arch:AVX2
+set linkerFlags=/INCREMENTAL:NO /OPT:REF /CGTHREADS:6 /STACK:0x100000,0x100000 user32.lib gdi32.lib winmm.lib dxgi.lib dxguid.lib d3d11.lib D3DCompiler.lib
+set common_compiler=/std:c++20 /MT /MP /Oi /Ob3 /EHsc /fp:fast /fp:except- /nologo /GS- /Gs999999 /GR- /FC /Z7 /Qvec-report:2 %includes% %warnings%
 
 if "%~1"=="-Debug" (
 	echo debug build
@@ -18,10 +20,16 @@ if "%~1"=="-Release" (
 	echo release build
 	set compilerFlags=%common_compiler% /O2 
 )
+if "%~1"=="-Profile" (
+	echo profile build
+	set compilerFlags=%common_compiler% /O2 /DPROFILER_ENABLED=1
+)
 
 IF NOT EXIST .\build mkdir .\build
 pushd .\build
 del *.pdb > NUL 2> NUL
 
-cl.exe %compilerFlags% ../source/Win32_x64_Platform.cpp ../source/Game.cpp /link %linkerFlags%
+cl.exe %compilerFlags% ../source/Win32_x64_Platform.cpp ../source/Game.cpp /link /OUT:main.exe %linkerFlags% || (popd & exit /b 1)
+cl.exe %compilerFlags% ../bench/Raster_Bench.cpp /link /OUT:raster_bench.exe %linkerFlags% || (popd & exit /b 1)
+cl.exe %compilerFlags% %lib_bench_flags% ../bench/Lib_Bench.cpp /link /OUT:lib_bench.exe %linkerFlags%
 popd
\ No newline at end of file
@@ -0,0 +1,40 @@
+#!/bin/sh
+# POSIX counterpart of "build.bat" - builds the headless platform layer with GCC or Clang
+
+CXX=${CXX:-g++}
+command -v "$CXX" > /dev/null || {
+	echo "ERROR: could not find \"$CXX\" - set CXX to a C++20 compiler."
+	exit 1
+}
+
+# Every warning is an error, code is fixed instead of relaxing this list per file or per function
+warnings="-Werror -Wall -Wextra -Wno-unused-parameter -Wno-unused-variable -Wno-unused-function -Wno-maybe-uninitialized -Wno-missing-field-initializers"
+includes="-I ../my_lib/"
+linkerFlags="-lm"
+# Baseline is SSE4.2, wider kernels are compiled in target regions and picked at runtime (see "Cpu_Features.hpp").
+# No FP contraction, so kernels of every ISA round the same whether the target has FMA or not
+common_compiler="-std=c++20 -msse4.2 -mpopcnt -ffast-math -ffp-contract=off -fno-rtti -g -pthread $includes $warnings"
+# Micro-benchmarks of the AVX2 math types themselves
+lib_bench_flags="-mavx2 -mfma"
+
+case "$1" in
+	-Debug)
+		echo "debug build"
+		compilerFlags="$common_compiler -O0 -D_DEBUG"
+		;;
+	-Profile)
+		echo "profile build"
+		compilerFlags="$common_compiler -O2 -DPROFILER_ENABLED=1"
+		;;
+	*)
+		echo "release build"
+		compilerFlags="$common_compiler -O2"
+		;;
+esac
+
+mkdir -p ./build
+cd ./build || exit 1
+
+$CXX $compilerFlags ../source/Posix_x64_Platform.cpp ../source/Game.cpp -o raster $linkerFlags || exit 1
+$CXX $compilerFlags ../bench/Raster_Bench.cpp -o raster_bench $linkerFlags || exit 1
+$CXX $compilerFlags $lib_bench_flags ../bench/Lib_Bench.cpp -o lib_bench $linkerFlags
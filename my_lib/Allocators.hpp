@@ -6,7 +6,7 @@
 #include "Utils.hpp"
 
 //TODO: CUSTOM MEMSET
-//TODO: Consider removing memsetting or leaving it only for reset 
+//TODO: Consider removing memsetting from stack and pool as well, arena zeroes only when asked to
 
 template <typename T>
 [[nodiscard]]
@@ -15,12 +15,25 @@ inline T *push_type(auto *allocator, u32 count = 1)
 	return ( T*)allocate(allocator, sizeof(T) * count, alignof(T));
 } 
 
+//? Reserved arenas commit in chunks of this size, so growing by small allocations costs one commit per chunk
+constexpr u64 ARENA_COMMIT_CHUNK = MiB(2);
+
+//? Page operations of reserved arenas, provided by platform (see "VM_Pages.hpp"), so allocators stay free of OS headers
+struct Alloc_Pages
+{
+	void *(*commit)(void *at, u64 size_bytes); // nullptr on failure, pages committed for the first time read as zero
+	b32 (*decommit)(void *at, u64 size_bytes); // memory goes back to OS, commit again before use
+};
+
 struct Alloc_Arena_Temp
 {
 	u64 curr_offset;
 	u64 prev_offset;
 };
 
+//? Arena either lives in memory of someone else ("pages" is nullptr, whole "max_size" is usable) or owns a reservation
+//? of address space and commits it in "ARENA_COMMIT_CHUNK"s as "curr_offset" grows.
+//? Nothing is zeroed on reset or on end of a temp scope unless asked for, only pages committed for the first time are zero
 struct Alloc_Arena
 {
 	u64 max_size;
@@ -29,8 +42,67 @@ struct Alloc_Arena
 	u64 curr_offset;
 	u64 prev_offset;
 	Alloc_Arena_Temp temp_start;
+
+	u64 committed;            // bytes from "base" backed by memory, set to "max_size" on first allocation when "pages" is nullptr
+	u64 high_water;           // highest "curr_offset" since last reset, caught up whenever "curr_offset" moves back
+	const Alloc_Pages *pages;
+	// Ranges of sub-arenas (see "arena_from_allocator") are counted in "committed" without being committed by this arena,
+	// "committed" is exact only below "sub_arena_offset". No such range when "sub_arena_end" is 0
+	u64 sub_arena_offset;
+	u64 sub_arena_end;
+};
+
+enum class Arena_Reset : u32
+{
+	Keep,     // O(1), committed pages stay and hold whatever was written
+	Zero,     // memset of bytes used since previous reset, not of whole "max_size"
+	Decommit, // committed pages above high water mark of the ended cycle go back to OS, rest is kept as with "Keep"
+	Count,
 };
 
+//? Slow path of allocations, commits chunks until "end_offset" is backed by memory
+inline void arena_commit(Alloc_Arena *arena, const u64 end_offset)
+{
+	assert(end_offset <= arena->max_size && "No more memory!");
+	if (!arena->pages)
+	{
+		arena->committed = arena->max_size;
+		return;
+	}
+
+	u64 new_committed = AlignAddressPow2(end_offset, ARENA_COMMIT_CHUNK);
+	new_committed = new_committed < arena->max_size ? new_committed : arena->max_size;
+	void *committed = arena->pages->commit(arena->base + arena->committed, new_committed - arena->committed);
+	assert(committed && "Failed to commit memory");
+	arena->committed = new_committed;
+}
+
+//? Everything from "offset" up is dead, called before "curr_offset" moves back to it. Bytes up to "zero_end" are zeroed.
+//? Sub-arena ranges above "offset" come back to this arena: their pages may be uncommitted, so whole chunks above
+//? "offset" are decommitted (they read as zero once committed again) and "committed" falls back to where it is exact.
+//? Arena commits them again once it grows there
+inline void arena_release_above(Alloc_Arena *arena, const u64 offset, const u64 zero_end)
+{
+	u64 backed_end = arena->committed;
+	if (arena->sub_arena_end > offset)
+	{
+		// Below "sub_arena_offset" everything is committed, partial chunk at "offset" is one the arena allocated in itself
+		// (sub-arena ranges begin and end on a chunk boundary)
+		backed_end = AlignAddressPow2(offset, ARENA_COMMIT_CHUNK);
+		backed_end = backed_end > arena->sub_arena_offset ? backed_end : arena->sub_arena_offset;
+		if (arena->committed > backed_end)
+		{
+			b32 is_decommitted = arena->pages->decommit(arena->base + backed_end, arena->committed - backed_end);
+			assert(is_decommitted && "Failed to decommit memory");
+		}
+		if (arena->committed > arena->sub_arena_offset)
+			arena->committed = arena->sub_arena_offset;
+		arena->sub_arena_end = 0;
+	}
+	if (zero_end > offset)
+		memset(arena->base + offset, 0, (zero_end < backed_end ? zero_end : backed_end) - offset);
+}
+
 [[nodiscard]]
 inline Alloc_Arena arena_from_allocator(auto* allocator, const u64 max_size)
 {
@@ -43,6 +115,8 @@ inline void *allocate(Alloc_Arena *arena, const u64 size_bytes, const u64 alignm
 	arena->curr_offset = AlignAddressPow2((u64)arena->base + arena->curr_offset, alignment);
 	arena->curr_offset -= (u64)arena->base;
 	assert( ( (arena->curr_offset + size_bytes) <= arena->max_size) && "No more memory!" );
+	if (arena->curr_offset + size_bytes > arena->committed)
+		arena_commit(arena, arena->curr_offset + size_bytes);
 
 	void *out = (void*) ((byte*)arena->base + arena->curr_offset);
 	arena->prev_offset = arena->curr_offset;
@@ -51,17 +125,50 @@ inline void *allocate(Alloc_Arena *arena, const u64 size_bytes, const u64 alignm
 	return out;
 }
 
+//? Sub-arena of a reserved arena takes only address space from its parent and commits its own pages as it grows,
+//? so a big frame arena costs nothing until frames actually use it. It begins and ends on a commit chunk boundary.
+//? It is dead once parent resets or ends a temp scope below it, parent takes the range back then
+[[nodiscard]]
+inline Alloc_Arena arena_from_allocator(Alloc_Arena *parent, const u64 max_size)
+{
+	if (!parent->pages)
+		return { max_size, (byte *)allocate(parent, max_size) };
+
+	u64 offset = AlignAddressPow2(parent->curr_offset, ARENA_COMMIT_CHUNK);
+	u64 end_offset = offset + (AlignAddressPow2(max_size, ARENA_COMMIT_CHUNK));
+	assert(end_offset <= parent->max_size && "No more memory!");
+	parent->prev_offset = offset;
+	parent->curr_offset = end_offset;
+
+	Alloc_Arena out{ .max_size = max_size, .base = parent->base + offset, .pages = parent->pages };
+	// Parent may have committed into the range before (and rewound), those pages are already usable
+	if (parent->committed > offset)
+		out.committed = parent->committed - offset < max_size ? parent->committed - offset : max_size;
+	// Range belongs to the sub-arena now, parent commits only above it until it moves back below "sub_arena_end"
+	if (parent->committed < end_offset)
+	{
+		if (!parent->sub_arena_end)
+			parent->sub_arena_offset = offset;
+		parent->sub_arena_end = end_offset;
+		parent->committed = end_offset;
+	}
+	return out;
+}
+
+//? Contents of the shrunk part are kept, nothing is zeroed
 [[nodiscard]]
 inline void *arena_resize_last(Alloc_Arena *arena, void *old_memory, const u64 size_bytes)
 {
 	assert((byte *)old_memory == arena->base + arena->prev_offset && "This is not last allocated memory");
-	assert( ( (arena->curr_offset + size_bytes) <= arena->max_size) && "No more memory!" );
+	assert( ( (arena->prev_offset + size_bytes) <= arena->max_size) && "No more memory!" );
 
 	auto new_size = arena->prev_offset + size_bytes;
-	auto old_size = arena->curr_offset - arena->prev_offset;
-
-	if(new_size < old_size)
-		memset(arena->base + new_size, 0, old_size - new_size);
+	if (new_size < arena->curr_offset)
+		arena_release_above(arena, new_size, 0);
+	if (new_size > arena->committed)
+		arena_commit(arena, new_size);
+	if (arena->curr_offset > arena->high_water)
+		arena->high_water = arena->curr_offset;
 	arena->curr_offset = new_size;
 	
 	return old_memory;
@@ -96,20 +203,39 @@ inline void arena_start_temp(Alloc_Arena *arena)
 	arena->temp_start.prev_offset = arena->prev_offset;
 }
 
-inline void arena_end_temp(Alloc_Arena *arena)
+//? O(1) by default, "zero_memory" clears everything allocated inside of the temp scope
+inline void arena_end_temp(Alloc_Arena *arena, b32 zero_memory = false)
 {
 	assert(arena);
-	memset(arena->base + arena->prev_offset, 0, arena->curr_offset - arena->prev_offset);
+	arena_release_above(arena, arena->temp_start.curr_offset, zero_memory ? arena->curr_offset : 0);
+	if (arena->curr_offset > arena->high_water)
+		arena->high_water = arena->curr_offset;
 	arena->curr_offset = arena->temp_start.curr_offset;
 	arena->prev_offset = arena->temp_start.prev_offset;
 }
 
-inline void arena_reset(Alloc_Arena *arena)
+//? O(1) by default, cost of "Zero" scales with what was used since previous reset. Arena that gave out sub-arenas
+//? decommits their ranges (see "arena_release_above"), so rebuilding sub-arenas after reset is safe.
+//? "Decommit" is meant for arenas reset every frame: calling it every now and then returns pages committed by a spike
+//? while the steady state keeps its pages committed. Arenas without "pages" treat it as "Keep"
+inline void arena_reset(Alloc_Arena *arena, Arena_Reset mode = Arena_Reset::Keep)
 {
 	assert(arena);
-	memset(arena->base, 0, arena->max_size);
+	u64 high_water = arena->curr_offset > arena->high_water ? arena->curr_offset : arena->high_water;
+	arena_release_above(arena, 0, mode == Arena_Reset::Zero ? high_water : 0);
+	if (mode == Arena_Reset::Decommit && arena->pages)
+	{
+		u64 keep = AlignAddressPow2(high_water, ARENA_COMMIT_CHUNK);
+		if (arena->committed > keep)
+		{
+			b32 is_decommitted = arena->pages->decommit(arena->base + keep, arena->committed - keep);
+			assert(is_decommitted && "Failed to decommit memory");
+			arena->committed = keep;
+		}
+	}
 	arena->curr_offset = 0;
 	arena->prev_offset = 0;
+	arena->high_water = 0;
 }
 
 struct Alloc_Stack_Header
@@ -248,9 +374,10 @@ inline void free_block(Alloc_Pool *pool, void *ptr)
 	
 	byte *end = pool->base + pool->max_size;
 	assert(((byte *)ptr < end ) && ((byte *)ptr >= pool->base) && "Provided memory addres is out of bounds!");
-	assert((u64)ptr % pool->block_size == 0 && "The address is offsetted - is not a block beginning!");
+	u64 offset = (u64)((byte *)ptr - pool->base);
+	assert(offset % pool->block_size == 0 && "The address is offsetted - is not a block beginning!");
 	
 	Pool_Free_Node *head_node = (Pool_Free_Node *)ptr;
 	head_node->next = pool->head_block;
-	pool->head_block = (u64)(head_node - (Pool_Free_Node *)pool->base);
+	pool->head_block = offset / pool->block_size; // block index, same unit as "get_node"
 }
\ No newline at end of file
@@ -0,0 +1,170 @@
+#pragma once
+//? -----------------------------------------------------------------------------------------------
+//? CPU FEATURE DETECTION AND PER ISA CODE SELECTION. BASELINE OF THE BUILD IS SSE4.2 + POPCNT, WIDER KERNELS ARE
+//? COMPILED NEXT TO THE BASELINE ONES INSIDE OF "CPU_TARGET_*" REGIONS AND PICKED AT STARTUP, SO ONE BINARY RUNS
+//? ON ANY X64 CPU OF THE LAST DECADE AND STILL USES EVERYTHING THE CPU HAS.
+//? -----------------------------------------------------------------------------------------------
+
+//? Platform calls "cpu_init" once at startup, before anything else reads "g_cpu". Hot paths keep tables of
+//? function pointers per ISA and pick one by "g_cpu.isa" (see "Raster_Kernels"), "max_isa" of "cpu_init" caps the choice,
+//? so narrower kernels can be benchmarked and validated on a wide machine.
+//? GCC and Clang compile a region for the wider target, MSVC compiles any intrinsic regardless of /arch,
+//? so regions are empty there and only intrinsics themselves are wide, code around them stays baseline.
+//! Code of a region may run only when "g_cpu.isa" is at least the ISA of that region.
+//! Never include a header inside of a region, everything it defines would silently require the wider ISA.
+//! Baseline code must not pass or return __m256 / __m512 by value, their calling convention differs between targets
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#include <immintrin.h>
+#include <string.h>
+
+#include "Utils.hpp"
+
+#if defined(__clang__)
+#define CPU_TARGET_AVX2_BEGIN _Pragma("clang attribute push(__attribute__((target(\"avx2,fma,bmi,bmi2,popcnt\"))), apply_to = function)")
+#define CPU_TARGET_AVX512_BEGIN _Pragma("clang attribute push(__attribute__((target(\"avx512f,avx512dq,avx512bw,avx512vl,avx2,fma,bmi,bmi2,popcnt\"))), apply_to = function)")
+#define CPU_TARGET_END _Pragma("clang attribute pop")
+#elif defined(__GNUC__)
+#define CPU_TARGET_AVX2_BEGIN _Pragma("GCC push_options") _Pragma("GCC target(\"avx2,fma,bmi,bmi2,popcnt\")")
+#define CPU_TARGET_AVX512_BEGIN _Pragma("GCC push_options") _Pragma("GCC target(\"avx512f,avx512dq,avx512bw,avx512vl,avx2,fma,bmi,bmi2,popcnt\")")
+#define CPU_TARGET_END _Pragma("GCC pop_options")
+#else
+#define CPU_TARGET_AVX2_BEGIN
+#define CPU_TARGET_AVX512_BEGIN
+#define CPU_TARGET_END
+#endif
+
+enum class Cpu_Isa : u32
+{
+	SSE42,  // SSE4.2 + POPCNT, baseline of the build
+	AVX2,   // + AVX, AVX2, FMA, BMI1, BMI2 (Haswell, Zen 1 and newer)
+	AVX512, // + AVX-512 F, DQ, BW, VL (Skylake-X, Ice Lake, Zen 4 and newer)
+	Count,
+};
+
+global_variable const char *g_cpu_isa_names[] = { "sse42", "avx2", "avx512" };
+static_assert(array_count_32(g_cpu_isa_names) == (u32)Cpu_Isa::Count);
+
+struct Cpu_Info
+{
+	b32 is_initialized;
+	b32 has_baseline; // build can not run at all without it
+	Cpu_Isa supported; // widest ISA with every feature present and its register state enabled by OS
+	Cpu_Isa isa;       // the one code runs with, "supported" unless capped by "cpu_init"
+	char brand[49];
+
+	b32 sse42, popcnt;
+	b32 avx, avx2, fma, bmi1, bmi2;
+	b32 avx512f, avx512dq, avx512bw, avx512vl;
+	b32 os_avx;    // XCR0 enables ymm state, AVX instructions fault without it
+	b32 os_avx512; // XCR0 enables opmask and zmm state
+};
+
+inline Cpu_Info g_cpu;
+
+inline const char *cpu_isa_name(Cpu_Isa isa)
+{
+	return (u32)isa < (u32)Cpu_Isa::Count ? g_cpu_isa_names[(u32)isa] : "unknown";
+}
+
+//? Case sensitive, names of "g_cpu_isa_names"
+inline b32 cpu_isa_parse(const char *name, Cpu_Isa *out)
+{
+	for (u32 i = 0; i < (u32)Cpu_Isa::Count; ++i)
+	{
+		if (!strcmp(name, g_cpu_isa_names[i]))
+		{
+			*out = (Cpu_Isa)i;
+			return true;
+		}
+	}
+	return false;
+}
+
+//? regs = { eax, ebx, ecx, edx }
+inline void cpu_cpuid(u32 leaf, u32 subleaf, u32 regs[4])
+{
+#if defined(_MSC_VER)
+	__cpuidex((int *)regs, (int)leaf, (int)subleaf);
+#else
+	__cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+//? Must be called only when CPUID reports OSXSAVE
+inline u64 cpu_xgetbv(u32 index)
+{
+#if defined(_MSC_VER)
+	return _xgetbv(index);
+#else
+	u32 lo, hi;
+	__asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(index));
+	return ((u64)hi << 32) | lo;
+#endif
+}
+
+inline Cpu_Info cpu_detect()
+{
+	Cpu_Info out{};
+	u32 regs[4];
+	cpu_cpuid(0, 0, regs);
+	u32 max_leaf = regs[0];
+
+	b32 os_xsave = false;
+	if (max_leaf >= 1)
+	{
+		cpu_cpuid(1, 0, regs);
+		out.sse42 = TestBit(regs[2], 20);
+		out.popcnt = TestBit(regs[2], 23);
+		out.fma = TestBit(regs[2], 12);
+		out.avx = TestBit(regs[2], 28);
+		os_xsave = TestBit(regs[2], 27);
+	}
+	if (max_leaf >= 7)
+	{
+		cpu_cpuid(7, 0, regs);
+		out.bmi1 = TestBit(regs[1], 3);
+		out.avx2 = TestBit(regs[1], 5);
+		out.bmi2 = TestBit(regs[1], 8);
+		out.avx512f = TestBit(regs[1], 16);
+		out.avx512dq = TestBit(regs[1], 17);
+		out.avx512bw = TestBit(regs[1], 30);
+		out.avx512vl = TestBit(regs[1], 31);
+	}
+	if (os_xsave)
+	{
+		u64 xcr0 = cpu_xgetbv(0);
+		out.os_avx = (xcr0 & 0x6) == 0x6;                    // xmm, ymm
+		out.os_avx512 = out.os_avx && (xcr0 & 0xE0) == 0xE0; // opmask, upper halves of zmm 0-15, zmm 16-31
+	}
+
+	cpu_cpuid(0x80000000, 0, regs);
+	if (regs[0] >= 0x80000004)
+	{
+		for (u32 i = 0; i < 3; ++i)
+		{
+			cpu_cpuid(0x80000002 + i, 0, regs);
+			memcpy(out.brand + i * 16, regs, 16);
+		}
+	}
+
+	out.has_baseline = out.sse42 && out.popcnt;
+	b32 has_avx2 = out.has_baseline && out.avx && out.avx2 && out.fma && out.bmi1 && out.bmi2 && out.os_avx;
+	b32 has_avx512 = has_avx2 && out.avx512f && out.avx512dq && out.avx512bw && out.avx512vl && out.os_avx512;
+	out.supported = has_avx512 ? Cpu_Isa::AVX512 : has_avx2 ? Cpu_Isa::AVX2 : Cpu_Isa::SSE42;
+	return out;
+}
+
+//? Fills "g_cpu", ISA is the widest supported one not above "max_isa".
+//? Returns false when CPU lacks the baseline, nothing of this build can run then
+inline b32 cpu_init(Cpu_Isa max_isa = Cpu_Isa::AVX512)
+{
+	g_cpu = cpu_detect();
+	g_cpu.isa = (u32)max_isa < (u32)g_cpu.supported ? max_isa : g_cpu.supported;
+	g_cpu.is_initialized = true;
+	return g_cpu.has_baseline;
+}
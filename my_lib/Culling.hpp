@@ -0,0 +1,344 @@
+#pragma once
+//? -----------------------------------------------------------------------------------------------
+//? FRUSTUM CULLING: PLANES OF A VIEW-PROJECTION MATRIX, SPHERE / AABB / OBB BOUNDS, SCALAR CLASSIFICATION OF ONE BOUND
+//? AND BATCHED AVX2 TESTS OF 8 BOUNDS AGAINST ALL 6 PLANES PER ITERATION ("Math_Wide.hpp"), WHICH WRITE COMPACTED
+//? LISTS OF VISIBLE INDICES, SO ONLY OBJECTS THAT CAN BE SEEN ARE EVER TRANSFORMED AND RASTERIZED.
+//? -----------------------------------------------------------------------------------------------
+
+//? Planes point inwards: points with dot(normal, p) + d >= 0 are on the inner side. Planes are normalized, so
+//? the distance is in world units and spheres need no extra work.
+//? Tests are conservative: a bound that is outside of no single plane is visible, even when it is outside of
+//? the frustum near one of its corners. Only visible objects get drawn anyway, so it costs a little overdraw of
+//? work, never a missing object. Batches keep exactly the bounds that scalar "frustum_classify" does not reject,
+//? masked tail included, lib_bench "culling" checks it before timing and fails otherwise.
+//? Batches read SoA streams ("Vertex_Stream3" per vector member) with unaligned and, for the last "count % 8",
+//? masked loads. Per 8 bounds it is 6 planes of FMAs, one movemask and one permute + store of indices, no
+//? branches, so a scene where most objects are outside costs the loads and little more (lib_bench "culling").
+//! Output index arrays must have room for "count" rounded up to multiple of 8 (see "cull_output_capacity"),
+//! every iteration stores 8 indices and only advances by the visible ones
+
+#include <immintrin.h>
+
+#include "Utils.hpp"
+#include "Math.hpp"
+#include "Math_Wide.hpp"
+#include "Vertex_Transform.hpp"
+#include "Cpu_Features.hpp"
+
+struct Plane
+{
+	lib::Vec3 normal;
+	f32 d;
+};
+
+enum Frustum_Plane : u32
+{
+	FRUSTUM_LEFT,
+	FRUSTUM_RIGHT,
+	FRUSTUM_BOTTOM,
+	FRUSTUM_TOP,
+	FRUSTUM_NEAR,
+	FRUSTUM_FAR,
+	FRUSTUM_PLANE_COUNT,
+};
+
+struct Frustum
+{
+	Plane planes[FRUSTUM_PLANE_COUNT];
+};
+
+struct Sphere
+{
+	lib::Vec3 center;
+	f32 radius;
+};
+
+//? Center + half sizes, what the plane test needs, "aabb_from_min_max" converts from corners
+struct AABB
+{
+	lib::Vec3 center;
+	lib::Vec3 extent;
+};
+
+//? Center + 3 orthogonal axes, each scaled by half size along it
+struct OBB
+{
+	lib::Vec3 center;
+	lib::Vec3 axes[3];
+};
+
+enum class Cull_Result : u32
+{
+	Outside,      // behind at least one plane, not visible
+	Intersecting, // crosses a plane, visible, geometry may need clipping
+	Inside,       // in front of every plane, visible, no clipping needed
+};
+
+//? SoA streams of bounds, element "i" of every member stream belongs to bound "i"
+struct Sphere_Stream
+{
+	Vertex_Stream3 center;
+	f32 *radius;
+};
+
+struct AABB_Stream
+{
+	Vertex_Stream3 center;
+	Vertex_Stream3 extent;
+};
+
+struct OBB_Stream
+{
+	Vertex_Stream3 center;
+	Vertex_Stream3 axes[3];
+};
+
+inline u32 cull_output_capacity(u32 count)
+{
+	return (count + lib::WIDE_LANES - 1) & ~(lib::WIDE_LANES - 1);
+}
+
+// ===============================================================================================================================
+// ======================================================= CONSTRUCTION ==========================================================
+// ===============================================================================================================================
+inline Plane plane_normalize(const lib::Vec4 p)
+{
+	f32 r_length = 1.0f / lib::length_vec(p.xyz);
+	return Plane{ p.xyz * r_length, p.w * r_length };
+}
+
+//? Gribb-Hartmann: clip = M * p, and -w <= x <= w etc. are planes made of rows of M. Depth range is [0, 1] like
+//? "Viewport" (D3D), so near plane is z >= 0. Works for any view-projection (perspective or orthographic), model matrix
+//? can be included to get planes in object space
+inline Frustum frustum_from_matrix(const lib::Mat4 &view_projection)
+{
+	lib::Mat4 rows = lib::transpose(view_projection);
+	const lib::Vec4 &x = rows.vecs[0], &y = rows.vecs[1], &z = rows.vecs[2], &w = rows.vecs[3];
+
+	Frustum out;
+	out.planes[FRUSTUM_LEFT] = plane_normalize(w + x);
+	out.planes[FRUSTUM_RIGHT] = plane_normalize(w - x);
+	out.planes[FRUSTUM_BOTTOM] = plane_normalize(w + y);
+	out.planes[FRUSTUM_TOP] = plane_normalize(w - y);
+	out.planes[FRUSTUM_NEAR] = plane_normalize(z);
+	out.planes[FRUSTUM_FAR] = plane_normalize(w - z);
+	return out;
+}
+
+inline AABB aabb_from_min_max(const lib::Vec3 min, const lib::Vec3 max)
+{
+	return AABB{ 0.5f * (min + max), 0.5f * (max - min) };
+}
+
+//? AABB around transformed AABB (Arvo): extent of the result is |M| * extent, with |M| the absolute upper 3x3
+inline AABB aabb_transform(const lib::Trans4 &a, const AABB &box)
+{
+	lib::Vec3 extent{};
+	for (s32 c = 0; c < 3; ++c)
+	{
+		extent.x += lib::abs(a.e[c][0]) * box.extent[c];
+		extent.y += lib::abs(a.e[c][1]) * box.extent[c];
+		extent.z += lib::abs(a.e[c][2]) * box.extent[c];
+	}
+	return AABB{ lib::mul_point(a, box.center), extent };
+}
+
+//? Exact bound of transformed box, tighter than "aabb_transform" for rotated objects
+inline OBB obb_from_aabb(const lib::Trans4 &a, const AABB &box)
+{
+	OBB out;
+	out.center = lib::mul_point(a, box.center);
+	out.axes[0] = lib::mul_vec(a, lib::Vec3{ box.extent.x, 0.0f, 0.0f });
+	out.axes[1] = lib::mul_vec(a, lib::Vec3{ 0.0f, box.extent.y, 0.0f });
+	out.axes[2] = lib::mul_vec(a, lib::Vec3{ 0.0f, 0.0f, box.extent.z });
+	return out;
+}
+
+// ===============================================================================================================================
+// ========================================================== SCALAR =============================================================
+// ===============================================================================================================================
+//? Signed distance "s" of the center against "r", radius of the bound projected onto plane normal:
+//? s < -r outside, s < r crossing, inside otherwise
+template <typename Radius>
+inline Cull_Result cull_classify(const Frustum &frustum, const lib::Vec3 center, const Radius &projected_radius)
+{
+	Cull_Result out = Cull_Result::Inside;
+	for (u32 i = 0; i < FRUSTUM_PLANE_COUNT; ++i)
+	{
+		const Plane &plane = frustum.planes[i];
+		f32 s = lib::dot(plane.normal, center) + plane.d;
+		f32 r = projected_radius(plane.normal);
+		if (s < -r)
+			return Cull_Result::Outside;
+		if (s < r)
+			out = Cull_Result::Intersecting;
+	}
+	return out;
+}
+
+inline Cull_Result frustum_classify(const Frustum &frustum, const Sphere &sphere)
+{
+	return cull_classify(frustum, sphere.center, [&](lib::Vec3) { return sphere.radius; });
+}
+
+inline Cull_Result frustum_classify(const Frustum &frustum, const AABB &box)
+{
+	return cull_classify(frustum, box.center, [&](lib::Vec3 n)
+	{
+		return lib::abs(n.x) * box.extent.x + lib::abs(n.y) * box.extent.y + lib::abs(n.z) * box.extent.z;
+	});
+}
+
+inline Cull_Result frustum_classify(const Frustum &frustum, const OBB &box)
+{
+	return cull_classify(frustum, box.center, [&](lib::Vec3 n)
+	{
+		return lib::abs(lib::dot(n, box.axes[0])) + lib::abs(lib::dot(n, box.axes[1])) + lib::abs(lib::dot(n, box.axes[2]));
+	});
+}
+
+CPU_TARGET_AVX2_BEGIN
+// ===============================================================================================================================
+// ======================================================== INTERNALS ============================================================
+// ===============================================================================================================================
+//? Every plane broadcast into all lanes once per batch
+struct Frustum_Wide
+{
+	lib::Vec3x8 normal[FRUSTUM_PLANE_COUNT];
+	__m256 d[FRUSTUM_PLANE_COUNT];
+};
+
+inline Frustum_Wide frustum_broadcast(const Frustum &frustum)
+{
+	Frustum_Wide out;
+	for (u32 i = 0; i < FRUSTUM_PLANE_COUNT; ++i)
+	{
+		out.normal[i] = lib::splat(frustum.planes[i].normal);
+		out.d[i] = lib::splat(frustum.planes[i].d);
+	}
+	return out;
+}
+
+//? Entry "bits" holds, byte by byte, lanes of set bits of "bits" packed to the front. Widened to 8 x u32 it is
+//? the permutation that moves visible indices together (a table instead of BMI2 pdep/pext, which is microcoded
+//? on older AMD cores)
+struct Cull_Compact_Table
+{
+	u64 lanes[256];
+};
+
+constexpr Cull_Compact_Table CULL_COMPACT_TABLE = []
+{
+	Cull_Compact_Table out{};
+	for (u32 bits = 0; bits < 256; ++bits)
+	{
+		u32 count = 0;
+		for (u32 lane = 0; lane < 8; ++lane)
+		{
+			if (bits & (1u << lane))
+				out.lanes[bits] |= (u64)lane << (8 * count++);
+		}
+	}
+	return out;
+}();
+
+//? Writes indices "base + lane" of set bits of "bits" to "out" (always 8 stores), returns how many are valid
+inline u32 cull_compact(u32 *out, const u32 base, const u32 bits)
+{
+	__m256i lanes = _mm256_cvtepu8_epi32(_mm_cvtsi64_si128((s64)CULL_COMPACT_TABLE.lanes[bits]));
+	_mm256_storeu_si256((__m256i *)out, _mm256_add_epi32(lanes, _mm256_set1_epi32((s32)base)));
+	return (u32)_mm_popcnt_u32(bits);
+}
+
+//? "is_outside(i, mask, access)" gives all-ones lanes for bounds "i".."i + 7" that are outside of a plane
+template <typename Outside>
+inline u32 cull_batch_loop(u32 count, u32 *visible, const Outside &is_outside)
+{
+	u32 visible_count = 0;
+	u32 i = 0;
+	__m256 full = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+	for (; i + lib::WIDE_LANES <= count; i += lib::WIDE_LANES)
+	{
+		u32 bits = ~(u32)_mm256_movemask_ps(is_outside(i, full, Vertex_Access::Cached)) & 0xFF;
+		visible_count += cull_compact(visible + visible_count, i, bits);
+	}
+
+	if (i < count)
+	{
+		__m256 mask = lib::lane_mask(count - i);
+		u32 bits = ~(u32)_mm256_movemask_ps(is_outside(i, mask, Vertex_Access::Masked)) & (u32)_mm256_movemask_ps(mask);
+		visible_count += cull_compact(visible + visible_count, i, bits);
+	}
+	return visible_count;
+}
+
+//? Lanes where signed distance of "center" is below -"radius" for at least one plane, "radius(plane)" is
+//? the bound projected onto plane normal
+template <typename Radius>
+inline __m256 cull_outside_any(const Frustum_Wide &frustum, const lib::Vec3x8 center, const Radius &radius)
+{
+	__m256 outside = _mm256_setzero_ps();
+	for (u32 i = 0; i < FRUSTUM_PLANE_COUNT; ++i)
+	{
+		__m256 s = _mm256_add_ps(lib::dot(frustum.normal[i], center), frustum.d[i]);
+		__m256 r = radius(i);
+		outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(s, r), _mm256_setzero_ps(), _CMP_LT_OQ));
+	}
+	return outside;
+}
+
+inline __m256 cull_load(const f32 *p, u32 i, __m256 mask, Vertex_Access access)
+{
+	return access == Vertex_Access::Masked ? _mm256_maskload_ps(p + i, _mm256_castps_si256(mask)) : _mm256_loadu_ps(p + i);
+}
+
+// ===============================================================================================================================
+// ========================================================= BATCHES =============================================================
+// ===============================================================================================================================
+//? Each writes indices of visible bounds (in increasing order) to "visible" and returns how many there are.
+//? Functions work on a range only, chunks of a stream can be culled by different threads into separate lists
+
+inline u32 frustum_cull(const Frustum &frustum, const Sphere_Stream &spheres, u32 count, u32 *visible)
+{
+	Frustum_Wide planes = frustum_broadcast(frustum);
+	return cull_batch_loop(count, visible, [&](u32 i, __m256 mask, Vertex_Access access)
+	{
+		lib::Vec3x8 center = vertex_load(spheres.center, i, mask, access);
+		__m256 radius = cull_load(spheres.radius, i, mask, access);
+		return cull_outside_any(planes, center, [&](u32) { return radius; });
+	});
+}
+
+inline u32 frustum_cull(const Frustum &frustum, const AABB_Stream &boxes, u32 count, u32 *visible)
+{
+	Frustum_Wide planes = frustum_broadcast(frustum);
+	lib::Vec3x8 abs_normal[FRUSTUM_PLANE_COUNT];
+	for (u32 p = 0; p < FRUSTUM_PLANE_COUNT; ++p)
+		abs_normal[p] = lib::splat(lib::Vec3{ lib::abs(frustum.planes[p].normal.x), lib::abs(frustum.planes[p].normal.y),
+		                                      lib::abs(frustum.planes[p].normal.z) });
+
+	return cull_batch_loop(count, visible, [&](u32 i, __m256 mask, Vertex_Access access)
+	{
+		lib::Vec3x8 center = vertex_load(boxes.center, i, mask, access);
+		lib::Vec3x8 extent = vertex_load(boxes.extent, i, mask, access);
+		return cull_outside_any(planes, center, [&](u32 p) { return lib::dot(abs_normal[p], extent); });
+	});
+}
+
+inline u32 frustum_cull(const Frustum &frustum, const OBB_Stream &boxes, u32 count, u32 *visible)
+{
+	Frustum_Wide planes = frustum_broadcast(frustum);
+	return cull_batch_loop(count, visible, [&](u32 i, __m256 mask, Vertex_Access access)
+	{
+		lib::Vec3x8 center = vertex_load(boxes.center, i, mask, access);
+		lib::Vec3x8 axis_0 = vertex_load(boxes.axes[0], i, mask, access);
+		lib::Vec3x8 axis_1 = vertex_load(boxes.axes[1], i, mask, access);
+		lib::Vec3x8 axis_2 = vertex_load(boxes.axes[2], i, mask, access);
+		return cull_outside_any(planes, center, [&](u32 p)
+		{
+			const lib::Vec3x8 &n = planes.normal[p];
+			return _mm256_add_ps(_mm256_add_ps(lib::abs(lib::dot(n, axis_0)), lib::abs(lib::dot(n, axis_1))), lib::abs(lib::dot(n, axis_2)));
+		});
+	});
+}
+CPU_TARGET_END
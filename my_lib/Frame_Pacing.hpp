@@ -0,0 +1,131 @@
+#pragma once
+//? -----------------------------------------------------------------------------------------------
+//? FRAME PACING AND FRAME TIME STATISTICS, PLATFORM INDEPENDENT PART.
+//? PLATFORM SLEEPS COARSELY FOR "frame_pacer_sleep_budget" AND SPINS THE REST OF THE FRAME, EVERY SLEEP IS
+//? FED BACK WITH "frame_pacer_record_sleep" SO THE SPIN MARGIN FOLLOWS REAL SCHEDULER OVERSLEEP OF THE MACHINE.
+//? FRAME TIMES GO INTO A RING OF LAST FRAME_STATS_CAPACITY FRAMES, REPORTED AS MIN/AVG/PERCENTILES/MAX.
+//? -----------------------------------------------------------------------------------------------
+
+#include "Utils.hpp"
+#include "Math.hpp"
+
+constexpr u32 FRAME_STATS_CAPACITY = 1024;
+
+struct Frame_Pacer
+{
+	f64 target_s; // 0 disables pacing
+
+	// Oversleep (actual - requested sleep) is tracked as exponential moving mean and variance,
+	// spin margin is mean + 3 standard deviations of it
+	f64 oversleep_mean_s;
+	f64 oversleep_variance_s;
+	f64 oversleep_max_s;
+	f64 spin_margin_s;
+	u64 sleep_count;
+	u64 missed_count; // frames that were already late before any waiting
+};
+
+struct Frame_Time_Stats
+{
+	f32 samples_ms[FRAME_STATS_CAPACITY];
+	u32 count;
+	u32 next;
+};
+
+struct Frame_Time_Report
+{
+	u32 sample_count;
+	f32 min_ms;
+	f32 avg_ms;
+	f32 p50_ms;
+	f32 p95_ms;
+	f32 p99_ms;
+	f32 max_ms;
+};
+
+//? "initial_margin_s" is used until the first few sleeps are measured, e.g. 2ms for Windows with 1ms timer period
+inline Frame_Pacer frame_pacer_create(f64 target_fps, f64 initial_margin_s)
+{
+	Frame_Pacer out{};
+	out.target_s = target_fps > 0.0 ? 1.0 / target_fps : 0.0;
+	out.oversleep_mean_s = initial_margin_s;
+	out.spin_margin_s = initial_margin_s;
+	return out;
+}
+
+//? How long platform should sleep with its coarse OS sleep, "remaining_s" is time left until the frame deadline
+inline f64 frame_pacer_sleep_budget(Frame_Pacer *pacer, f64 remaining_s)
+{
+	if (remaining_s <= 0.0)
+	{
+		pacer->missed_count++;
+		return 0.0;
+	}
+	return lib::max(remaining_s - pacer->spin_margin_s, 0.0);
+}
+
+inline void frame_pacer_record_sleep(Frame_Pacer *pacer, f64 requested_s, f64 actual_s)
+{
+	constexpr f64 weight = 1.0 / 16.0;
+	f64 oversleep = actual_s - requested_s;
+	f64 delta = oversleep - pacer->oversleep_mean_s;
+
+	pacer->oversleep_mean_s += weight * delta;
+	pacer->oversleep_variance_s = (1.0 - weight) * (pacer->oversleep_variance_s + weight * delta * delta);
+	pacer->oversleep_max_s = lib::max(pacer->oversleep_max_s, oversleep);
+	pacer->sleep_count++;
+
+	f64 margin = pacer->oversleep_mean_s + 3.0 * (f64)lib::sqrt((f32)pacer->oversleep_variance_s);
+	pacer->spin_margin_s = lib::clamp(margin, 0.00005, pacer->target_s * 0.5);
+}
+
+inline void frame_stats_push(Frame_Time_Stats *stats, f32 frame_ms)
+{
+	stats->samples_ms[stats->next] = frame_ms;
+	stats->next = (stats->next + 1) % FRAME_STATS_CAPACITY;
+	stats->count = lib::min(stats->count + 1, FRAME_STATS_CAPACITY);
+}
+
+//? Nearest-rank percentiles over the ring, sorts a copy (shell sort, few microseconds for full ring)
+inline Frame_Time_Report frame_stats_report(const Frame_Time_Stats *stats)
+{
+	Frame_Time_Report out{};
+	out.sample_count = stats->count;
+	if (stats->count == 0)
+		return out;
+
+	f32 sorted[FRAME_STATS_CAPACITY];
+	f64 sum = 0.0;
+	for (u32 i = 0; i < stats->count; ++i)
+	{
+		sorted[i] = stats->samples_ms[i];
+		sum += sorted[i];
+	}
+
+	constexpr u32 gaps[] = { 701, 301, 132, 57, 23, 10, 4, 1 };
+	for (u32 gap : gaps)
+	{
+		for (u32 i = gap; i < stats->count; ++i)
+		{
+			f32 value = sorted[i];
+			u32 j = i;
+			for (; j >= gap && sorted[j - gap] > value; j -= gap)
+				sorted[j] = sorted[j - gap];
+			sorted[j] = value;
+		}
+	}
+
+	auto percentile = [&](f64 p)
+	{
+		u32 rank = (u32)lib::ceil((f32)(p * stats->count));
+		return sorted[lib::clamp(rank, 1u, stats->count) - 1];
+	};
+
+	out.min_ms = sorted[0];
+	out.max_ms = sorted[stats->count - 1];
+	out.avg_ms = (f32)(sum / stats->count);
+	out.p50_ms = percentile(0.50);
+	out.p95_ms = percentile(0.95);
+	out.p99_ms = percentile(0.99);
+	return out;
+}
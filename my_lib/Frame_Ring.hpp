@@ -0,0 +1,201 @@
+#pragma once
+//? -----------------------------------------------------------------------------------------------
+//? FRAME RING: 2-3 CPU SIDE FRAMEBUFFERS AND A DEDICATED PRESENT THREAD.
+//? MAIN THREAD RENDERS FRAME N+1 INTO A FREE SLOT WHILE PRESENT THREAD STREAMS FRAME N INTO THE PRESENT
+//? TARGET (MAPPED GPU MEMORY ON WIN32), SO RENDERING NEVER READS NOR WRITES WRITE-COMBINED MEMORY AND
+//? THE COPY IS A SEPARATE PIPELINE STAGE INSTEAD OF A SERIAL STEP AT THE END OF EVERY FRAME.
+//? -----------------------------------------------------------------------------------------------
+
+//? Slots are used strictly in order, "submitted" and "presented" are monotonic frame counters:
+//? slot (submitted % count) is free once "submitted - presented < count". Producer is a single thread,
+//? consumer is the present thread, both block on atomic wait so nobody spins while the other side works
+
+// Utils.hpp "internal" macro collides with identifiers inside of standard headers
+#pragma push_macro("internal")
+#undef internal
+#include <atomic>
+#include <thread>
+#pragma pop_macro("internal")
+
+#include <cassert>
+#include <immintrin.h>
+
+#include "Utils.hpp"
+#include "Tiled_Surface.hpp"
+#include "Profiler.hpp"
+
+constexpr u32 FRAME_RING_MAX_SLOTS = 3;
+
+struct Frame_Ring_Slot
+{
+	u32 *pixels;
+	u32 width;
+	u32 height;
+	u32 pitch; // bytes, only for linear slots
+	b32 is_tiled; // layout of "Tiled_Surface.hpp"
+	u64 frame_index;
+};
+
+//? Called on present thread for every submitted frame, in submission order
+using Frame_Present_Function = void (*)(void *user_data, const Frame_Ring_Slot *slot);
+
+struct Frame_Ring
+{
+	Frame_Ring_Slot slots[FRAME_RING_MAX_SLOTS];
+	u32 slot_count;
+
+	Frame_Present_Function present;
+	void *user_data;
+	std::thread thread;
+
+	alignas(64) std::atomic<u64> submitted;
+	std::atomic<u32> present_wake; // bumped on submit and on destroy, present thread parks on it
+	std::atomic<b32> is_quitting;
+	alignas(64) std::atomic<u64> presented;
+};
+
+//? Non-temporal copy of pitched pixel rows, destination lines are never pulled into cache,
+//? which is exactly what write-combined (mapped upload) memory wants.
+//? Baseline SSE, 16B streaming stores fill write-combining buffers just as well as wider ones
+inline void frame_stream_copy(u32 *dst, u32 dst_pitch, const u32 *src, u32 src_pitch, u32 width, u32 height)
+{
+	for (u32 y = 0; y < height; ++y)
+	{
+		u32 *dst_row = (u32 *)((byte *)dst + (u64)y * dst_pitch);
+		const u32 *src_row = (const u32 *)((const byte *)src + (u64)y * src_pitch);
+
+		u32 x = 0;
+		for (; x < width && ((u64)(dst_row + x) & 15); ++x)
+			_mm_stream_si32((int *)(dst_row + x), (int)src_row[x]);
+
+		// One cache line per iteration
+		for (; x + 16 <= width; x += 16)
+		{
+			__m128i a = _mm_loadu_si128((const __m128i *)(src_row + x));
+			__m128i b = _mm_loadu_si128((const __m128i *)(src_row + x + 4));
+			__m128i c = _mm_loadu_si128((const __m128i *)(src_row + x + 8));
+			__m128i d = _mm_loadu_si128((const __m128i *)(src_row + x + 12));
+			_mm_stream_si128((__m128i *)(dst_row + x), a);
+			_mm_stream_si128((__m128i *)(dst_row + x + 4), b);
+			_mm_stream_si128((__m128i *)(dst_row + x + 8), c);
+			_mm_stream_si128((__m128i *)(dst_row + x + 12), d);
+		}
+		for (; x + 4 <= width; x += 4)
+			_mm_stream_si128((__m128i *)(dst_row + x), _mm_loadu_si128((const __m128i *)(src_row + x)));
+
+		for (; x < width; ++x)
+			_mm_stream_si32((int *)(dst_row + x), (int)src_row[x]);
+	}
+	_mm_sfence();
+}
+
+inline void frame_ring_present_main(Frame_Ring *ring)
+{
+	profiler_register_thread("Present");
+	for (;;)
+	{
+		u32 wake = ring->present_wake.load(std::memory_order_acquire);
+		u64 presented = ring->presented.load(std::memory_order_relaxed);
+		u64 submitted = ring->submitted.load(std::memory_order_acquire);
+		if (presented == submitted)
+		{
+			// Drain everything that was submitted before quitting
+			if (ring->is_quitting.load(std::memory_order_acquire))
+				break;
+			ring->present_wake.wait(wake, std::memory_order_acquire);
+			continue;
+		}
+
+		{
+			ProfileScope("Present");
+			ring->present(ring->user_data, &ring->slots[presented % ring->slot_count]);
+		}
+		ring->presented.store(presented + 1, std::memory_order_release);
+		ring->presented.notify_all();
+	}
+}
+
+//? Slot buffers are owned by caller and must be bound with "frame_ring_bind_slot" before first acquire
+inline void frame_ring_create(Frame_Ring *ring, u32 slot_count, Frame_Present_Function present, void *user_data)
+{
+	assert(slot_count >= 2 && slot_count <= FRAME_RING_MAX_SLOTS && "Ring needs 2 or 3 slots to overlap anything");
+	ring->slot_count = slot_count;
+	ring->present = present;
+	ring->user_data = user_data;
+	ring->submitted.store(0);
+	ring->present_wake.store(0);
+	ring->presented.store(0);
+	ring->is_quitting.store(false);
+	for (u32 i = 0; i < FRAME_RING_MAX_SLOTS; ++i)
+		ring->slots[i] = {};
+
+	ring->thread = std::thread(frame_ring_present_main, ring);
+}
+
+//? Blocks until present thread has consumed every submitted frame, after that all slots and
+//? everything touched by present callback may be changed (e.g. on resize)
+inline void frame_ring_flush(Frame_Ring *ring)
+{
+	u64 submitted = ring->submitted.load(std::memory_order_relaxed);
+	for (u64 presented = ring->presented.load(std::memory_order_acquire); presented != submitted;
+	     presented = ring->presented.load(std::memory_order_acquire))
+	{
+		ring->presented.wait(presented, std::memory_order_acquire);
+	}
+}
+
+//? Only valid when ring is flushed
+inline void frame_ring_bind_slot(Frame_Ring *ring, u32 slot_id, u32 *pixels, u32 width, u32 height, u32 pitch, b32 is_tiled)
+{
+	assert(slot_id < ring->slot_count);
+	assert(ring->presented.load() == ring->submitted.load() && "Slots are still in flight, flush ring first");
+	ring->slots[slot_id] = { pixels, width, height, pitch, is_tiled, 0 };
+}
+
+//? Bytes of slot memory needed for given layout
+inline u64 frame_ring_slot_size(u32 width, u32 height, u32 pitch, b32 is_tiled)
+{
+	return is_tiled ? tiled_texel_count(width, height) * sizeof(u32) : (u64)pitch * height;
+}
+
+//? Present stage helper: streams slot of any layout into pitched linear destination
+inline void frame_ring_stream_slot(u32 *dst, u32 dst_pitch, const Frame_Ring_Slot *slot)
+{
+	if (slot->is_tiled)
+		tiled_detile_stream(dst, dst_pitch, slot->pixels, slot->width, slot->height);
+	else
+		frame_stream_copy(dst, dst_pitch, slot->pixels, slot->pitch, slot->width, slot->height);
+}
+
+//? Next slot to render into, blocks while present thread is still "slot_count" frames behind
+inline Frame_Ring_Slot *frame_ring_acquire(Frame_Ring *ring)
+{
+	u64 submitted = ring->submitted.load(std::memory_order_relaxed);
+	for (u64 presented = ring->presented.load(std::memory_order_acquire); submitted - presented >= ring->slot_count;
+	     presented = ring->presented.load(std::memory_order_acquire))
+	{
+		ring->presented.wait(presented, std::memory_order_acquire);
+	}
+
+	Frame_Ring_Slot *slot = &ring->slots[submitted % ring->slot_count];
+	slot->frame_index = submitted;
+	return slot;
+}
+
+//? Hands the last acquired slot to present thread
+inline void frame_ring_submit(Frame_Ring *ring)
+{
+	ring->submitted.fetch_add(1, std::memory_order_release);
+	ring->present_wake.fetch_add(1, std::memory_order_release);
+	ring->present_wake.notify_one();
+}
+
+//? Presents everything that is still in flight and joins present thread
+inline void frame_ring_destroy(Frame_Ring *ring)
+{
+	ring->is_quitting.store(true, std::memory_order_release);
+	ring->present_wake.fetch_add(1, std::memory_order_release);
+	ring->present_wake.notify_one();
+	if (ring->thread.joinable())
+		ring->thread.join();
+}
@@ -1,4 +1,5 @@
 #pragma once
+#if defined(_WIN32)
 #include <corecrt.h>
 
 _CRT_BEGIN_C_HEADER
@@ -20,7 +21,35 @@ _ACRTIMP void __cdecl _wassert(
 		(_wassert(_CRT_WIDE(#expression), _CRT_WIDE(__FILE__), (unsigned)(__LINE__)), 0) \
 	)
 #else
-#define GameAssert(expression) ((void)0)	
+#define GameAssert(expression) ((void)0)
 #endif
 
-_CRT_END_C_HEADER
\ No newline at end of file
+_CRT_END_C_HEADER
+
+#else
+#include <stdio.h>
+#include <stdlib.h>
+
+//? POSIX counterpart of "_wassert", reports and aborts also in release builds
+[[noreturn]] inline void posix_assert(const char *message, const char *file, unsigned line)
+{
+	fprintf(stderr, "Assertion failed: %s, file %s, line %u\n", message, file, line);
+	fflush(stderr);
+	abort();
+}
+
+#define AlwaysAssert(expression) (void)( \
+		(!!(expression)) || \
+		(posix_assert(#expression, __FILE__, (unsigned)(__LINE__)), 0) \
+	)
+
+#if Game_ASSERTIONS
+#define GameAssert(expression) (void)( \
+		(!!(expression)) || \
+		(posix_assert(#expression, __FILE__, (unsigned)(__LINE__)), 0) \
+	)
+#else
+#define GameAssert(expression) ((void)0)
+#endif
+
+#endif
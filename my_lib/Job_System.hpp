@@ -0,0 +1,333 @@
+#pragma once
+//? -----------------------------------------------------------------------------------------------
+//? WORK-STEALING JOB SYSTEM: PERSISTENT WORKER POOL CREATED ONCE, EVERY WORKER OWNS A CHASE-LEV DEQUE.
+//? OWNER PUSHES/POPS AT THE BOTTOM (LIFO, CACHE HOT), IDLE WORKERS STEAL FROM THE TOP (FIFO, BIGGEST WORK).
+//? THE THREAD THAT CREATES THE SYSTEM IS WORKER 0 AND HELPS EXECUTING JOBS WHILE WAITING FOR COUNTERS.
+//? IDLE WORKERS SPIN FOR A WHILE AND THEN PARK ON AN ATOMIC (FUTEX/WAITONADDRESS), SO THEY COST NOTHING
+//? BETWEEN FRAMES BUT ARE STILL AVAILABLE WITHIN MICROSECONDS DURING A FRAME.
+//? -----------------------------------------------------------------------------------------------
+
+//? Jobs are plain function + data + range, completion is tracked by "Job_Counter" that is decremented when job ends,
+//? waiting on a counter is how dependencies are expressed. Range jobs split themselves in halves down to "grain",
+//? pushing the other half each time, which gives fork-join "parallel_for" with good stealing balance
+
+// Utils.hpp "internal" macro collides with identifiers inside of standard headers
+#pragma push_macro("internal")
+#undef internal
+#include <atomic>
+#include <thread>
+#include <new>
+#pragma pop_macro("internal")
+
+#include <cassert>
+#include <immintrin.h>
+
+#include "Utils.hpp"
+#include "Profiler.hpp"
+
+constexpr u32 JOB_MAX_WORKERS = 256;
+constexpr s64 JOB_DEQUE_CAPACITY = 4096; // must be power of 2
+constexpr u32 JOB_SPIN_COUNT = 2048;     // failed steal rounds before worker parks
+
+struct Job_System;
+using Job_Function = void (*)(Job_System *system, void *data, u32 begin, u32 end, u32 worker_id);
+
+struct Job_Counter
+{
+	std::atomic<s32> pending;
+};
+
+struct Job
+{
+	const char *name; // profiler zone of the job, string literal
+	Job_Function function;
+	void *data;
+	Job_Counter *counter;
+	u32 begin;
+	u32 end;
+	u32 grain; // 0 executes [begin, end) at once, otherwise job keeps splitting until range is not bigger than grain
+};
+
+struct Job_Deque
+{
+	alignas(64) std::atomic<s64> top;
+	alignas(64) std::atomic<s64> bottom;
+	Job *jobs; // ring of JOB_DEQUE_CAPACITY
+};
+
+struct alignas(64) Job_Worker
+{
+	Job_Deque deque;
+	Job_System *system;
+	std::thread thread;
+	u32 id;
+	u32 random_state;
+
+	u64 jobs_executed;
+	u64 jobs_stolen;
+	u64 parks;
+};
+
+struct Job_System
+{
+	u32 worker_count; // including worker 0 (creating thread)
+	Job_Worker *workers;
+
+	alignas(64) std::atomic<u32> wake_epoch;
+	alignas(64) std::atomic<u32> sleeping_count;
+	std::atomic<b32> is_quitting;
+};
+
+// ===============================================================================================================================
+// ====================================================== CHASE-LEV DEQUE ========================================================
+// ===============================================================================================================================
+//? Owner only, returns false when deque is full
+inline b32 job_deque_push(Job_Deque *deque, const Job &job)
+{
+	s64 bottom = deque->bottom.load(std::memory_order_relaxed);
+	s64 top = deque->top.load(std::memory_order_acquire);
+	if (bottom - top >= JOB_DEQUE_CAPACITY)
+		return false;
+
+	deque->jobs[bottom & (JOB_DEQUE_CAPACITY - 1)] = job;
+	std::atomic_thread_fence(std::memory_order_release);
+	deque->bottom.store(bottom + 1, std::memory_order_relaxed);
+	return true;
+}
+
+//? Owner only
+inline b32 job_deque_pop(Job_Deque *deque, Job *out)
+{
+	s64 bottom = deque->bottom.load(std::memory_order_relaxed) - 1;
+	deque->bottom.store(bottom, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	s64 top = deque->top.load(std::memory_order_relaxed);
+
+	if (top > bottom)
+	{
+		deque->bottom.store(bottom + 1, std::memory_order_relaxed);
+		return false;
+	}
+
+	*out = deque->jobs[bottom & (JOB_DEQUE_CAPACITY - 1)];
+	if (top == bottom)
+	{
+		// Last job, race against thieves for it
+		b32 won = deque->top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+		deque->bottom.store(bottom + 1, std::memory_order_relaxed);
+		return won;
+	}
+	return true;
+}
+
+//? Any thread
+inline b32 job_deque_steal(Job_Deque *deque, Job *out)
+{
+	s64 top = deque->top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	s64 bottom = deque->bottom.load(std::memory_order_acquire);
+	if (top >= bottom)
+		return false;
+
+	*out = deque->jobs[top & (JOB_DEQUE_CAPACITY - 1)];
+	return deque->top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+}
+
+// ===============================================================================================================================
+// ======================================================= SCHEDULING ============================================================
+// ===============================================================================================================================
+inline b32 job_try_get(Job_System *system, u32 worker_id, Job *out)
+{
+	Job_Worker *self = &system->workers[worker_id];
+	if (job_deque_pop(&self->deque, out))
+		return true;
+
+	// Random first victim, then round robin through everyone else
+	self->random_state ^= self->random_state << 13;
+	self->random_state ^= self->random_state >> 17;
+	self->random_state ^= self->random_state << 5;
+	u32 first = self->random_state % system->worker_count;
+	for (u32 i = 0; i < system->worker_count; ++i)
+	{
+		u32 victim = (first + i) % system->worker_count;
+		if (victim != worker_id && job_deque_steal(&system->workers[victim].deque, out))
+		{
+			self->jobs_stolen++;
+			return true;
+		}
+	}
+	return false;
+}
+
+inline void job_wake_sleepers(Job_System *system)
+{
+	// Pairs with "sleeping_count" increment of parking worker, one of both sides always sees the other
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (system->sleeping_count.load(std::memory_order_seq_cst) > 0)
+	{
+		system->wake_epoch.fetch_add(1, std::memory_order_seq_cst);
+		system->wake_epoch.notify_all();
+	}
+}
+
+inline void job_execute(Job_System *system, Job job, u32 worker_id);
+
+//? Pushes to deque of calling worker, when it is full job is executed in place
+inline void job_push(Job_System *system, u32 worker_id, const Job &job)
+{
+	assert(worker_id < system->worker_count);
+	if (job.counter)
+		job.counter->pending.fetch_add(1, std::memory_order_relaxed);
+
+	if (job_deque_push(&system->workers[worker_id].deque, job))
+		job_wake_sleepers(system);
+	else
+		job_execute(system, job, worker_id);
+}
+
+inline void job_execute(Job_System *system, Job job, u32 worker_id)
+{
+	while (job.grain && job.end - job.begin > job.grain)
+	{
+		u32 middle = job.begin + (job.end - job.begin) / 2;
+		Job other_half = job;
+		other_half.begin = middle;
+		job.end = middle;
+		job_push(system, worker_id, other_half);
+	}
+
+	{
+		ProfileScope(job.name);
+		job.function(system, job.data, job.begin, job.end, worker_id);
+	}
+	system->workers[worker_id].jobs_executed++;
+
+	if (job.counter)
+		job.counter->pending.fetch_sub(1, std::memory_order_release);
+}
+
+//? Calling worker executes (own or stolen) jobs until counter reaches 0, it never blocks
+inline void job_wait(Job_System *system, Job_Counter *counter, u32 worker_id)
+{
+	while (counter->pending.load(std::memory_order_acquire) > 0)
+	{
+		Job job;
+		if (job_try_get(system, worker_id, &job))
+			job_execute(system, job, worker_id);
+		else
+			_mm_pause();
+	}
+}
+
+//? Fork-join over [begin, end), "func(chunk_begin, chunk_end, worker_id)" is called for chunks of at most "grain" elements,
+//? every chunk is a profiler zone called "name"
+template <typename F>
+inline void parallel_for(Job_System *system, u32 worker_id, const char *name, u32 begin, u32 end, u32 grain, const F &func)
+{
+	if (end <= begin)
+		return;
+
+	Job_Function trampoline = [](Job_System *, void *data, u32 chunk_begin, u32 chunk_end, u32 worker)
+	{
+		(*(const F *)data)(chunk_begin, chunk_end, worker);
+	};
+
+	Job_Counter counter{};
+	counter.pending.store(1, std::memory_order_relaxed);
+	Job job{ name, trampoline, (void *)&func, &counter, begin, end, grain ? grain : 1 };
+	job_execute(system, job, worker_id);
+	job_wait(system, &counter, worker_id);
+}
+
+// ===============================================================================================================================
+// ======================================================== LIFETIME =============================================================
+// ===============================================================================================================================
+inline void job_worker_main(Job_Worker *self)
+{
+	Job_System *system = self->system;
+	u32 failed_rounds = 0;
+
+	char thread_name[32];
+	snprintf(thread_name, sizeof(thread_name), "Worker %u", self->id);
+	profiler_register_thread(thread_name);
+
+	while (!system->is_quitting.load(std::memory_order_relaxed))
+	{
+		Job job;
+		if (job_try_get(system, self->id, &job))
+		{
+			job_execute(system, job, self->id);
+			failed_rounds = 0;
+			continue;
+		}
+
+		if (++failed_rounds < JOB_SPIN_COUNT)
+		{
+			// Occasional yield keeps spinning workers from starving the producer when cores are oversubscribed
+			if (failed_rounds % 64 == 0)
+				std::this_thread::yield();
+			else
+				_mm_pause();
+			continue;
+		}
+
+		// Park: epoch is read before announcing sleep, so a push after the last check always changes it
+		u32 epoch = system->wake_epoch.load(std::memory_order_seq_cst);
+		system->sleeping_count.fetch_add(1, std::memory_order_seq_cst);
+		b32 has_job = job_try_get(system, self->id, &job);
+		if (!has_job && !system->is_quitting.load(std::memory_order_seq_cst))
+		{
+			self->parks++;
+			system->wake_epoch.wait(epoch, std::memory_order_seq_cst);
+		}
+		system->sleeping_count.fetch_sub(1, std::memory_order_seq_cst);
+
+		if (has_job)
+			job_execute(system, job, self->id);
+		failed_rounds = 0;
+	}
+}
+
+//? Upper bound of what "job_system_create" allocates, including alignment padding
+inline u64 job_system_memory_size(u32 worker_count)
+{
+	return (u64)worker_count * (sizeof(Job_Worker) + sizeof(Job) * JOB_DEQUE_CAPACITY + 128) + 64;
+}
+
+//? "worker_count" includes calling thread, which becomes worker 0
+inline void job_system_create(Job_System *system, auto *allocator, u32 worker_count)
+{
+	assert(worker_count > 0 && worker_count <= JOB_MAX_WORKERS);
+	system->worker_count = worker_count;
+	system->workers = (Job_Worker *)allocate(allocator, sizeof(Job_Worker) * worker_count, alignof(Job_Worker));
+	system->wake_epoch.store(0);
+	system->sleeping_count.store(0);
+	system->is_quitting.store(false);
+
+	for (u32 i = 0; i < worker_count; ++i)
+	{
+		Job_Worker *worker = new (&system->workers[i]) Job_Worker{};
+		worker->deque.jobs = (Job *)allocate(allocator, sizeof(Job) * JOB_DEQUE_CAPACITY, 64);
+		worker->system = system;
+		worker->id = i;
+		worker->random_state = 0x9E3779B9u * (i + 1);
+	}
+
+	for (u32 i = 1; i < worker_count; ++i)
+		system->workers[i].thread = std::thread(job_worker_main, &system->workers[i]);
+}
+
+inline void job_system_destroy(Job_System *system)
+{
+	system->is_quitting.store(true, std::memory_order_seq_cst);
+	system->wake_epoch.fetch_add(1, std::memory_order_seq_cst);
+	system->wake_epoch.notify_all();
+
+	for (u32 i = 0; i < system->worker_count; ++i)
+	{
+		if (system->workers[i].thread.joinable())
+			system->workers[i].thread.join();
+		system->workers[i].~Job_Worker();
+	}
+	system->worker_count = 0;
+}
@@ -2,13 +2,13 @@
 #include <immintrin.h>
 #include <concepts>
 #include <cmath>
+#include <cassert>
 
 #include "Utils.hpp"
 
-//TODO: Mat4 basic operations: Basics, Det, Inverse (transform, basic, normal), Adjugate, Transpose, Unit
+//TODO: Mat4 basic operations: Basics, Unit
 //TODO: Mat4 CG operations: Look_At, Projection, Rotations, Scale, Ssin_tew, Translation, Normal M, Inverse normal M, 
 //TODO: Lerp, ceil, floor, round, trunc with vectors
-//TODO: quaternions (angle and other), quaternion to rotation mat4 (check insomniac paper), and mat4 to quaternion
 //TODO: Euler angles
 //TODO: keep adding SIMD where possible and makes sense
 //TODO: Exponent for integers and floats
@@ -60,7 +60,7 @@ namespace lib
 	template<be_number T>
 	constexpr T clamp(T val, T min, T max) 
 	{
-		constexpr T t = val < min ? min : val;
+		T t = val < min ? min : val;
 		return t > max ? max : t;
 	}
 
@@ -105,7 +105,7 @@ namespace lib
 	template<be_number T>
 	constexpr T remap_range(T in_min, T in_max, T out_min, T out_max, T val)
 	{
-		constexpr T temp = inv_lerp(in_min, in_max, val);
+		T temp = inv_lerp(in_min, in_max, val);
 		return lerp(out_min, out_max, temp);
 	}
 
@@ -464,25 +464,22 @@ namespace lib
 	{
 		struct
 		{
-			Vec3 xyz;
-			f32 w;
+			f32 x, y, z, w;
 		};
 
 		struct
 		{
-			f32 x, y, z, w;
+			f32 r, g, b, a;
 		};
 
 		struct
 		{
-			
-			Vec3 rgb;
-			f32 a;
+			Vec3 xyz;
 		};
 
-		struct 
+		struct
 		{
-			f32 r, g, b, a;
+			Vec3 rgb;
 		};
 		
 		f32 e[4];
@@ -800,9 +797,103 @@ namespace lib
 		return out;
 	}
 
-	inline Mat4 inverse(const Mat4 a)
+	//? General 4x4 inverse by 2x2 blocks, based on https://lxjk.github.io/2017/09/03/Fast-4x4-Matrix-Inverse-with-SSE-SIMD-Explained.html
+	//? M = | A B |  with 2x2 blocks stored as (m00, m10, m01, m11) - blocks are built from columns, and since inverse and
+	//?     | C D |  adjugate commute with transpose, column major storage needs no extra shuffles.
+	//? X# = |D|A - B(D#C), W# = |A|D - C(A#B), Y# = |B|C - D(A#B)#, Z# = |C|B - A(D#C)#,
+	//? |M| = |A||D| + |B||C| - tr((A#B)(D#C)), where # is adjugate and |.| determinant
+	inline __m128 mat2_mul(const __m128 a, const __m128 b)
+	{
+		return _mm_add_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 3, 0))),
+		                  _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+	}
+
+	//? (a#) * b
+	inline __m128 mat2_adj_mul(const __m128 a, const __m128 b)
+	{
+		return _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 3, 3)), b),
+		                  _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 1, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2))));
+	}
+
+	//? a * (b#)
+	inline __m128 mat2_mul_adj(const __m128 a, const __m128 b)
+	{
+		return _mm_sub_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 0, 3))),
+		                  _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+	}
+
+	//? Adjugate blocks X#, Y#, Z#, W# and determinant (in all lanes) of "a", see above
+	struct Mat4_Adjugate_Blocks
+	{
+		__m128 x, y, z, w;
+		__m128 det;
+	};
+
+	inline Mat4_Adjugate_Blocks mat4_adjugate_blocks(const Mat4 &a)
+	{
+		__m128 A = _mm_movelh_ps(a.columns[0], a.columns[1]);
+		__m128 B = _mm_movehl_ps(a.columns[1], a.columns[0]);
+		__m128 C = _mm_movelh_ps(a.columns[2], a.columns[3]);
+		__m128 D = _mm_movehl_ps(a.columns[3], a.columns[2]);
+
+		// (|A|, |B|, |C|, |D|)
+		__m128 det_sub = _mm_sub_ps(
+			_mm_mul_ps(_mm_shuffle_ps(a.columns[0], a.columns[2], _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(a.columns[1], a.columns[3], _MM_SHUFFLE(3, 1, 3, 1))),
+			_mm_mul_ps(_mm_shuffle_ps(a.columns[0], a.columns[2], _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(a.columns[1], a.columns[3], _MM_SHUFFLE(2, 0, 2, 0))));
+		__m128 det_a = _mm_shuffle_ps(det_sub, det_sub, _MM_SHUFFLE(0, 0, 0, 0));
+		__m128 det_b = _mm_shuffle_ps(det_sub, det_sub, _MM_SHUFFLE(1, 1, 1, 1));
+		__m128 det_c = _mm_shuffle_ps(det_sub, det_sub, _MM_SHUFFLE(2, 2, 2, 2));
+		__m128 det_d = _mm_shuffle_ps(det_sub, det_sub, _MM_SHUFFLE(3, 3, 3, 3));
+
+		__m128 d_c = mat2_adj_mul(D, C);
+		__m128 a_b = mat2_adj_mul(A, B);
+
+		Mat4_Adjugate_Blocks out;
+		out.x = _mm_sub_ps(_mm_mul_ps(det_d, A), mat2_mul(B, d_c));
+		out.w = _mm_sub_ps(_mm_mul_ps(det_a, D), mat2_mul(C, a_b));
+		out.y = _mm_sub_ps(_mm_mul_ps(det_b, C), mat2_mul_adj(D, a_b));
+		out.z = _mm_sub_ps(_mm_mul_ps(det_c, B), mat2_mul_adj(A, d_c));
+
+		__m128 tr = _mm_mul_ps(a_b, _mm_shuffle_ps(d_c, d_c, _MM_SHUFFLE(3, 1, 2, 0)));
+		tr = _mm_hadd_ps(tr, tr);
+		tr = _mm_hadd_ps(tr, tr);
+		out.det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(det_a, det_d), _mm_mul_ps(det_b, det_c)), tr);
+		return out;
+	}
+
+	//? Blocks times "scale" (sign of adjugate already folded into it) shuffled back into columns
+	inline Mat4 mat4_from_adjugate_blocks(const Mat4_Adjugate_Blocks &blocks, const __m128 scale)
+	{
+		__m128 x = _mm_mul_ps(blocks.x, scale);
+		__m128 y = _mm_mul_ps(blocks.y, scale);
+		__m128 z = _mm_mul_ps(blocks.z, scale);
+		__m128 w = _mm_mul_ps(blocks.w, scale);
+
+		Mat4 out;
+		out.columns[0] = _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3));
+		out.columns[1] = _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2));
+		out.columns[2] = _mm_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3));
+		out.columns[3] = _mm_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2));
+		return out;
+	}
+
+	inline f32 determinant(const Mat4 a)
+	{
+		return _mm_cvtss_f32(mat4_adjugate_blocks(a).det);
+	}
+
+	//? Transposed cofactor matrix, defined for singular matrices too (inverse * determinant otherwise)
+	inline Mat4 adjugate(const Mat4 a)
 	{
+		return mat4_from_adjugate_blocks(mat4_adjugate_blocks(a), _mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f));
+	}
 
+	//! Not checked for singular matrices (determinant 0 gives infinities), use "determinant" first when it may happen.
+	//? ~1e-6 relative error for well conditioned matrices, see "mat4 inverse" of lib_bench for measurements
+	inline Mat4 inverse(const Mat4 a)
+	{
+		Mat4_Adjugate_Blocks blocks = mat4_adjugate_blocks(a);
+		return mat4_from_adjugate_blocks(blocks, _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), blocks.det));
 	}
 
 	struct Trans4 : Mat4
@@ -844,6 +935,23 @@ namespace lib
 		return { out.x, out.y, out.z };
 	}
 
+	//? Inverse-transpose of the upper 3x3, what normals need under non-uniform scale and shear, translation is dropped.
+	//? Cofactor columns are crosses of the other two columns, so it is 3 crosses + 1 dot and a division
+	//? instead of full "inverse" + "transpose"
+	inline Trans4 normal_matrix(const Trans4 a)
+	{
+		Trans4 out{};
+		out.vecs[0] = cross(a.vecs[1], a.vecs[2]);
+		out.vecs[1] = cross(a.vecs[2], a.vecs[0]);
+		out.vecs[2] = cross(a.vecs[0], a.vecs[1]);
+		__m128 r_det = _mm_set_ps1(1.0f / dot(a.vecs[0], out.vecs[0]));
+		out.columns[0] = _mm_mul_ps(out.columns[0], r_det);
+		out.columns[1] = _mm_mul_ps(out.columns[1], r_det);
+		out.columns[2] = _mm_mul_ps(out.columns[2], r_det);
+		out.columns[3] = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+		return out;
+	}
+
 	//? "cutted" linear combination for first 3 columns cause bottom element is 0
 	inline Trans4 operator*(const Trans4 a, const Trans4 b)
 	{
@@ -882,14 +990,14 @@ namespace lib
 	//? Basically divide each column axis by its length squared then transpose, in implemnetation transpose is done first to have
 	//? data already prepared for SIMD dots for length calculation. 
 	//! Removed divide by 0 check of original implementation, YOLO
-	//! This may not work for transforms with shear, skew TEST!
+	//! Rotation + scale (+ translation) only, for shear/skew use "inverse((Mat4)a)"
 	inline Trans4 inverse(const Trans4 a)
 	{
 		Trans4 out{};
 
 		// transpose 3x3
 		__m128 t0 = _mm_movelh_ps(a.columns[0], a.columns[1]);
-		__m128 t1 = _mm_movehl_ps(a.columns[0], a.columns[1]);
+		__m128 t1 = _mm_movehl_ps(a.columns[1], a.columns[0]);
 		out.columns[0] = _mm_shuffle_ps(t0, a.columns[2], _MM_SHUFFLE( 3,0,2,0 ) );
 		out.columns[1] = _mm_shuffle_ps(t0, a.columns[2], _MM_SHUFFLE( 3,1,3,1 ) );
 		out.columns[2] = _mm_shuffle_ps(t1, a.columns[2], _MM_SHUFFLE( 3,2,2,0 ) );
@@ -900,6 +1008,8 @@ namespace lib
 		lengths_squared = _mm_add_ps(lengths_squared, _mm_mul_ps(out.columns[1], out.columns[1] ) );
 		lengths_squared = _mm_add_ps(lengths_squared, _mm_mul_ps(out.columns[2], out.columns[2] ) );
 
+		// w lanes are 0, dividing by 1 keeps them 0 instead of 0/0 which the xor below relies on
+		lengths_squared = _mm_blend_ps(lengths_squared, _mm_set_ps1(1.f), 0b1000);
 		__m128 r_lengths_squared = _mm_div_ps(_mm_set_ps1(1.f), lengths_squared);
 
 		out.columns[0] = _mm_mul_ps(out.columns[0], r_lengths_squared);
@@ -915,4 +1025,320 @@ namespace lib
 
 		return out;
 	}
+
+	//? Rotation quaternion, xyz is the vector (imaginary) part and w the scalar part, identity is (0, 0, 0, 1).
+	//? Hamilton product, "a * b" rotates by "b" first and then by "a", same order as matrices.
+	//? 16 bytes instead of 48/64 of a rotation matrix, which is what big instance and bone arrays care about
+	union alignas(__m128) Quat
+	{
+		struct
+		{
+			f32 x, y, z, w;
+		};
+
+		struct
+		{
+			Vec3 xyz;
+		};
+
+		f32 e[4];
+		__m128 simd;
+
+		inline Quat operator-() const { return Quat{ -x, -y, -z, -w }; }
+		inline const f32& operator[](s32 i) const { return e[i]; }
+		inline f32& operator[](s32 i) { return e[i]; }
+	};
+
+	inline Quat operator+(const Quat a, const Quat b)
+	{
+		return Quat{ .simd = _mm_add_ps(a.simd, b.simd) };
+	}
+
+	inline Quat operator-(const Quat a, const Quat b)
+	{
+		return Quat{ .simd = _mm_sub_ps(a.simd, b.simd) };
+	}
+
+	inline Quat operator*(const f32 t, const Quat b)
+	{
+		return Quat{ .simd = _mm_mul_ps(b.simd, _mm_set_ps1(t)) };
+	}
+
+	inline Quat operator*(const Quat b, const f32 t)
+	{
+		return Quat{ .simd = _mm_mul_ps(b.simd, _mm_set_ps1(t)) };
+	}
+
+	//? Hamilton product as 4 broadcasts of "a" times permuted and sign flipped "b":
+	//? a*b = aw(bx, by, bz, bw) + ax(bw, -bz, by, -bx) + ay(bz, bw, -bx, -by) + az(-by, bx, bw, -bz)
+	inline Quat operator*(const Quat a, const Quat b)
+	{
+		__m128 b_wzyx = _mm_xor_ps(_mm_shuffle_ps(b.simd, b.simd, _MM_SHUFFLE(0, 1, 2, 3)), _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f));
+		__m128 b_zwxy = _mm_xor_ps(_mm_shuffle_ps(b.simd, b.simd, _MM_SHUFFLE(1, 0, 3, 2)), _mm_setr_ps(0.0f, 0.0f, -0.0f, -0.0f));
+		__m128 b_yxwz = _mm_xor_ps(_mm_shuffle_ps(b.simd, b.simd, _MM_SHUFFLE(2, 3, 0, 1)), _mm_setr_ps(-0.0f, 0.0f, 0.0f, -0.0f));
+
+		__m128 out = _mm_mul_ps(_mm_shuffle_ps(a.simd, a.simd, _MM_SHUFFLE(3, 3, 3, 3)), b.simd);
+		out = _mm_add_ps(out, _mm_mul_ps(_mm_shuffle_ps(a.simd, a.simd, _MM_SHUFFLE(0, 0, 0, 0)), b_wzyx));
+		out = _mm_add_ps(out, _mm_mul_ps(_mm_shuffle_ps(a.simd, a.simd, _MM_SHUFFLE(1, 1, 1, 1)), b_zwxy));
+		out = _mm_add_ps(out, _mm_mul_ps(_mm_shuffle_ps(a.simd, a.simd, _MM_SHUFFLE(2, 2, 2, 2)), b_yxwz));
+
+		return Quat{ .simd = out };
+	}
+
+	//! Be aware that floats are rarely perfectly equal, and q and -q are the same rotation
+	inline b32 operator==(const Quat a, const Quat b)
+	{
+		return { a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w };
+	}
+
+	[[nodiscard]]
+	inline Quat create_identity_quat()
+	{
+		return Quat{ 0.0f, 0.0f, 0.0f, 1.0f };
+	}
+
+	//? Right handed rotation by "angle" radians around normalized "axis"
+	[[nodiscard]]
+	inline Quat create_quat(const Vec3 axis, const f32 angle)
+	{
+		f32 s = std::sin(angle * 0.5f);
+		return Quat{ axis.x * s, axis.y * s, axis.z * s, std::cos(angle * 0.5f) };
+	}
+
+	inline f32 dot(const Quat a, const Quat b)
+	{
+		return (a.x*b.x) + (a.y*b.y) + (a.z*b.z) + (a.w*b.w);
+	}
+
+	inline f32 length_quat(const Quat a)
+	{
+		return sqrt( dot(a, a) );
+	}
+
+	//? Inverse of unit quaternion
+	inline Quat conjugate(const Quat a)
+	{
+		return Quat{ .simd = _mm_xor_ps(a.simd, _mm_setr_ps(-0.0f, -0.0f, -0.0f, 0.0f)) };
+	}
+
+	//! Not checked for zero quaternion
+	inline Quat inverse(const Quat a)
+	{
+		return conjugate(a) * (1.0f / dot(a, a));
+	}
+
+	//? Zero quaternion stays 0 like zero vectors in "normalize"
+	inline Quat normalize(const Quat a)
+	{
+		Quat out{};
+		f32 length = length_quat(a);
+		if (length != 0.0f)
+			out.simd = _mm_mul_ps(a.simd, _mm_set_ps1(1.0f / length));
+		return out;
+	}
+
+	//? q * (v, 0) * q^-1 for unit "q" expanded into two crosses: t = 2(q.xyz x v), v' = v + q.w*t + q.xyz x t
+	inline Vec3 rotate(const Quat q, const Vec3 v)
+	{
+		Vec3 t = 2.0f * cross(q.xyz, v);
+		return v + q.w * t + cross(q.xyz, t);
+	}
+
+	//? Normalized linear interpolation along shorter arc, constant speed only for small angles, which is what
+	//? neighbouring animation keys usually are
+	inline Quat nlerp(const Quat a, const Quat b, const f32 t)
+	{
+		Quat end = dot(a, b) < 0.0f ? -b : b;
+		return normalize(a + t * (end - a));
+	}
+
+	//? Slerp weights sin(t*theta) / sin(theta) as series in (cos(theta) - 1), from
+	//? "A Fast and Accurate Algorithm for Computing SLERP" by David Eberly: no acos, no sin, no division, and no
+	//? special case for small angles. Term i multiplies by (t^2 - i^2) / (i(2i + 1)) * (cos(theta) - 1), last one
+	//? is scaled by 1 + mu to make up for the cut off rest of the series.
+	//? With 12 terms and mu = 0.895 max error of the weights is 7.3e-7 for t in [0, 1] and angles up to 90 degrees
+	//? (cos(theta) >= 0, always true after taking the shorter arc), see "quat" of lib_bench for measurements
+	constexpr u32 SLERP_SERIES_TERMS = 12;
+	constexpr f32 SLERP_SERIES_LAST_SCALE = 1.895f;
+
+	//? u[i] = 1 / (i(2i + 1)), v[i] = i / (2i + 1), index 0 unused
+	struct Slerp_Series
+	{
+		f32 u[SLERP_SERIES_TERMS + 1];
+		f32 v[SLERP_SERIES_TERMS + 1];
+	};
+
+	constexpr Slerp_Series SLERP_SERIES = []
+	{
+		Slerp_Series out{};
+		for (u32 i = 1; i <= SLERP_SERIES_TERMS; ++i)
+		{
+			f32 scale = i == SLERP_SERIES_TERMS ? SLERP_SERIES_LAST_SCALE : 1.0f;
+			out.u[i] = scale / (f32)(i * (2 * i + 1));
+			out.v[i] = scale * (f32)i / (f32)(2 * i + 1);
+		}
+		return out;
+	}();
+
+	//? sin(t*theta) / sin(theta) in every lane, "t" per lane and "cos_minus_one" = cos(theta) - 1
+	inline __m128 slerp_weights(const __m128 t, const __m128 cos_minus_one)
+	{
+		__m128 t_squared = _mm_mul_ps(t, t);
+		__m128 one = _mm_set_ps1(1.0f);
+		__m128 out = one;
+		for (u32 i = SLERP_SERIES_TERMS; i > 0; --i)
+		{
+			__m128 b = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(_mm_set_ps1(SLERP_SERIES.u[i]), t_squared), _mm_set_ps1(SLERP_SERIES.v[i])), cos_minus_one);
+			out = _mm_add_ps(one, _mm_mul_ps(b, out));
+		}
+		return _mm_mul_ps(t, out);
+	}
+
+	//? Constant angular speed interpolation along shorter arc of unit quaternions, both weights are one series evaluation
+	inline Quat slerp(const Quat a, const Quat b, const f32 t)
+	{
+		f32 cos_theta = dot(a, b);
+		Quat end = cos_theta < 0.0f ? -b : b;
+		__m128 weights = slerp_weights(_mm_setr_ps(1.0f - t, t, 0.0f, 0.0f), _mm_set_ps1(lib::abs(cos_theta) - 1.0f));
+		__m128 weight_a = _mm_shuffle_ps(weights, weights, _MM_SHUFFLE(0, 0, 0, 0));
+		__m128 weight_b = _mm_shuffle_ps(weights, weights, _MM_SHUFFLE(1, 1, 1, 1));
+		return Quat{ .simd = _mm_add_ps(_mm_mul_ps(weight_a, a.simd), _mm_mul_ps(weight_b, end.simd)) };
+	}
+
+	//? Rotation matrix of unit quaternion, translation is 0
+	[[nodiscard]]
+	inline Trans4 create_transform(const Quat q)
+	{
+		f32 xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+		f32 xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+		f32 wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+		Trans4 out{};
+		out.columns[0] = _mm_setr_ps(1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy), 0.0f);
+		out.columns[1] = _mm_setr_ps(2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx), 0.0f);
+		out.columns[2] = _mm_setr_ps(2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy), 0.0f);
+		out.columns[3] = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+		return out;
+	}
+
+	//? Rotation part of transform as unit quaternion (Shepperd's method: largest of w, x, y, z is computed from the
+	//? diagonal and the rest from it, so there is no division by small numbers).
+	//? Columns are normalized first, so positive (also non-uniform) scale is removed, translation is ignored.
+	//! No shear and no mirroring (negative determinant) - those are not rotations
+	inline Quat get_rotation(const Trans4 a)
+	{
+		Vec3 c0 = normalize(a.vecs[0].xyz);
+		Vec3 c1 = normalize(a.vecs[1].xyz);
+		Vec3 c2 = normalize(a.vecs[2].xyz);
+
+		Quat out{};
+		f32 trace = c0.x + c1.y + c2.z;
+		if (trace > 0.0f)
+		{
+			f32 s = 0.5f / sqrt(trace + 1.0f);
+			out = Quat{ (c1.z - c2.y) * s, (c2.x - c0.z) * s, (c0.y - c1.x) * s, 0.25f / s };
+		}
+		else if (c0.x > c1.y && c0.x > c2.z)
+		{
+			f32 s = 0.5f / sqrt(1.0f + c0.x - c1.y - c2.z);
+			out = Quat{ 0.25f / s, (c1.x + c0.y) * s, (c2.x + c0.z) * s, (c1.z - c2.y) * s };
+		}
+		else if (c1.y > c2.z)
+		{
+			f32 s = 0.5f / sqrt(1.0f + c1.y - c0.x - c2.z);
+			out = Quat{ (c1.x + c0.y) * s, 0.25f / s, (c2.y + c1.z) * s, (c2.x - c0.z) * s };
+		}
+		else
+		{
+			f32 s = 0.5f / sqrt(1.0f + c2.z - c0.x - c1.y);
+			out = Quat{ (c2.x + c0.z) * s, (c2.y + c1.z) * s, 0.25f / s, (c0.y - c1.x) * s };
+		}
+		return out;
+	}
+
+	//? Rigid transform (rotation + translation) as dual quaternion real + eps*dual, dual = 0.5 * (t, 0) * real.
+	//? 32 bytes, composes with a multiply and blends without shrinking (skinning), unlike matrices
+	struct DualQuat
+	{
+		Quat real;
+		Quat dual;
+	};
+
+	[[nodiscard]]
+	inline DualQuat create_identity_dual_quat()
+	{
+		return DualQuat{ create_identity_quat(), Quat{} };
+	}
+
+	//? Rotates by unit "rotation" first, then translates
+	[[nodiscard]]
+	inline DualQuat create_dual_quat(const Quat rotation, const Vec3 translation)
+	{
+		Quat t{ translation.x, translation.y, translation.z, 0.0f };
+		return DualQuat{ rotation, 0.5f * (t * rotation) };
+	}
+
+	//? See "get_rotation", scale is dropped
+	[[nodiscard]]
+	inline DualQuat create_dual_quat(const Trans4 a)
+	{
+		return create_dual_quat(get_rotation(a), get_translation(a));
+	}
+
+	//? Same order as matrices, "b" first
+	inline DualQuat operator*(const DualQuat a, const DualQuat b)
+	{
+		return DualQuat{ a.real * b.real, a.real * b.dual + a.dual * b.real };
+	}
+
+	//? Inverse of unit dual quaternion
+	inline DualQuat conjugate(const DualQuat a)
+	{
+		return DualQuat{ conjugate(a.real), conjugate(a.dual) };
+	}
+
+	//? Unit real part and dual part orthogonal to it, what accumulated products and blends drift away from
+	inline DualQuat normalize(const DualQuat a)
+	{
+		f32 r_length = 1.0f / length_quat(a.real);
+		Quat real = a.real * r_length;
+		Quat dual = a.dual * r_length;
+		return DualQuat{ real, dual - dot(real, dual) * real };
+	}
+
+	inline Vec3 get_translation(const DualQuat a)
+	{
+		return (2.0f * (a.dual * conjugate(a.real))).xyz;
+	}
+
+	//? Multiplication when Vec3 is a homogenous point (w=1), unit dual quaternion assumed
+	inline Vec3 mul_point(const DualQuat a, const Vec3 p)
+	{
+		return rotate(a.real, p) + get_translation(a);
+	}
+
+	//? Multiplication when Vec3 is 3D vector (w=0), translation does not apply
+	inline Vec3 mul_vec(const DualQuat a, const Vec3 v)
+	{
+		return rotate(a.real, v);
+	}
+
+	//? Dual quaternion linear blending (Kavan et al.) of two transforms, shorter arc, result is normalized
+	inline DualQuat nlerp(const DualQuat a, const DualQuat b, const f32 t)
+	{
+		f32 sign = dot(a.real, b.real) < 0.0f ? -1.0f : 1.0f;
+		f32 weight_b = t * sign;
+		f32 weight_a = 1.0f - t;
+		return normalize(DualQuat{ weight_a * a.real + weight_b * b.real, weight_a * a.dual + weight_b * b.dual });
+	}
+
+	//? Unit dual quaternion to rigid transform
+	[[nodiscard]]
+	inline Trans4 create_transform(const DualQuat a)
+	{
+		Trans4 out = create_transform(a.real);
+		Vec3 t = get_translation(a);
+		out.columns[3] = _mm_setr_ps(t.x, t.y, t.z, 1.0f);
+		return out;
+	}
 }
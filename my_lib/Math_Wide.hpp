@@ -0,0 +1,1336 @@
+#pragma once
+//? -----------------------------------------------------------------------------------------------
+//? WIDE (AVX2) STRUCTURE-OF-ARRAYS COUNTERPARTS OF "Math.hpp" TYPES: EVERY COMPONENT IS ONE __m256 HOLDING
+//? THE SAME COMPONENT OF 8 DIFFERENT VECTORS, SO ONE INSTRUCTION DOES ONE OPERATION FOR 8 ELEMENTS AND NOTHING
+//? IS EVER SHUFFLED (NO HORIZONTAL ADDS FOR DOTS, NO SWIZZLES FOR CROSSES).
+//? -----------------------------------------------------------------------------------------------
+
+//? Semantics follow scalar versions in "Math.hpp" lane by lane, only branches become masks: functions that
+//? return 0 vector for degenerate input (normalize, refract) do it per lane.
+//? Matrices are not widened, "Mat4_Wide" / "Trans4_Wide" are one matrix broadcast into all lanes, because in
+//? every pipeline stage it is 8 vertices (or pixels) times the same matrix.
+//? Masks are results of compares (all bits set / all bits clear per lane), like everywhere in AVX.
+//! Compiled for AVX2 + FMA in every build (region of "Cpu_Features.hpp"), usable only when "g_cpu.isa" is at least AVX2
+
+#include <immintrin.h>
+
+#include "Utils.hpp"
+#include "Math.hpp"
+#include "Cpu_Features.hpp"
+
+CPU_TARGET_AVX2_BEGIN
+namespace lib
+{
+	constexpr u32 WIDE_LANES = 8;
+
+	struct Vec2x8
+	{
+		__m256 x, y;
+	};
+
+	struct Vec3x8
+	{
+		__m256 x, y, z;
+	};
+
+	struct Vec4x8
+	{
+		__m256 x, y, z, w;
+	};
+
+	//? One matrix in every lane, columns are kept, element [column][row] like "Mat4::e"
+	struct Mat4_Wide
+	{
+		__m256 e[4][4];
+	};
+
+	struct Trans4_Wide : Mat4_Wide
+	{
+		// No additional data
+	};
+
+	// ===============================================================================================================================
+	// ========================================================= SPLATS ==============================================================
+	// ===============================================================================================================================
+	inline __m256 splat(const f32 f) { return _mm256_set1_ps(f); }
+	inline Vec2x8 splat(const Vec2 a) { return { _mm256_set1_ps(a.x), _mm256_set1_ps(a.y) }; }
+	inline Vec3x8 splat(const Vec3 a) { return { _mm256_set1_ps(a.x), _mm256_set1_ps(a.y), _mm256_set1_ps(a.z) }; }
+	inline Vec4x8 splat(const Vec4 a) { return { _mm256_set1_ps(a.x), _mm256_set1_ps(a.y), _mm256_set1_ps(a.z), _mm256_set1_ps(a.w) }; }
+
+	inline Mat4_Wide broadcast(const Mat4 &a)
+	{
+		Mat4_Wide out;
+		for (s32 c = 0; c < 4; ++c)
+			for (s32 r = 0; r < 4; ++r)
+				out.e[c][r] = _mm256_set1_ps(a.e[c][r]);
+		return out;
+	}
+
+	inline Trans4_Wide broadcast(const Trans4 &a)
+	{
+		Trans4_Wide out;
+		*(Mat4_Wide *)&out = broadcast((const Mat4 &)a);
+		return out;
+	}
+
+	//? Mask of first "count" lanes, for tails of streams that are not multiple of 8
+	inline __m256 lane_mask(const u32 count)
+	{
+		__m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+		return _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32((s32)count), lanes));
+	}
+
+	// ===============================================================================================================================
+	// ===================================================== LOAD / STORE ============================================================
+	// ===============================================================================================================================
+	//? SoA streams: one array per component, element "i" of the stream is (x[i], y[i], z[i]).
+	//? "_aligned" versions need 32B aligned addresses, "stream_" stores bypass cache and need them too,
+	//? "_masked" touch only lanes of the mask (no reads nor faults past the end of a stream)
+
+	inline Vec3x8 load_vec3x8(const f32 *x, const f32 *y, const f32 *z)
+	{
+		return { _mm256_loadu_ps(x), _mm256_loadu_ps(y), _mm256_loadu_ps(z) };
+	}
+
+	inline Vec3x8 load_vec3x8_aligned(const f32 *x, const f32 *y, const f32 *z)
+	{
+		return { _mm256_load_ps(x), _mm256_load_ps(y), _mm256_load_ps(z) };
+	}
+
+	inline Vec3x8 load_vec3x8_masked(const f32 *x, const f32 *y, const f32 *z, const __m256 mask)
+	{
+		__m256i m = _mm256_castps_si256(mask);
+		return { _mm256_maskload_ps(x, m), _mm256_maskload_ps(y, m), _mm256_maskload_ps(z, m) };
+	}
+
+	inline void store(f32 *x, f32 *y, f32 *z, const Vec3x8 a)
+	{
+		_mm256_storeu_ps(x, a.x);
+		_mm256_storeu_ps(y, a.y);
+		_mm256_storeu_ps(z, a.z);
+	}
+
+	inline void store_aligned(f32 *x, f32 *y, f32 *z, const Vec3x8 a)
+	{
+		_mm256_store_ps(x, a.x);
+		_mm256_store_ps(y, a.y);
+		_mm256_store_ps(z, a.z);
+	}
+
+	inline void stream(f32 *x, f32 *y, f32 *z, const Vec3x8 a)
+	{
+		_mm256_stream_ps(x, a.x);
+		_mm256_stream_ps(y, a.y);
+		_mm256_stream_ps(z, a.z);
+	}
+
+	inline void store_masked(f32 *x, f32 *y, f32 *z, const Vec3x8 a, const __m256 mask)
+	{
+		__m256i m = _mm256_castps_si256(mask);
+		_mm256_maskstore_ps(x, m, a.x);
+		_mm256_maskstore_ps(y, m, a.y);
+		_mm256_maskstore_ps(z, m, a.z);
+	}
+
+	inline Vec4x8 load_vec4x8(const f32 *x, const f32 *y, const f32 *z, const f32 *w)
+	{
+		return { _mm256_loadu_ps(x), _mm256_loadu_ps(y), _mm256_loadu_ps(z), _mm256_loadu_ps(w) };
+	}
+
+	inline Vec4x8 load_vec4x8_aligned(const f32 *x, const f32 *y, const f32 *z, const f32 *w)
+	{
+		return { _mm256_load_ps(x), _mm256_load_ps(y), _mm256_load_ps(z), _mm256_load_ps(w) };
+	}
+
+	inline Vec4x8 load_vec4x8_masked(const f32 *x, const f32 *y, const f32 *z, const f32 *w, const __m256 mask)
+	{
+		__m256i m = _mm256_castps_si256(mask);
+		return { _mm256_maskload_ps(x, m), _mm256_maskload_ps(y, m), _mm256_maskload_ps(z, m), _mm256_maskload_ps(w, m) };
+	}
+
+	inline void store(f32 *x, f32 *y, f32 *z, f32 *w, const Vec4x8 a)
+	{
+		_mm256_storeu_ps(x, a.x);
+		_mm256_storeu_ps(y, a.y);
+		_mm256_storeu_ps(z, a.z);
+		_mm256_storeu_ps(w, a.w);
+	}
+
+	inline void store_aligned(f32 *x, f32 *y, f32 *z, f32 *w, const Vec4x8 a)
+	{
+		_mm256_store_ps(x, a.x);
+		_mm256_store_ps(y, a.y);
+		_mm256_store_ps(z, a.z);
+		_mm256_store_ps(w, a.w);
+	}
+
+	inline void stream(f32 *x, f32 *y, f32 *z, f32 *w, const Vec4x8 a)
+	{
+		_mm256_stream_ps(x, a.x);
+		_mm256_stream_ps(y, a.y);
+		_mm256_stream_ps(z, a.z);
+		_mm256_stream_ps(w, a.w);
+	}
+
+	inline void store_masked(f32 *x, f32 *y, f32 *z, f32 *w, const Vec4x8 a, const __m256 mask)
+	{
+		__m256i m = _mm256_castps_si256(mask);
+		_mm256_maskstore_ps(x, m, a.x);
+		_mm256_maskstore_ps(y, m, a.y);
+		_mm256_maskstore_ps(z, m, a.z);
+		_mm256_maskstore_ps(w, m, a.w);
+	}
+
+	//? 8 consecutive AoS "Vec3" (24 floats, no padding) into SoA registers: 6 loads and 5 shuffles instead of 24 inserts.
+	//? 128-bit halves hold vectors 0-3 and 4-7, so every in-lane shuffle works on both halves at once
+	inline Vec3x8 load_vec3x8_aos(const Vec3 *p)
+	{
+		const f32 *f = p->e;
+		__m256 m03 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(f + 0)), _mm_loadu_ps(f + 12), 1); // x0y0z0x1 x4y4z4x5
+		__m256 m14 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(f + 4)), _mm_loadu_ps(f + 16), 1); // y1z1x2y2 y5z5x6y6
+		__m256 m25 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(f + 8)), _mm_loadu_ps(f + 20), 1); // z2x3y3z3 z6x7y7z7
+
+		__m256 xy = _mm256_shuffle_ps(m14, m25, _MM_SHUFFLE(2, 1, 3, 2)); // x2y2x3y3
+		__m256 yz = _mm256_shuffle_ps(m03, m14, _MM_SHUFFLE(1, 0, 2, 1)); // y0z0y1z1
+		return { _mm256_shuffle_ps(m03, xy, _MM_SHUFFLE(2, 0, 3, 0)),
+		         _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0)),
+		         _mm256_shuffle_ps(yz, m25, _MM_SHUFFLE(3, 0, 3, 1)) };
+	}
+
+	//? Lane "i" of the output is "a" for set mask bits and "b" otherwise
+	inline __m256 select(const __m256 mask, const __m256 a, const __m256 b)
+	{
+		return _mm256_blendv_ps(b, a, mask);
+	}
+
+	inline Vec3x8 select(const __m256 mask, const Vec3x8 a, const Vec3x8 b)
+	{
+		return { select(mask, a.x, b.x), select(mask, a.y, b.y), select(mask, a.z, b.z) };
+	}
+
+	inline Vec4x8 select(const __m256 mask, const Vec4x8 a, const Vec4x8 b)
+	{
+		return { select(mask, a.x, b.x), select(mask, a.y, b.y), select(mask, a.z, b.z), select(mask, a.w, b.w) };
+	}
+
+	// ===============================================================================================================================
+	// ==================================================== SCALAR FUNCTIONS =========================================================
+	// ===============================================================================================================================
+	//? 8-wide versions of "sqrt", "rsqrt", rounding, min, max, abs and clamp of "Math.hpp".
+	//? Rounding returns integers like the scalar versions do, use _mm256_round_ps directly when floats are wanted
+
+	//? Approximations with selectable accuracy (rsqrt and transcendentals at the end of this file):
+	//?   Fast     - 11 to 16 bits (errors 1e-5 to 5e-4) like hardware rsqrt/rcp, fewest instructions
+	//?   Accurate - 1 to 4 ulp from correctly rounded result, max errors of every function are in its comment
+	//? "pow" is the exception, its error grows with the exponent. Accuracy table of "transcendental x8" in lib_bench
+	//? remeasures them against double precision libm
+	enum class Precision : u32
+	{
+		Fast,
+		Accurate,
+	};
+
+	inline __m256 sqrt(const __m256 a)
+	{
+		return _mm256_sqrt_ps(a);
+	}
+
+	//? Fast: max relative error 1.5 * 2^-12 (_mm256_rsqrt_ps).
+	//? Accurate: one Newton-Raphson step y * (1.5 - 0.5 * a * y * y) on top of it, max relative error ~2.5e-7 (~4 ulp)
+	//! 0 gives inf for Fast and NaN for Accurate
+	template <Precision P = Precision::Accurate>
+	inline __m256 rsqrt(const __m256 a)
+	{
+		__m256 y = _mm256_rsqrt_ps(a);
+		if constexpr (P == Precision::Accurate)
+		{
+			__m256 half_a_y = _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(0.5f), a), y);
+			y = _mm256_mul_ps(y, _mm256_fnmadd_ps(half_a_y, y, _mm256_set1_ps(1.5f)));
+		}
+		return y;
+	}
+
+	inline __m256i ceil(const __m256 a)
+	{
+		return _mm256_cvtps_epi32(_mm256_round_ps(a, _MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC));
+	}
+
+	inline __m256i floor(const __m256 a)
+	{
+		return _mm256_cvtps_epi32(_mm256_round_ps(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC));
+	}
+
+	inline __m256i round(const __m256 a)
+	{
+		return _mm256_cvtps_epi32(_mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+	}
+
+	inline __m256i trunc(const __m256 a)
+	{
+		return _mm256_cvttps_epi32(a);
+	}
+
+	inline __m256 min(const __m256 a, const __m256 b)
+	{
+		return _mm256_min_ps(a, b);
+	}
+
+	inline __m256 max(const __m256 a, const __m256 b)
+	{
+		return _mm256_max_ps(a, b);
+	}
+
+	inline __m256 abs(const __m256 a)
+	{
+		return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a);
+	}
+
+	inline __m256 clamp(const __m256 val, const __m256 min, const __m256 max)
+	{
+		return _mm256_min_ps(_mm256_max_ps(val, min), max);
+	}
+
+	// ===============================================================================================================================
+	// ========================================================= VEC3X8 ==============================================================
+	// ===============================================================================================================================
+	inline Vec3x8 operator-(const Vec3x8 a)
+	{
+		__m256 sign = _mm256_set1_ps(-0.0f);
+		return { _mm256_xor_ps(a.x, sign), _mm256_xor_ps(a.y, sign), _mm256_xor_ps(a.z, sign) };
+	}
+
+	inline Vec3x8 operator+(const Vec3x8 a, const Vec3x8 b)
+	{
+		return { _mm256_add_ps(a.x, b.x), _mm256_add_ps(a.y, b.y), _mm256_add_ps(a.z, b.z) };
+	}
+
+	inline Vec3x8 operator-(const Vec3x8 a, const Vec3x8 b)
+	{
+		return { _mm256_sub_ps(a.x, b.x), _mm256_sub_ps(a.y, b.y), _mm256_sub_ps(a.z, b.z) };
+	}
+
+	inline Vec3x8 operator*(const Vec3x8 a, const Vec3x8 b)
+	{
+		return { _mm256_mul_ps(a.x, b.x), _mm256_mul_ps(a.y, b.y), _mm256_mul_ps(a.z, b.z) };
+	}
+
+	//? Per lane scalar, e.g. result of "dot"
+	inline Vec3x8 operator*(const __m256 t, const Vec3x8 b)
+	{
+		return { _mm256_mul_ps(t, b.x), _mm256_mul_ps(t, b.y), _mm256_mul_ps(t, b.z) };
+	}
+
+	inline Vec3x8 operator*(const Vec3x8 b, const __m256 t)
+	{
+		return t * b;
+	}
+
+	inline Vec3x8 operator*(const f32 t, const Vec3x8 b)
+	{
+		return _mm256_set1_ps(t) * b;
+	}
+
+	inline Vec3x8 operator*(const Vec3x8 b, const f32 t)
+	{
+		return _mm256_set1_ps(t) * b;
+	}
+
+	inline Vec3x8 operator/(const Vec3x8 b, const __m256 t)
+	{
+		return _mm256_div_ps(_mm256_set1_ps(1.0f), t) * b;
+	}
+
+	inline Vec3x8 operator/(const Vec3x8 b, const f32 t)
+	{
+		return (1.0f / t) * b;
+	}
+
+	inline Vec3x8& operator+=(Vec3x8 &a, const Vec3x8 b)
+	{
+		return a = a + b;
+	}
+
+	inline Vec3x8& operator*=(Vec3x8 &a, const f32 t)
+	{
+		return a = a * t;
+	}
+
+	inline __m256 dot(const Vec3x8 a, const Vec3x8 b)
+	{
+		__m256 out = _mm256_mul_ps(a.x, b.x);
+		out = _mm256_fmadd_ps(a.y, b.y, out);
+		return _mm256_fmadd_ps(a.z, b.z, out);
+	}
+
+	inline __m256 length_squared_vec(const Vec3x8 a)
+	{
+		return dot(a, a);
+	}
+
+	inline __m256 length_vec(const Vec3x8 a)
+	{
+		return _mm256_sqrt_ps(dot(a, a));
+	}
+
+	//? Zero length lanes stay 0 like in scalar version
+	inline Vec3x8 normalize(const Vec3x8 a)
+	{
+		__m256 length = length_vec(a);
+		__m256 is_zero = _mm256_cmp_ps(length, _mm256_setzero_ps(), _CMP_EQ_OQ);
+		__m256 multi = _mm256_andnot_ps(is_zero, _mm256_div_ps(_mm256_set1_ps(1.0f), length));
+		return multi * a;
+	}
+
+	//! ~12 bits of precision, zero length lanes produce garbage
+	inline Vec3x8 normalize_fast(const Vec3x8 a)
+	{
+		return _mm256_rsqrt_ps(dot(a, a)) * a;
+	}
+
+	inline Vec3x8 cross(const Vec3x8 a, const Vec3x8 b)
+	{
+		return { _mm256_fmsub_ps(a.y, b.z, _mm256_mul_ps(a.z, b.y)),
+		         _mm256_fmsub_ps(a.z, b.x, _mm256_mul_ps(a.x, b.z)),
+		         _mm256_fmsub_ps(a.x, b.y, _mm256_mul_ps(a.y, b.x)) };
+	}
+
+	inline Vec3x8 reflect(const Vec3x8 a, const Vec3x8 b)
+	{
+		return a - _mm256_mul_ps(_mm256_set1_ps(2.0f), dot(a, b)) * b;
+	}
+
+	//? Lanes with total internal reflection are 0
+	inline Vec3x8 refract(const Vec3x8 a, const Vec3x8 b, const f32 ratio)
+	{
+		__m256 one = _mm256_set1_ps(1.0f);
+		__m256 ratio_w = _mm256_set1_ps(ratio);
+		__m256 cos_i = _mm256_xor_ps(dot(a, b), _mm256_set1_ps(-0.0f));
+		__m256 sin_t = _mm256_mul_ps(_mm256_mul_ps(ratio_w, ratio_w), _mm256_fnmadd_ps(cos_i, cos_i, one));
+		__m256 is_refracted = _mm256_cmp_ps(sin_t, one, _CMP_LE_OQ);
+
+		__m256 b_factor = _mm256_sub_ps(_mm256_mul_ps(ratio_w, cos_i), _mm256_sqrt_ps(_mm256_max_ps(_mm256_sub_ps(one, sin_t), _mm256_setzero_ps())));
+		Vec3x8 out = ratio * a + b_factor * b;
+		return { _mm256_and_ps(out.x, is_refracted), _mm256_and_ps(out.y, is_refracted), _mm256_and_ps(out.z, is_refracted) };
+	}
+
+	inline Vec3x8 project(const Vec3x8 a, const Vec3x8 b)
+	{
+		return _mm256_div_ps(dot(a, b), dot(b, b)) * b;
+	}
+
+	//? for normalized vectors
+	inline Vec3x8 project_norm(const Vec3x8 a, const Vec3x8 b)
+	{
+		return dot(a, b) * b;
+	}
+
+	inline __m256 project_length(const Vec3x8 a, const Vec3x8 b)
+	{
+		return _mm256_div_ps(dot(a, b), length_vec(b));
+	}
+
+	inline Vec3x8 reject(const Vec3x8 a, const Vec3x8 b)
+	{
+		return a - project(a, b);
+	}
+
+	//? for normalized vectors
+	inline Vec3x8 reject_norm(const Vec3x8 a, const Vec3x8 b)
+	{
+		return a - dot(a, b) * b;
+	}
+
+	inline __m256 reject_length(const Vec3x8 a, const Vec3x8 b)
+	{
+		return _mm256_div_ps(length_vec(cross(a, b)), length_vec(b));
+	}
+
+	//! Not clamped, same as scalar "lerp"
+	inline __m256 lerp(const __m256 a, const __m256 b, const __m256 t)
+	{
+		return _mm256_fmadd_ps(t, _mm256_sub_ps(b, a), a);
+	}
+
+	inline Vec3x8 lerp(const Vec3x8 a, const Vec3x8 b, const __m256 t)
+	{
+		return { lerp(a.x, b.x, t), lerp(a.y, b.y, t), lerp(a.z, b.z, t) };
+	}
+
+	// ===============================================================================================================================
+	// ========================================================= VEC4X8 ==============================================================
+	// ===============================================================================================================================
+	//? Same rules as "Vec4": homogeneous Vec3, cross and reflect ignore/keep w like their 128-bit versions
+	inline Vec4x8 operator-(const Vec4x8 a)
+	{
+		__m256 sign = _mm256_set1_ps(-0.0f);
+		return { _mm256_xor_ps(a.x, sign), _mm256_xor_ps(a.y, sign), _mm256_xor_ps(a.z, sign), _mm256_xor_ps(a.w, sign) };
+	}
+
+	inline Vec4x8 operator+(const Vec4x8 a, const Vec4x8 b)
+	{
+		return { _mm256_add_ps(a.x, b.x), _mm256_add_ps(a.y, b.y), _mm256_add_ps(a.z, b.z), _mm256_add_ps(a.w, b.w) };
+	}
+
+	inline Vec4x8 operator-(const Vec4x8 a, const Vec4x8 b)
+	{
+		return { _mm256_sub_ps(a.x, b.x), _mm256_sub_ps(a.y, b.y), _mm256_sub_ps(a.z, b.z), _mm256_sub_ps(a.w, b.w) };
+	}
+
+	inline Vec4x8 operator*(const Vec4x8 a, const Vec4x8 b)
+	{
+		return { _mm256_mul_ps(a.x, b.x), _mm256_mul_ps(a.y, b.y), _mm256_mul_ps(a.z, b.z), _mm256_mul_ps(a.w, b.w) };
+	}
+
+	inline Vec4x8 operator*(const __m256 t, const Vec4x8 b)
+	{
+		return { _mm256_mul_ps(t, b.x), _mm256_mul_ps(t, b.y), _mm256_mul_ps(t, b.z), _mm256_mul_ps(t, b.w) };
+	}
+
+	inline Vec4x8 operator*(const Vec4x8 b, const __m256 t)
+	{
+		return t * b;
+	}
+
+	inline Vec4x8 operator*(const f32 t, const Vec4x8 b)
+	{
+		return _mm256_set1_ps(t) * b;
+	}
+
+	inline Vec4x8 operator*(const Vec4x8 b, const f32 t)
+	{
+		return _mm256_set1_ps(t) * b;
+	}
+
+	inline Vec4x8 operator/(const Vec4x8 b, const __m256 t)
+	{
+		return _mm256_div_ps(_mm256_set1_ps(1.0f), t) * b;
+	}
+
+	inline Vec4x8 operator/(const Vec4x8 b, const f32 t)
+	{
+		return (1.0f / t) * b;
+	}
+
+	inline Vec4x8& operator+=(Vec4x8 &a, const Vec4x8 b)
+	{
+		return a = a + b;
+	}
+
+	inline Vec4x8& operator*=(Vec4x8 &a, const f32 t)
+	{
+		return a = a * t;
+	}
+
+	inline __m256 dot(const Vec4x8 a, const Vec4x8 b)
+	{
+		__m256 out = _mm256_mul_ps(a.x, b.x);
+		out = _mm256_fmadd_ps(a.y, b.y, out);
+		out = _mm256_fmadd_ps(a.z, b.z, out);
+		return _mm256_fmadd_ps(a.w, b.w, out);
+	}
+
+	inline __m256 length_squared_vec(const Vec4x8 a)
+	{
+		return dot(a, a);
+	}
+
+	inline __m256 length_vec(const Vec4x8 a)
+	{
+		return _mm256_sqrt_ps(dot(a, a));
+	}
+
+	inline Vec4x8 normalize(const Vec4x8 a)
+	{
+		__m256 length = length_vec(a);
+		__m256 is_zero = _mm256_cmp_ps(length, _mm256_setzero_ps(), _CMP_EQ_OQ);
+		__m256 multi = _mm256_andnot_ps(is_zero, _mm256_div_ps(_mm256_set1_ps(1.0f), length));
+		return multi * a;
+	}
+
+	//! ~12 bits of precision, zero length lanes produce garbage
+	inline Vec4x8 normalize_fast(const Vec4x8 a)
+	{
+		return _mm256_rsqrt_ps(dot(a, a)) * a;
+	}
+
+	//? w of the result is 0 like in 128-bit "cross" of vectors (w=0)
+	inline Vec4x8 cross(const Vec4x8 a, const Vec4x8 b)
+	{
+		Vec3x8 out = cross(Vec3x8{ a.x, a.y, a.z }, Vec3x8{ b.x, b.y, b.z });
+		return { out.x, out.y, out.z, _mm256_setzero_ps() };
+	}
+
+	inline Vec4x8 reflect(const Vec4x8 a, const Vec4x8 b)
+	{
+		return a - _mm256_mul_ps(_mm256_set1_ps(2.0f), dot(a, b)) * b;
+	}
+
+	inline Vec4x8 project(const Vec4x8 a, const Vec4x8 b)
+	{
+		return _mm256_div_ps(dot(a, b), dot(b, b)) * b;
+	}
+
+	//? for normalized vectors
+	inline Vec4x8 project_norm(const Vec4x8 a, const Vec4x8 b)
+	{
+		return dot(a, b) * b;
+	}
+
+	inline Vec4x8 reject(const Vec4x8 a, const Vec4x8 b)
+	{
+		return a - project(a, b);
+	}
+
+	//? for normalized vectors
+	inline Vec4x8 reject_norm(const Vec4x8 a, const Vec4x8 b)
+	{
+		return a - dot(a, b) * b;
+	}
+
+	inline Vec4x8 lerp(const Vec4x8 a, const Vec4x8 b, const __m256 t)
+	{
+		return { lerp(a.x, b.x, t), lerp(a.y, b.y, t), lerp(a.z, b.z, t), lerp(a.w, b.w, t) };
+	}
+
+	// ===============================================================================================================================
+	// ======================================================= TRANSFORMS ============================================================
+	// ===============================================================================================================================
+	//? Same linear combination as "operator*(Mat4, Vec4)", but every column is a splat and every vector element a register,
+	//? so it is 16 FMAs for 8 vectors instead of 4 shuffles + 4 mul/add per vector
+	inline Vec4x8 operator*(const Mat4_Wide &a, const Vec4x8 b)
+	{
+		Vec4x8 out;
+		out.x = _mm256_mul_ps(a.e[0][0], b.x);
+		out.y = _mm256_mul_ps(a.e[0][1], b.x);
+		out.z = _mm256_mul_ps(a.e[0][2], b.x);
+		out.w = _mm256_mul_ps(a.e[0][3], b.x);
+		out.x = _mm256_fmadd_ps(a.e[1][0], b.y, out.x);
+		out.y = _mm256_fmadd_ps(a.e[1][1], b.y, out.y);
+		out.z = _mm256_fmadd_ps(a.e[1][2], b.y, out.z);
+		out.w = _mm256_fmadd_ps(a.e[1][3], b.y, out.w);
+		out.x = _mm256_fmadd_ps(a.e[2][0], b.z, out.x);
+		out.y = _mm256_fmadd_ps(a.e[2][1], b.z, out.y);
+		out.z = _mm256_fmadd_ps(a.e[2][2], b.z, out.z);
+		out.w = _mm256_fmadd_ps(a.e[2][3], b.z, out.w);
+		out.x = _mm256_fmadd_ps(a.e[3][0], b.w, out.x);
+		out.y = _mm256_fmadd_ps(a.e[3][1], b.w, out.y);
+		out.z = _mm256_fmadd_ps(a.e[3][2], b.w, out.z);
+		out.w = _mm256_fmadd_ps(a.e[3][3], b.w, out.w);
+		return out;
+	}
+
+	//? Homogeneous point (w=1) through full matrix, e.g. model-view-projection into clip space
+	inline Vec4x8 mul_point(const Mat4_Wide &a, const Vec3x8 p)
+	{
+		Vec4x8 out;
+		out.x = _mm256_fmadd_ps(a.e[0][0], p.x, a.e[3][0]);
+		out.y = _mm256_fmadd_ps(a.e[0][1], p.x, a.e[3][1]);
+		out.z = _mm256_fmadd_ps(a.e[0][2], p.x, a.e[3][2]);
+		out.w = _mm256_fmadd_ps(a.e[0][3], p.x, a.e[3][3]);
+		out.x = _mm256_fmadd_ps(a.e[1][0], p.y, out.x);
+		out.y = _mm256_fmadd_ps(a.e[1][1], p.y, out.y);
+		out.z = _mm256_fmadd_ps(a.e[1][2], p.y, out.z);
+		out.w = _mm256_fmadd_ps(a.e[1][3], p.y, out.w);
+		out.x = _mm256_fmadd_ps(a.e[2][0], p.z, out.x);
+		out.y = _mm256_fmadd_ps(a.e[2][1], p.z, out.y);
+		out.z = _mm256_fmadd_ps(a.e[2][2], p.z, out.z);
+		out.w = _mm256_fmadd_ps(a.e[2][3], p.z, out.w);
+		return out;
+	}
+
+	//? Multiplication when Vec3 is a homogenous point (w=1), bottom row of transform is (0,0,0,1) so w is never computed
+	inline Vec3x8 mul_point(const Trans4_Wide &a, const Vec3x8 p)
+	{
+		Vec3x8 out;
+		out.x = _mm256_fmadd_ps(a.e[0][0], p.x, a.e[3][0]);
+		out.y = _mm256_fmadd_ps(a.e[0][1], p.x, a.e[3][1]);
+		out.z = _mm256_fmadd_ps(a.e[0][2], p.x, a.e[3][2]);
+		out.x = _mm256_fmadd_ps(a.e[1][0], p.y, out.x);
+		out.y = _mm256_fmadd_ps(a.e[1][1], p.y, out.y);
+		out.z = _mm256_fmadd_ps(a.e[1][2], p.y, out.z);
+		out.x = _mm256_fmadd_ps(a.e[2][0], p.z, out.x);
+		out.y = _mm256_fmadd_ps(a.e[2][1], p.z, out.y);
+		out.z = _mm256_fmadd_ps(a.e[2][2], p.z, out.z);
+		return out;
+	}
+
+	//? Multiplication when Vec3 is 3D vector (w=0), translation column is skipped
+	inline Vec3x8 mul_vec(const Trans4_Wide &a, const Vec3x8 v)
+	{
+		Vec3x8 out;
+		out.x = _mm256_mul_ps(a.e[0][0], v.x);
+		out.y = _mm256_mul_ps(a.e[0][1], v.x);
+		out.z = _mm256_mul_ps(a.e[0][2], v.x);
+		out.x = _mm256_fmadd_ps(a.e[1][0], v.y, out.x);
+		out.y = _mm256_fmadd_ps(a.e[1][1], v.y, out.y);
+		out.z = _mm256_fmadd_ps(a.e[1][2], v.y, out.z);
+		out.x = _mm256_fmadd_ps(a.e[2][0], v.z, out.x);
+		out.y = _mm256_fmadd_ps(a.e[2][1], v.z, out.y);
+		out.z = _mm256_fmadd_ps(a.e[2][2], v.z, out.z);
+		return out;
+	}
+
+	// ===============================================================================================================================
+	// ===================================================== BATCH INVERSE ===========================================================
+	// ===============================================================================================================================
+	//? 256-bit versions of 2x2 block helpers of "inverse(Mat4)", every shuffle they use is in-lane, so each 128-bit half
+	//? runs the 128-bit algorithm on its own matrix
+	inline __m256 mat2_mul(const __m256 a, const __m256 b)
+	{
+		return _mm256_add_ps(_mm256_mul_ps(a, _mm256_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 3, 0))),
+		                     _mm256_mul_ps(_mm256_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm256_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+	}
+
+	inline __m256 mat2_adj_mul(const __m256 a, const __m256 b)
+	{
+		return _mm256_sub_ps(_mm256_mul_ps(_mm256_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 3, 3)), b),
+		                     _mm256_mul_ps(_mm256_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 1, 1)), _mm256_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2))));
+	}
+
+	inline __m256 mat2_mul_adj(const __m256 a, const __m256 b)
+	{
+		return _mm256_sub_ps(_mm256_mul_ps(a, _mm256_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 0, 3))),
+		                     _mm256_mul_ps(_mm256_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm256_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+	}
+
+	//? Two matrices per iteration (one per 128-bit half), odd last one goes through "inverse(Mat4)". "in" and "out" may alias.
+	//! Same as "inverse(Mat4)": singular matrices are not checked
+	inline void inverse(const Mat4 *in, Mat4 *out, u32 count)
+	{
+		u32 i = 0;
+		for (; i + 2 <= count; i += 2)
+		{
+			__m256 c0 = _mm256_insertf128_ps(_mm256_castps128_ps256(in[i].columns[0]), in[i + 1].columns[0], 1);
+			__m256 c1 = _mm256_insertf128_ps(_mm256_castps128_ps256(in[i].columns[1]), in[i + 1].columns[1], 1);
+			__m256 c2 = _mm256_insertf128_ps(_mm256_castps128_ps256(in[i].columns[2]), in[i + 1].columns[2], 1);
+			__m256 c3 = _mm256_insertf128_ps(_mm256_castps128_ps256(in[i].columns[3]), in[i + 1].columns[3], 1);
+
+			__m256 A = _mm256_shuffle_ps(c0, c1, _MM_SHUFFLE(1, 0, 1, 0));
+			__m256 B = _mm256_shuffle_ps(c0, c1, _MM_SHUFFLE(3, 2, 3, 2));
+			__m256 C = _mm256_shuffle_ps(c2, c3, _MM_SHUFFLE(1, 0, 1, 0));
+			__m256 D = _mm256_shuffle_ps(c2, c3, _MM_SHUFFLE(3, 2, 3, 2));
+
+			__m256 det_sub = _mm256_sub_ps(
+				_mm256_mul_ps(_mm256_shuffle_ps(c0, c2, _MM_SHUFFLE(2, 0, 2, 0)), _mm256_shuffle_ps(c1, c3, _MM_SHUFFLE(3, 1, 3, 1))),
+				_mm256_mul_ps(_mm256_shuffle_ps(c0, c2, _MM_SHUFFLE(3, 1, 3, 1)), _mm256_shuffle_ps(c1, c3, _MM_SHUFFLE(2, 0, 2, 0))));
+			__m256 det_a = _mm256_shuffle_ps(det_sub, det_sub, _MM_SHUFFLE(0, 0, 0, 0));
+			__m256 det_b = _mm256_shuffle_ps(det_sub, det_sub, _MM_SHUFFLE(1, 1, 1, 1));
+			__m256 det_c = _mm256_shuffle_ps(det_sub, det_sub, _MM_SHUFFLE(2, 2, 2, 2));
+			__m256 det_d = _mm256_shuffle_ps(det_sub, det_sub, _MM_SHUFFLE(3, 3, 3, 3));
+
+			__m256 d_c = mat2_adj_mul(D, C);
+			__m256 a_b = mat2_adj_mul(A, B);
+			__m256 x = _mm256_sub_ps(_mm256_mul_ps(det_d, A), mat2_mul(B, d_c));
+			__m256 w = _mm256_sub_ps(_mm256_mul_ps(det_a, D), mat2_mul(C, a_b));
+			__m256 y = _mm256_sub_ps(_mm256_mul_ps(det_b, C), mat2_mul_adj(D, a_b));
+			__m256 z = _mm256_sub_ps(_mm256_mul_ps(det_c, B), mat2_mul_adj(A, d_c));
+
+			__m256 tr = _mm256_mul_ps(a_b, _mm256_shuffle_ps(d_c, d_c, _MM_SHUFFLE(3, 1, 2, 0)));
+			tr = _mm256_hadd_ps(tr, tr);
+			tr = _mm256_hadd_ps(tr, tr);
+			__m256 det = _mm256_sub_ps(_mm256_add_ps(_mm256_mul_ps(det_a, det_d), _mm256_mul_ps(det_b, det_c)), tr);
+			__m256 scale = _mm256_div_ps(_mm256_setr_ps(1.0f, -1.0f, -1.0f, 1.0f, 1.0f, -1.0f, -1.0f, 1.0f), det);
+
+			x = _mm256_mul_ps(x, scale);
+			y = _mm256_mul_ps(y, scale);
+			z = _mm256_mul_ps(z, scale);
+			w = _mm256_mul_ps(w, scale);
+			c0 = _mm256_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3));
+			c1 = _mm256_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2));
+			c2 = _mm256_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3));
+			c3 = _mm256_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2));
+
+			out[i].columns[0] = _mm256_castps256_ps128(c0);
+			out[i].columns[1] = _mm256_castps256_ps128(c1);
+			out[i].columns[2] = _mm256_castps256_ps128(c2);
+			out[i].columns[3] = _mm256_castps256_ps128(c3);
+			out[i + 1].columns[0] = _mm256_extractf128_ps(c0, 1);
+			out[i + 1].columns[1] = _mm256_extractf128_ps(c1, 1);
+			out[i + 1].columns[2] = _mm256_extractf128_ps(c2, 1);
+			out[i + 1].columns[3] = _mm256_extractf128_ps(c3, 1);
+		}
+
+		if (i < count)
+			out[i] = inverse(in[i]);
+	}
+
+	//? Normal matrices of many instances, see "normal_matrix(Trans4)"
+	inline void normal_matrix(const Trans4 *in, Trans4 *out, u32 count)
+	{
+		for (u32 i = 0; i < count; ++i)
+			out[i] = normal_matrix(in[i]);
+	}
+
+	// ===============================================================================================================================
+	// ========================================================= QUATX8 ==============================================================
+	// ===============================================================================================================================
+	//? 8 quaternions, Hamilton product and conventions of "Quat"
+	struct Quatx8
+	{
+		__m256 x, y, z, w;
+	};
+
+	struct DualQuatx8
+	{
+		Quatx8 real;
+		Quatx8 dual;
+	};
+
+	inline Quatx8 splat(const Quat a) { return { _mm256_set1_ps(a.x), _mm256_set1_ps(a.y), _mm256_set1_ps(a.z), _mm256_set1_ps(a.w) }; }
+
+	inline Quatx8 select(const __m256 mask, const Quatx8 a, const Quatx8 b)
+	{
+		return { select(mask, a.x, b.x), select(mask, a.y, b.y), select(mask, a.z, b.z), select(mask, a.w, b.w) };
+	}
+
+	inline Quatx8 operator-(const Quatx8 a)
+	{
+		__m256 sign = _mm256_set1_ps(-0.0f);
+		return { _mm256_xor_ps(a.x, sign), _mm256_xor_ps(a.y, sign), _mm256_xor_ps(a.z, sign), _mm256_xor_ps(a.w, sign) };
+	}
+
+	inline Quatx8 operator+(const Quatx8 a, const Quatx8 b)
+	{
+		return { _mm256_add_ps(a.x, b.x), _mm256_add_ps(a.y, b.y), _mm256_add_ps(a.z, b.z), _mm256_add_ps(a.w, b.w) };
+	}
+
+	inline Quatx8 operator-(const Quatx8 a, const Quatx8 b)
+	{
+		return { _mm256_sub_ps(a.x, b.x), _mm256_sub_ps(a.y, b.y), _mm256_sub_ps(a.z, b.z), _mm256_sub_ps(a.w, b.w) };
+	}
+
+	//? Per lane scalar
+	inline Quatx8 operator*(const __m256 t, const Quatx8 b)
+	{
+		return { _mm256_mul_ps(t, b.x), _mm256_mul_ps(t, b.y), _mm256_mul_ps(t, b.z), _mm256_mul_ps(t, b.w) };
+	}
+
+	inline Quatx8 operator*(const Quatx8 b, const __m256 t)
+	{
+		return t * b;
+	}
+
+	//? Vector part: a.w*b.xyz + b.w*a.xyz + cross(a.xyz, b.xyz), scalar part: a.w*b.w - dot(a.xyz, b.xyz)
+	inline Quatx8 operator*(const Quatx8 a, const Quatx8 b)
+	{
+		Quatx8 out;
+		out.x = _mm256_fmadd_ps(a.w, b.x, _mm256_fmadd_ps(a.x, b.w, _mm256_fmsub_ps(a.y, b.z, _mm256_mul_ps(a.z, b.y))));
+		out.y = _mm256_fmadd_ps(a.w, b.y, _mm256_fmadd_ps(a.y, b.w, _mm256_fmsub_ps(a.z, b.x, _mm256_mul_ps(a.x, b.z))));
+		out.z = _mm256_fmadd_ps(a.w, b.z, _mm256_fmadd_ps(a.z, b.w, _mm256_fmsub_ps(a.x, b.y, _mm256_mul_ps(a.y, b.x))));
+		out.w = _mm256_fmsub_ps(a.w, b.w, _mm256_fmadd_ps(a.x, b.x, _mm256_fmadd_ps(a.y, b.y, _mm256_mul_ps(a.z, b.z))));
+		return out;
+	}
+
+	inline __m256 dot(const Quatx8 a, const Quatx8 b)
+	{
+		__m256 out = _mm256_mul_ps(a.x, b.x);
+		out = _mm256_fmadd_ps(a.y, b.y, out);
+		out = _mm256_fmadd_ps(a.z, b.z, out);
+		return _mm256_fmadd_ps(a.w, b.w, out);
+	}
+
+	inline __m256 length_quat(const Quatx8 a)
+	{
+		return _mm256_sqrt_ps(dot(a, a));
+	}
+
+	inline Quatx8 conjugate(const Quatx8 a)
+	{
+		__m256 sign = _mm256_set1_ps(-0.0f);
+		return { _mm256_xor_ps(a.x, sign), _mm256_xor_ps(a.y, sign), _mm256_xor_ps(a.z, sign), a.w };
+	}
+
+	//? Zero quaternion lanes stay 0 like in scalar version
+	inline Quatx8 normalize(const Quatx8 a)
+	{
+		__m256 length = length_quat(a);
+		__m256 is_zero = _mm256_cmp_ps(length, _mm256_setzero_ps(), _CMP_EQ_OQ);
+		return _mm256_andnot_ps(is_zero, _mm256_div_ps(_mm256_set1_ps(1.0f), length)) * a;
+	}
+
+	inline Vec3x8 rotate(const Quatx8 q, const Vec3x8 v)
+	{
+		Vec3x8 axis{ q.x, q.y, q.z };
+		Vec3x8 t = 2.0f * cross(axis, v);
+		return v + q.w * t + cross(axis, t);
+	}
+
+	//? "b" with sign flipped in lanes where it is on the other hemisphere than "a", and |dot(a, b)| in "abs_dot"
+	inline Quatx8 shorter_arc(const Quatx8 a, const Quatx8 b, __m256 *abs_dot)
+	{
+		__m256 d = dot(a, b);
+		__m256 sign = _mm256_and_ps(d, _mm256_set1_ps(-0.0f));
+		*abs_dot = _mm256_xor_ps(d, sign);
+		return { _mm256_xor_ps(b.x, sign), _mm256_xor_ps(b.y, sign), _mm256_xor_ps(b.z, sign), _mm256_xor_ps(b.w, sign) };
+	}
+
+	inline Quatx8 nlerp(const Quatx8 a, const Quatx8 b, const __m256 t)
+	{
+		__m256 abs_dot;
+		Quatx8 end = shorter_arc(a, b, &abs_dot);
+		return normalize(a + t * (end - a));
+	}
+
+	//? Same series as "slerp_weights" of "Math.hpp", FMA + mul + FMA per term and no branches
+	inline __m256 slerp_weights(const __m256 t, const __m256 cos_minus_one)
+	{
+		__m256 t_squared = _mm256_mul_ps(t, t);
+		__m256 one = _mm256_set1_ps(1.0f);
+		__m256 out = one;
+		for (u32 i = SLERP_SERIES_TERMS; i > 0; --i)
+		{
+			__m256 b = _mm256_mul_ps(_mm256_fmsub_ps(_mm256_set1_ps(SLERP_SERIES.u[i]), t_squared, _mm256_set1_ps(SLERP_SERIES.v[i])), cos_minus_one);
+			out = _mm256_fmadd_ps(b, out, one);
+		}
+		return _mm256_mul_ps(t, out);
+	}
+
+	inline Quatx8 slerp(const Quatx8 a, const Quatx8 b, const __m256 t)
+	{
+		__m256 abs_dot;
+		Quatx8 end = shorter_arc(a, b, &abs_dot);
+		__m256 cos_minus_one = _mm256_sub_ps(abs_dot, _mm256_set1_ps(1.0f));
+		__m256 weight_a = slerp_weights(_mm256_sub_ps(_mm256_set1_ps(1.0f), t), cos_minus_one);
+		__m256 weight_b = slerp_weights(t, cos_minus_one);
+		return weight_a * a + weight_b * end;
+	}
+
+	inline DualQuatx8 operator*(const DualQuatx8 a, const DualQuatx8 b)
+	{
+		return { a.real * b.real, a.real * b.dual + a.dual * b.real };
+	}
+
+	inline DualQuatx8 normalize(const DualQuatx8 a)
+	{
+		__m256 r_length = _mm256_div_ps(_mm256_set1_ps(1.0f), length_quat(a.real));
+		Quatx8 real = r_length * a.real;
+		Quatx8 dual = r_length * a.dual;
+		return { real, dual - dot(real, dual) * real };
+	}
+
+	inline Vec3x8 get_translation(const DualQuatx8 a)
+	{
+		Quatx8 t = a.dual * conjugate(a.real);
+		__m256 two = _mm256_set1_ps(2.0f);
+		return { _mm256_mul_ps(two, t.x), _mm256_mul_ps(two, t.y), _mm256_mul_ps(two, t.z) };
+	}
+
+	inline Vec3x8 mul_point(const DualQuatx8 a, const Vec3x8 p)
+	{
+		return rotate(a.real, p) + get_translation(a);
+	}
+
+	inline Vec3x8 mul_vec(const DualQuatx8 a, const Vec3x8 v)
+	{
+		return rotate(a.real, v);
+	}
+
+	//? Dual quaternion linear blending, see scalar "nlerp(DualQuat)"
+	inline DualQuatx8 nlerp(const DualQuatx8 a, const DualQuatx8 b, const __m256 t)
+	{
+		__m256 sign = _mm256_and_ps(dot(a.real, b.real), _mm256_set1_ps(-0.0f));
+		__m256 weight_a = _mm256_sub_ps(_mm256_set1_ps(1.0f), t);
+		__m256 weight_b = _mm256_xor_ps(t, sign);
+		return normalize(DualQuatx8{ weight_a * a.real + weight_b * b.real, weight_a * a.dual + weight_b * b.dual });
+	}
+
+	// ===============================================================================================================================
+	// =================================================== BATCH QUATERNIONS =========================================================
+	// ===============================================================================================================================
+	//? SoA arrays of rotations / rigid transforms (bones, instances), element "i" is (x[i], y[i], z[i], w[i]).
+	//? Last "count % 8" elements are done with masked loads/stores, nothing is touched past "count".
+	//? Outputs may alias inputs, every element is read before it is written.
+	struct Quat_Stream
+	{
+		f32 *x;
+		f32 *y;
+		f32 *z;
+		f32 *w;
+	};
+
+	struct DualQuat_Stream
+	{
+		Quat_Stream real;
+		Quat_Stream dual;
+	};
+
+	inline Quatx8 load_quatx8(const Quat_Stream &in, const u32 i, const __m256 mask, const b32 is_tail)
+	{
+		Vec4x8 v = is_tail ? load_vec4x8_masked(in.x + i, in.y + i, in.z + i, in.w + i, mask) : load_vec4x8(in.x + i, in.y + i, in.z + i, in.w + i);
+		return { v.x, v.y, v.z, v.w };
+	}
+
+	inline DualQuatx8 load_dual_quatx8(const DualQuat_Stream &in, const u32 i, const __m256 mask, const b32 is_tail)
+	{
+		return { load_quatx8(in.real, i, mask, is_tail), load_quatx8(in.dual, i, mask, is_tail) };
+	}
+
+	inline __m256 load_scalarx8(const f32 *in, const u32 i, const __m256 mask, const b32 is_tail)
+	{
+		return is_tail ? _mm256_maskload_ps(in + i, _mm256_castps_si256(mask)) : _mm256_loadu_ps(in + i);
+	}
+
+	inline void store(const Quat_Stream &out, const u32 i, const Quatx8 q, const __m256 mask, const b32 is_tail)
+	{
+		if (is_tail)
+			store_masked(out.x + i, out.y + i, out.z + i, out.w + i, Vec4x8{ q.x, q.y, q.z, q.w }, mask);
+		else
+			store(out.x + i, out.y + i, out.z + i, out.w + i, Vec4x8{ q.x, q.y, q.z, q.w });
+	}
+
+	inline void store(const DualQuat_Stream &out, const u32 i, const DualQuatx8 q, const __m256 mask, const b32 is_tail)
+	{
+		store(out.real, i, q.real, mask, is_tail);
+		store(out.dual, i, q.dual, mask, is_tail);
+	}
+
+	//? "body(i, mask, is_tail)" for every 8 elements, mask is only valid for the tail
+	template <typename Body>
+	inline void quat_batch_loop(const u32 count, const Body &body)
+	{
+		u32 i = 0;
+		for (; i + WIDE_LANES <= count; i += WIDE_LANES)
+			body(i, __m256{}, false);
+		if (i < count)
+			body(i, lane_mask(count - i), true);
+	}
+
+	//? Per element "t", e.g. every bone between its own two keys
+	inline void slerp(const Quat_Stream &a, const Quat_Stream &b, const f32 *t, const Quat_Stream &out, const u32 count)
+	{
+		quat_batch_loop(count, [&](u32 i, __m256 mask, b32 is_tail)
+		{
+			store(out, i, slerp(load_quatx8(a, i, mask, is_tail), load_quatx8(b, i, mask, is_tail), load_scalarx8(t, i, mask, is_tail)), mask, is_tail);
+		});
+	}
+
+	//? One "t" for every element, e.g. cross-fade of two poses
+	inline void slerp(const Quat_Stream &a, const Quat_Stream &b, const f32 t, const Quat_Stream &out, const u32 count)
+	{
+		__m256 t8 = _mm256_set1_ps(t);
+		quat_batch_loop(count, [&](u32 i, __m256 mask, b32 is_tail)
+		{
+			store(out, i, slerp(load_quatx8(a, i, mask, is_tail), load_quatx8(b, i, mask, is_tail), t8), mask, is_tail);
+		});
+	}
+
+	inline void nlerp(const Quat_Stream &a, const Quat_Stream &b, const f32 *t, const Quat_Stream &out, const u32 count)
+	{
+		quat_batch_loop(count, [&](u32 i, __m256 mask, b32 is_tail)
+		{
+			store(out, i, nlerp(load_quatx8(a, i, mask, is_tail), load_quatx8(b, i, mask, is_tail), load_scalarx8(t, i, mask, is_tail)), mask, is_tail);
+		});
+	}
+
+	inline void nlerp(const Quat_Stream &a, const Quat_Stream &b, const f32 t, const Quat_Stream &out, const u32 count)
+	{
+		__m256 t8 = _mm256_set1_ps(t);
+		quat_batch_loop(count, [&](u32 i, __m256 mask, b32 is_tail)
+		{
+			store(out, i, nlerp(load_quatx8(a, i, mask, is_tail), load_quatx8(b, i, mask, is_tail), t8), mask, is_tail);
+		});
+	}
+
+	inline void nlerp(const DualQuat_Stream &a, const DualQuat_Stream &b, const f32 *t, const DualQuat_Stream &out, const u32 count)
+	{
+		quat_batch_loop(count, [&](u32 i, __m256 mask, b32 is_tail)
+		{
+			store(out, i, nlerp(load_dual_quatx8(a, i, mask, is_tail), load_dual_quatx8(b, i, mask, is_tail), load_scalarx8(t, i, mask, is_tail)), mask, is_tail);
+		});
+	}
+
+	//? Parent * local for every element, e.g. local to model space of one hierarchy level
+	inline void mul(const DualQuat_Stream &a, const DualQuat_Stream &b, const DualQuat_Stream &out, const u32 count)
+	{
+		quat_batch_loop(count, [&](u32 i, __m256 mask, b32 is_tail)
+		{
+			store(out, i, load_dual_quatx8(a, i, mask, is_tail) * load_dual_quatx8(b, i, mask, is_tail), mask, is_tail);
+		});
+	}
+
+	//? Columns (x, y, z, w) of 8 SoA matrices into "count" (at most 8) AoS matrices, 4x4 transposes per 128-bit half
+	inline void store_column_aos(Trans4 *out, const u32 column, const __m256 x, const __m256 y, const __m256 z, const __m256 w, const u32 count)
+	{
+		__m256 xy_lo = _mm256_unpacklo_ps(x, y);
+		__m256 xy_hi = _mm256_unpackhi_ps(x, y);
+		__m256 zw_lo = _mm256_unpacklo_ps(z, w);
+		__m256 zw_hi = _mm256_unpackhi_ps(z, w);
+		__m256 c[4] = {
+			_mm256_shuffle_ps(xy_lo, zw_lo, _MM_SHUFFLE(1, 0, 1, 0)), // elements 0, 4
+			_mm256_shuffle_ps(xy_lo, zw_lo, _MM_SHUFFLE(3, 2, 3, 2)), // elements 1, 5
+			_mm256_shuffle_ps(xy_hi, zw_hi, _MM_SHUFFLE(1, 0, 1, 0)), // elements 2, 6
+			_mm256_shuffle_ps(xy_hi, zw_hi, _MM_SHUFFLE(3, 2, 3, 2)), // elements 3, 7
+		};
+		for (u32 k = 0; k < 4 && k < count; ++k)
+			out[k].columns[column] = _mm256_castps256_ps128(c[k]);
+		for (u32 k = 4; k < count; ++k)
+			out[k].columns[column] = _mm256_extractf128_ps(c[k - 4], 1);
+	}
+
+	//? Rotation matrices of 8 unit quaternions as SoA columns, same formula as "create_transform(Quat)"
+	inline void create_rotation_columns(const Quatx8 q, Vec3x8 columns[3])
+	{
+		__m256 one = _mm256_set1_ps(1.0f);
+		__m256 two = _mm256_set1_ps(2.0f);
+		__m256 x2 = _mm256_mul_ps(q.x, two), y2 = _mm256_mul_ps(q.y, two), z2 = _mm256_mul_ps(q.z, two);
+		__m256 xx = _mm256_mul_ps(q.x, x2), yy = _mm256_mul_ps(q.y, y2), zz = _mm256_mul_ps(q.z, z2);
+		__m256 xy = _mm256_mul_ps(q.x, y2), xz = _mm256_mul_ps(q.x, z2), yz = _mm256_mul_ps(q.y, z2);
+		__m256 wx = _mm256_mul_ps(q.w, x2), wy = _mm256_mul_ps(q.w, y2), wz = _mm256_mul_ps(q.w, z2);
+
+		columns[0] = { _mm256_sub_ps(one, _mm256_add_ps(yy, zz)), _mm256_add_ps(xy, wz), _mm256_sub_ps(xz, wy) };
+		columns[1] = { _mm256_sub_ps(xy, wz), _mm256_sub_ps(one, _mm256_add_ps(xx, zz)), _mm256_add_ps(yz, wx) };
+		columns[2] = { _mm256_add_ps(xz, wy), _mm256_sub_ps(yz, wx), _mm256_sub_ps(one, _mm256_add_ps(xx, yy)) };
+	}
+
+	//? AoS matrices for consumers that want them (skinning palettes, "Trans4_Wide" broadcasts), 8 per iteration
+	inline void create_transform(const Quat_Stream &in, Trans4 *out, const u32 count)
+	{
+		__m256 zero = _mm256_setzero_ps();
+		__m256 one = _mm256_set1_ps(1.0f);
+		quat_batch_loop(count, [&](u32 i, __m256 mask, b32 is_tail)
+		{
+			Vec3x8 c[3];
+			create_rotation_columns(load_quatx8(in, i, mask, is_tail), c);
+			u32 n = lib::min(count - i, WIDE_LANES);
+			store_column_aos(out + i, 0, c[0].x, c[0].y, c[0].z, zero, n);
+			store_column_aos(out + i, 1, c[1].x, c[1].y, c[1].z, zero, n);
+			store_column_aos(out + i, 2, c[2].x, c[2].y, c[2].z, zero, n);
+			store_column_aos(out + i, 3, zero, zero, zero, one, n);
+		});
+	}
+
+	inline void create_transform(const DualQuat_Stream &in, Trans4 *out, const u32 count)
+	{
+		__m256 zero = _mm256_setzero_ps();
+		__m256 one = _mm256_set1_ps(1.0f);
+		quat_batch_loop(count, [&](u32 i, __m256 mask, b32 is_tail)
+		{
+			DualQuatx8 q = load_dual_quatx8(in, i, mask, is_tail);
+			Vec3x8 c[3];
+			create_rotation_columns(q.real, c);
+			Vec3x8 t = get_translation(q);
+			u32 n = lib::min(count - i, WIDE_LANES);
+			store_column_aos(out + i, 0, c[0].x, c[0].y, c[0].z, zero, n);
+			store_column_aos(out + i, 1, c[1].x, c[1].y, c[1].z, zero, n);
+			store_column_aos(out + i, 2, c[2].x, c[2].y, c[2].z, zero, n);
+			store_column_aos(out + i, 3, t.x, t.y, t.z, one, n);
+		});
+	}
+
+	// ===============================================================================================================================
+	// ===================================================== TRANSCENDENTALS =========================================================
+	// ===============================================================================================================================
+	//? Range reduction + polynomial, no tables, no branches, 8 lanes per call. Polynomials of Accurate variants are
+	//? Cephes ones (sin, cos, log, atan), the rest are minimax fits (relative error, Lawson's iteration over Chebyshev
+	//? nodes). Errors below are max of a dense sweep (4M points) of the stated range against double precision libm,
+	//? "ulp" is ulp of the correct result.
+	//! Inputs outside of documented domains are not checked, NaN and inf inputs give garbage unless stated otherwise
+
+	//? x = j * pi/2 + r, r in [-pi/4, pi/4]. Accurate: pi/2 in 3 parts with FMA (Cody-Waite), exact for |j| up to 2^12
+	//? and still ~1e-7 absolute at |x| = 1e5. Fast: 2 parts, error grows ~|x| * 1e-11
+	template <Precision P>
+	inline __m256 sincos_reduce(const __m256 x, __m256i *quadrant)
+	{
+		__m256 j = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(0.636619772f)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+		*quadrant = _mm256_cvtps_epi32(j);
+		__m256 r;
+		if constexpr (P == Precision::Accurate)
+		{
+			r = _mm256_fnmadd_ps(j, _mm256_set1_ps(1.5703125f), x);
+			r = _mm256_fnmadd_ps(j, _mm256_set1_ps(4.83751297e-4f), r);
+			r = _mm256_fnmadd_ps(j, _mm256_set1_ps(7.54979013e-8f), r);
+		}
+		else
+		{
+			r = _mm256_fnmadd_ps(j, _mm256_set1_ps(1.57079637f), x);
+			r = _mm256_fnmadd_ps(j, _mm256_set1_ps(-4.37113883e-8f), r);
+		}
+		return r;
+	}
+
+	//? sin(r) and cos(r) for r in [-pi/4, pi/4]
+	template <Precision P>
+	inline void sincos_poly(const __m256 r, __m256 *sin_r, __m256 *cos_r)
+	{
+		__m256 r2 = _mm256_mul_ps(r, r);
+		__m256 s, c;
+		if constexpr (P == Precision::Accurate)
+		{
+			s = _mm256_fmadd_ps(_mm256_set1_ps(-1.9515295891e-4f), r2, _mm256_set1_ps(8.3321608736e-3f));
+			s = _mm256_fmadd_ps(s, r2, _mm256_set1_ps(-1.6666654611e-1f));
+			c = _mm256_fmadd_ps(_mm256_set1_ps(2.443315711809948e-5f), r2, _mm256_set1_ps(-1.388731625493765e-3f));
+			c = _mm256_fmadd_ps(c, r2, _mm256_set1_ps(4.166664568298827e-2f));
+			c = _mm256_fmadd_ps(c, r2, _mm256_set1_ps(-0.5f));
+		}
+		else
+		{
+			s = _mm256_fmadd_ps(_mm256_set1_ps(8.16327978e-3f), r2, _mm256_set1_ps(-0.166633903f));
+			c = _mm256_fmadd_ps(_mm256_set1_ps(4.04584375e-2f), r2, _mm256_set1_ps(-0.499760551f));
+		}
+		*sin_r = _mm256_fmadd_ps(_mm256_mul_ps(s, r2), r, r);
+		*cos_r = _mm256_fmadd_ps(c, r2, _mm256_set1_ps(1.0f));
+	}
+
+	//? Both at the cost of one. Quadrant picks sin or cos of the reduced argument and the sign:
+	//? sin(x) = (sin r, cos r, -sin r, -cos r)[j & 3], cos(x) = (cos r, -sin r, -cos r, sin r)[j & 3]
+	//? Accurate: max error 1.5 ulp for |x| <= pi, 7e-8 absolute up to |x| = 1e5 (relative error grows around zeros
+	//? of far periods, reduction can not be better than rounding of x itself). Fast: 1.4e-5 absolute for |x| <= 1e4
+	template <Precision P = Precision::Accurate>
+	inline void sincos(const __m256 x, __m256 *sin_x, __m256 *cos_x)
+	{
+		__m256i quadrant;
+		__m256 r = sincos_reduce<P>(x, &quadrant);
+		__m256 sin_r, cos_r;
+		sincos_poly<P>(r, &sin_r, &cos_r);
+
+		__m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(quadrant, _mm256_set1_epi32(1)), _mm256_set1_epi32(1)));
+		__m256 sin_sign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(quadrant, _mm256_set1_epi32(2)), 30));
+		__m256 cos_sign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(quadrant, _mm256_set1_epi32(1)), _mm256_set1_epi32(2)), 30));
+		*sin_x = _mm256_xor_ps(select(swap, cos_r, sin_r), sin_sign);
+		*cos_x = _mm256_xor_ps(select(swap, sin_r, cos_r), cos_sign);
+	}
+
+	template <Precision P = Precision::Accurate>
+	inline __m256 sin(const __m256 x)
+	{
+		__m256 sin_x, cos_x;
+		sincos<P>(x, &sin_x, &cos_x);
+		return sin_x;
+	}
+
+	template <Precision P = Precision::Accurate>
+	inline __m256 cos(const __m256 x)
+	{
+		__m256 sin_x, cos_x;
+		sincos<P>(x, &sin_x, &cos_x);
+		return cos_x;
+	}
+
+	//? 2^x = 2^n * 2^f, n = round(x), f in [-0.5, 0.5], 2^n is built in the exponent bits.
+	//? Accurate: degree 6 polynomial, max error 0.93 ulp. Fast: degree 3, max relative error 1e-4.
+	//? x is clamped to [-127, 127.5): results below 2^-126 are 0 (no denormals), -inf gives 0, results saturate at 2^127.5
+	template <Precision P = Precision::Accurate>
+	inline __m256 exp2(const __m256 x)
+	{
+		__m256 clamped = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(-127.0f)), _mm256_set1_ps(127.499985f));
+		__m256 n = _mm256_round_ps(clamped, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+		__m256 f = _mm256_sub_ps(clamped, n);
+
+		__m256 p;
+		if constexpr (P == Precision::Accurate)
+		{
+			p = _mm256_fmadd_ps(_mm256_set1_ps(1.53533602e-4f), f, _mm256_set1_ps(1.33988753e-3f));
+			p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(9.61843737e-3f));
+			p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(5.55033247e-2f));
+			p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(0.240226479f));
+			p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(0.693147203f));
+		}
+		else
+		{
+			p = _mm256_fmadd_ps(_mm256_set1_ps(5.50089372e-2f), f, _mm256_set1_ps(0.242211018f));
+			p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(0.693282933f));
+		}
+		p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(1.0f));
+
+		__m256i exponent = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)), 23);
+		return _mm256_mul_ps(p, _mm256_castsi256_ps(exponent));
+	}
+
+	//? log2(x) = e + log2(m), e is the exponent and m the mantissa moved into [sqrt(0.5), sqrt(2)).
+	//? Accurate: ln(1 + f) = f - f^2/2 + f^3 * P(f), f = m - 1, with P of Cephes "logf" (degree 8, no division), then
+	//? times log2(e) in two parts, max error 1 ulp for x in [0.5, 2] (all of them for bigger |log2(x)|).
+	//? Fast: 2/ln(2) * (s + s^3/3), s = (m - 1) / (m + 1) with _mm256_rcp_ps, max absolute error 2.1e-4
+	//! Positive normal x only: 0 and denormals give ~-127 (not -inf), negative x gives garbage
+	template <Precision P = Precision::Accurate>
+	inline __m256 log2(const __m256 x)
+	{
+		__m256i bits = _mm256_castps_si256(x);
+		__m256 m = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007FFFFF)), _mm256_set1_epi32(0x3F800000)));
+		__m256 e = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(127)));
+
+		__m256 is_big = _mm256_cmp_ps(m, _mm256_set1_ps(1.41421356f), _CMP_GT_OQ);
+		m = select(is_big, _mm256_mul_ps(m, _mm256_set1_ps(0.5f)), m);
+		e = _mm256_add_ps(e, _mm256_and_ps(is_big, _mm256_set1_ps(1.0f)));
+		__m256 f = _mm256_sub_ps(m, _mm256_set1_ps(1.0f));
+
+		if constexpr (P == Precision::Accurate)
+		{
+			__m256 f2 = _mm256_mul_ps(f, f);
+			__m256 p = _mm256_fmadd_ps(_mm256_set1_ps(7.0376836292e-2f), f, _mm256_set1_ps(-1.1514610310e-1f));
+			p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(1.1676998740e-1f));
+			p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(-1.2420140846e-1f));
+			p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(1.4249322787e-1f));
+			p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(-1.6668057665e-1f));
+			p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(2.0000714765e-1f));
+			p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(-2.4999993993e-1f));
+			p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(3.3333331174e-1f));
+			// y = ln(1 + f) - f, then log2(1 + f) = (f + y) * log2(e) with log2(e) = hi + lo so f keeps full precision
+			__m256 y = _mm256_fmadd_ps(_mm256_set1_ps(-0.5f), f2, _mm256_mul_ps(_mm256_mul_ps(p, f2), f));
+			__m256 log_m = _mm256_fmadd_ps(f, _mm256_set1_ps(1.44269502f), _mm256_fmadd_ps(f, _mm256_set1_ps(1.92596303e-8f), _mm256_mul_ps(y, _mm256_set1_ps(1.44269504f))));
+			return _mm256_add_ps(e, log_m);
+		}
+		else
+		{
+			__m256 s = _mm256_mul_ps(f, _mm256_rcp_ps(_mm256_add_ps(m, _mm256_set1_ps(1.0f))));
+			__m256 s2 = _mm256_mul_ps(s, s);
+			__m256 log_m = _mm256_mul_ps(_mm256_fmadd_ps(s2, _mm256_set1_ps(0.961796701f), _mm256_set1_ps(2.88539004f)), s);
+			return _mm256_add_ps(e, log_m);
+		}
+	}
+
+	//? exp2(y * log2(x)), domain of "log2" applies. Error of the product scales with |y * log2(x)|, max relative error
+	//? over x in (0, 1] (specular, gamma): Accurate 6.6e-7 (~10 ulp) for y = 1 or 1/2.2, 3e-6 for y = 8..32,
+	//? 5e-6 up to y = 256. Fast 2.4e-4 for y = 1, 1.2e-3 for y = 8, 2e-2 for y = 256.
+	//? pow(0, y) is ~2^(-127 * y), which is 0 for y >= 1
+	template <Precision P = Precision::Accurate>
+	inline __m256 pow(const __m256 x, const __m256 y)
+	{
+		return exp2<P>(_mm256_mul_ps(y, log2<P>(x)));
+	}
+
+	//? Angle of (x, y) in [-pi, pi]. atan of t = min(|x|, |y|) / max(|x|, |y|) in [0, 1], then mirrored by octant.
+	//? Accurate: t above tan(pi/8) becomes (t - 1) / (t + 1) + pi/4 (still one division), Cephes polynomial,
+	//? max error 4 ulp (3e-7 relative). Fast: t * odd polynomial of degree 7 over [0, 1] and _mm256_rcp_ps,
+	//? max absolute error 3e-4.
+	//? atan2(0, 0) is 0
+	template <Precision P = Precision::Accurate>
+	inline __m256 atan2(const __m256 y, const __m256 x)
+	{
+		__m256 abs_x = abs(x), abs_y = abs(y);
+		__m256 high = _mm256_max_ps(abs_x, abs_y);
+		__m256 low = _mm256_min_ps(abs_x, abs_y);
+
+		__m256 r;
+		if constexpr (P == Precision::Accurate)
+		{
+			__m256 is_big = _mm256_cmp_ps(low, _mm256_mul_ps(high, _mm256_set1_ps(0.414213562f)), _CMP_GT_OQ);
+			__m256 numerator = select(is_big, _mm256_sub_ps(low, high), low);
+			__m256 denominator = select(is_big, _mm256_add_ps(low, high), high);
+			__m256 t = _mm256_div_ps(numerator, denominator);
+			t = _mm256_andnot_ps(_mm256_cmp_ps(high, _mm256_setzero_ps(), _CMP_EQ_OQ), t);
+
+			__m256 t2 = _mm256_mul_ps(t, t);
+			__m256 p = _mm256_fmadd_ps(_mm256_set1_ps(8.05374449538e-2f), t2, _mm256_set1_ps(-1.38776856032e-1f));
+			p = _mm256_fmadd_ps(p, t2, _mm256_set1_ps(1.99777106478e-1f));
+			p = _mm256_fmadd_ps(p, t2, _mm256_set1_ps(-3.33329491539e-1f));
+			r = _mm256_fmadd_ps(_mm256_mul_ps(p, t2), t, t);
+			r = _mm256_add_ps(r, _mm256_and_ps(is_big, _mm256_set1_ps(0.785398163f)));
+		}
+		else
+		{
+			__m256 t = _mm256_mul_ps(low, _mm256_rcp_ps(high));
+			t = _mm256_andnot_ps(_mm256_cmp_ps(high, _mm256_setzero_ps(), _CMP_EQ_OQ), t);
+
+			__m256 t2 = _mm256_mul_ps(t, t);
+			__m256 p = _mm256_fmadd_ps(_mm256_set1_ps(-4.43276289e-2f), t2, _mm256_set1_ps(0.155580713f));
+			p = _mm256_fmadd_ps(p, t2, _mm256_set1_ps(-0.325809518f));
+			p = _mm256_fmadd_ps(p, t2, _mm256_set1_ps(0.999787992f));
+			r = _mm256_mul_ps(p, t);
+		}
+
+		r = select(_mm256_cmp_ps(abs_y, abs_x, _CMP_GT_OQ), _mm256_sub_ps(_mm256_set1_ps(1.57079633f), r), r);
+		r = select(_mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_LT_OQ), _mm256_sub_ps(_mm256_set1_ps(3.14159265f), r), r);
+		return _mm256_xor_ps(r, _mm256_and_ps(y, _mm256_set1_ps(-0.0f)));
+	}
+}
+CPU_TARGET_END
@@ -0,0 +1,188 @@
+#pragma once
+//? -----------------------------------------------------------------------------------------------
+//? SCOPED HOT-PATH PROFILER: RDTSC TIMESTAMPS, ONE LOCK-FREE RING OF EVENTS PER THREAD (ONLY THE OWNING
+//? THREAD WRITES, NOTHING IS SHARED ON THE HOT PATH), EXPORT INTO CHROME TRACE / PERFETTO JSON.
+//? COMPILES OUT COMPLETELY UNLESS "PROFILER_ENABLED" IS 1 ("-Profile" BUILD), ZONE MACROS THEN EXPAND TO NOTHING.
+//? -----------------------------------------------------------------------------------------------
+
+//? Usage: "profiler_init" once on main thread before other threads start, "profiler_register_thread" at start of every
+//? thread that should have a readable name (unregistered threads register themselves lazily), "ProfileScope("name")"
+//? or "ProfileFunction()" in code, "profiler_export_chrome_trace" once all other threads are stopped.
+//? Rings wrap around, so export contains last "events_per_thread" zones of every thread.
+//! Zone names must be string literals (or outlive the export), only pointers are recorded
+
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 0
+#endif
+
+// Utils.hpp "internal" macro collides with identifiers inside of standard headers
+#pragma push_macro("internal")
+#undef internal
+#include <atomic>
+#include <chrono>
+#include <new>
+#pragma pop_macro("internal")
+
+#include <stdio.h>
+#include <cassert>
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+#include "Utils.hpp"
+
+constexpr u32 PROFILER_MAX_THREADS = 272; // job workers + main + present
+
+struct Profiler_Event
+{
+	const char *name;
+	u64 begin_tsc;
+	u64 end_tsc;
+};
+
+struct alignas(64) Profiler_Thread
+{
+	Profiler_Event *events; // ring of "events_per_thread"
+	std::atomic<u64> write_count;
+	char name[32];
+};
+
+struct Profiler
+{
+	Profiler_Thread *threads;
+	u32 max_threads;
+	u32 events_per_thread; // power of 2
+	std::atomic<u32> thread_count;
+
+	u64 tsc_start;
+	f64 tsc_per_us;
+};
+
+#if PROFILER_ENABLED
+
+inline Profiler g_profiler;
+inline thread_local Profiler_Thread *t_profiler_thread;
+
+inline u64 profiler_memory_size(u32 max_threads, u32 events_per_thread)
+{
+	return (u64)max_threads * (sizeof(Profiler_Thread) + sizeof(Profiler_Event) * events_per_thread + 128);
+}
+
+//? Measures TSC rate against steady clock for ~20ms, so timestamps can be exported in microseconds
+inline void profiler_init(auto *allocator, u32 max_threads, u32 events_per_thread)
+{
+	assert(max_threads <= PROFILER_MAX_THREADS);
+	assert((events_per_thread & (events_per_thread - 1)) == 0 && "Events per thread must be power of 2");
+
+	g_profiler.threads = (Profiler_Thread *)allocate(allocator, sizeof(Profiler_Thread) * max_threads, alignof(Profiler_Thread));
+	for (u32 i = 0; i < max_threads; ++i)
+	{
+		new (&g_profiler.threads[i]) Profiler_Thread{};
+		g_profiler.threads[i].events = (Profiler_Event *)allocate(allocator, sizeof(Profiler_Event) * events_per_thread, 64);
+	}
+	g_profiler.max_threads = max_threads;
+	g_profiler.events_per_thread = events_per_thread;
+	g_profiler.thread_count.store(0);
+
+	auto clock_start = std::chrono::steady_clock::now();
+	u64 tsc_start = __rdtsc();
+	while (std::chrono::steady_clock::now() - clock_start < std::chrono::milliseconds(20))
+		;
+	u64 tsc_end = __rdtsc();
+	f64 elapsed_us = std::chrono::duration<f64, std::micro>(std::chrono::steady_clock::now() - clock_start).count();
+
+	g_profiler.tsc_start = tsc_start;
+	g_profiler.tsc_per_us = (f64)(tsc_end - tsc_start) / elapsed_us;
+}
+
+//? Claims a ring for calling thread, returns false when all rings are taken (zones of that thread are dropped)
+inline b32 profiler_register_thread(const char *name)
+{
+	if (t_profiler_thread || !g_profiler.threads)
+		return t_profiler_thread != nullptr;
+
+	u32 id = g_profiler.thread_count.fetch_add(1, std::memory_order_relaxed);
+	if (id >= g_profiler.max_threads)
+		return false;
+
+	Profiler_Thread *thread = &g_profiler.threads[id];
+	snprintf(thread->name, sizeof(thread->name), "%s", name);
+	t_profiler_thread = thread;
+	return true;
+}
+
+inline void profiler_record(const char *name, u64 begin_tsc, u64 end_tsc)
+{
+	Profiler_Thread *thread = t_profiler_thread;
+	if (!thread)
+	{
+		if (!profiler_register_thread("Thread"))
+			return;
+		thread = t_profiler_thread;
+	}
+
+	u64 index = thread->write_count.load(std::memory_order_relaxed);
+	thread->events[index & (g_profiler.events_per_thread - 1)] = { name, begin_tsc, end_tsc };
+	thread->write_count.store(index + 1, std::memory_order_release);
+}
+
+struct Profiler_Scope
+{
+	const char *name;
+	u64 begin_tsc;
+
+	Profiler_Scope(const char *scope_name) : name(scope_name), begin_tsc(__rdtsc()) {}
+	~Profiler_Scope() { profiler_record(name, begin_tsc, __rdtsc()); }
+};
+
+#define ProfilerConcatInner(a, b) a##b
+#define ProfilerConcat(a, b) ProfilerConcatInner(a, b)
+#define ProfileScope(name) Profiler_Scope ProfilerConcat(profiler_scope_, __LINE__)(name)
+#define ProfileFunction() ProfileScope(__func__)
+
+//? Complete ("X") events of all threads, timestamps relative to "profiler_init".
+//! Other threads must not record while exporting
+inline b32 profiler_export_chrome_trace(const char *file_name)
+{
+	FILE *file = fopen(file_name, "wb");
+	if (!file)
+		return false;
+
+	fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	b32 is_first = true;
+	u32 thread_count = g_profiler.thread_count.load(std::memory_order_acquire);
+	thread_count = thread_count < g_profiler.max_threads ? thread_count : g_profiler.max_threads;
+	for (u32 tid = 0; tid < thread_count; ++tid)
+	{
+		Profiler_Thread *thread = &g_profiler.threads[tid];
+		fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+		        is_first ? "" : ",\n", tid, thread->name);
+		is_first = false;
+
+		u64 write_count = thread->write_count.load(std::memory_order_acquire);
+		u64 first = write_count > g_profiler.events_per_thread ? write_count - g_profiler.events_per_thread : 0;
+		for (u64 i = first; i < write_count; ++i)
+		{
+			const Profiler_Event *event = &thread->events[i & (g_profiler.events_per_thread - 1)];
+			f64 ts = (f64)(s64)(event->begin_tsc - g_profiler.tsc_start) / g_profiler.tsc_per_us;
+			f64 dur = (f64)(event->end_tsc - event->begin_tsc) / g_profiler.tsc_per_us;
+			fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", event->name, tid, ts, dur);
+		}
+	}
+	fprintf(file, "\n]}\n");
+	return fclose(file) == 0;
+}
+
+#else
+
+inline u64 profiler_memory_size(u32 max_threads, u32 events_per_thread) { return 0; }
+inline void profiler_init(auto *allocator, u32 max_threads, u32 events_per_thread) {}
+inline b32 profiler_register_thread(const char *name) { return false; }
+inline b32 profiler_export_chrome_trace(const char *file_name) { return false; }
+
+#define ProfileScope(name)
+#define ProfileFunction()
+
+#endif
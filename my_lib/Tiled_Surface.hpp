@@ -0,0 +1,124 @@
+#pragma once
+//? -----------------------------------------------------------------------------------------------
+//? TILED SURFACE LAYOUT: IMAGE IS STORED AS CONTIGUOUS 64x64 TILES IN ROW-MAJOR TILE ORDER, EVERY TILE
+//? IS 8x8 CONTIGUOUS BLOCKS OF 8x8 PIXELS (BLOCK-LINEAR). A TILE OF 32BIT TEXELS IS ONE 16KB RUN OF
+//? MEMORY (4 PAGES AT MOST), A BLOCK ROW IS ONE 32 BYTE AVX2 REGISTER AND A WHOLE BLOCK IS 4 CACHE LINES.
+//? BORDER TILES ARE PADDED TO FULL SIZE, SO EVERY TILE AND BLOCK ACCESS IS ALIGNED AND UNMASKED.
+//? -----------------------------------------------------------------------------------------------
+
+#include <immintrin.h>
+
+#include "Utils.hpp"
+
+constexpr u32 TILED_TILE_SIZE = 64;
+constexpr u32 TILED_BLOCK_SIZE = 8;
+constexpr u32 TILED_BLOCKS_PER_ROW = TILED_TILE_SIZE / TILED_BLOCK_SIZE;
+constexpr u32 TILED_BLOCK_TEXELS = TILED_BLOCK_SIZE * TILED_BLOCK_SIZE;
+constexpr u32 TILED_TILE_TEXELS = TILED_TILE_SIZE * TILED_TILE_SIZE;
+
+inline u32 tiled_tiles_x(u32 width)
+{
+	return (width + TILED_TILE_SIZE - 1) / TILED_TILE_SIZE;
+}
+
+inline u32 tiled_tiles_y(u32 height)
+{
+	return (height + TILED_TILE_SIZE - 1) / TILED_TILE_SIZE;
+}
+
+//? Texels (not bytes) needed for "width" x "height" image including padding of border tiles
+inline u64 tiled_texel_count(u32 width, u32 height)
+{
+	return (u64)tiled_tiles_x(width) * tiled_tiles_y(height) * TILED_TILE_TEXELS;
+}
+
+//? Offset of texel inside of its tile
+inline u32 tiled_texel_in_tile(u32 local_x, u32 local_y)
+{
+	u32 block = (local_y / TILED_BLOCK_SIZE) * TILED_BLOCKS_PER_ROW + local_x / TILED_BLOCK_SIZE;
+	return block * TILED_BLOCK_TEXELS + (local_y % TILED_BLOCK_SIZE) * TILED_BLOCK_SIZE + local_x % TILED_BLOCK_SIZE;
+}
+
+inline u64 tiled_texel_index(u32 x, u32 y, u32 tiles_x)
+{
+	u64 tile = (u64)(y / TILED_TILE_SIZE) * tiles_x + x / TILED_TILE_SIZE;
+	return tile * TILED_TILE_TEXELS + tiled_texel_in_tile(x % TILED_TILE_SIZE, y % TILED_TILE_SIZE);
+}
+
+//? Writes "width" x "height" texels (at most one tile) of a single tile into pitched linear destination,
+//? "dst" points at the top-left texel of that tile. Stores are non-temporal, destination is never read
+inline void tiled_resolve_tile(u32 *dst, u32 dst_pitch, const u32 *tile, u32 width, u32 height)
+{
+	u32 full_blocks_x = width / TILED_BLOCK_SIZE;
+	for (u32 y = 0; y < height; ++y)
+	{
+		u32 *dst_row = (u32 *)((byte *)dst + (u64)y * dst_pitch);
+		const u32 *src_row = tile + (y / TILED_BLOCK_SIZE) * TILED_BLOCKS_PER_ROW * TILED_BLOCK_TEXELS + (y % TILED_BLOCK_SIZE) * TILED_BLOCK_SIZE;
+		b32 is_aligned = ((u64)dst_row & 15) == 0;
+
+		// Baseline SSE on purpose, copy is bound by memory and not by register width (see "Cpu_Features.hpp")
+		for (u32 block_x = 0; block_x < full_blocks_x; ++block_x)
+		{
+			const __m128i *src_texels = (const __m128i *)(src_row + block_x * TILED_BLOCK_TEXELS);
+			__m128i *dst_texels = (__m128i *)(dst_row + block_x * TILED_BLOCK_SIZE);
+			__m128i lo = _mm_load_si128(src_texels);
+			__m128i hi = _mm_load_si128(src_texels + 1);
+			if (is_aligned)
+			{
+				_mm_stream_si128(dst_texels, lo);
+				_mm_stream_si128(dst_texels + 1, hi);
+			}
+			else
+			{
+				_mm_storeu_si128(dst_texels, lo);
+				_mm_storeu_si128(dst_texels + 1, hi);
+			}
+		}
+
+		for (u32 x = full_blocks_x * TILED_BLOCK_SIZE; x < width; ++x)
+			dst_row[x] = src_row[(x / TILED_BLOCK_SIZE) * TILED_BLOCK_TEXELS + x % TILED_BLOCK_SIZE];
+	}
+	// Non-temporal stores are not ordered with later stores, whoever consumes the tile next must see them
+	_mm_sfence();
+}
+
+//? Converts tiled 32bit surface into pitched linear one with non-temporal stores, made for the present stage:
+//? source block rows are read once in order of destination rows and destination is never pulled into cache
+inline void tiled_detile_stream(u32 *dst, u32 dst_pitch, const u32 *src, u32 width, u32 height)
+{
+	u32 tiles_x = tiled_tiles_x(width);
+	u32 full_blocks_x = width / TILED_BLOCK_SIZE;
+
+	for (u32 y = 0; y < height; ++y)
+	{
+		u32 *dst_row = (u32 *)((byte *)dst + (u64)y * dst_pitch);
+		const u32 *src_tile_row = src + (u64)(y / TILED_TILE_SIZE) * tiles_x * TILED_TILE_TEXELS;
+		u32 row_in_tile = ((y % TILED_TILE_SIZE) / TILED_BLOCK_SIZE) * TILED_BLOCKS_PER_ROW * TILED_BLOCK_TEXELS
+		                + (y % TILED_BLOCK_SIZE) * TILED_BLOCK_SIZE;
+		b32 is_aligned = ((u64)dst_row & 15) == 0;
+
+		for (u32 block_x = 0; block_x < full_blocks_x; ++block_x)
+		{
+			u32 x = block_x * TILED_BLOCK_SIZE;
+			const __m128i *src_texels = (const __m128i *)(src_tile_row + (u64)(x / TILED_TILE_SIZE) * TILED_TILE_TEXELS + row_in_tile
+			                                               + (block_x % TILED_BLOCKS_PER_ROW) * TILED_BLOCK_TEXELS);
+			__m128i *dst_texels = (__m128i *)(dst_row + x);
+			__m128i lo = _mm_load_si128(src_texels);
+			__m128i hi = _mm_load_si128(src_texels + 1);
+			if (is_aligned)
+			{
+				_mm_stream_si128(dst_texels, lo);
+				_mm_stream_si128(dst_texels + 1, hi);
+			}
+			else
+			{
+				_mm_storeu_si128(dst_texels, lo);
+				_mm_storeu_si128(dst_texels + 1, hi);
+			}
+		}
+
+		for (u32 x = full_blocks_x * TILED_BLOCK_SIZE; x < width; ++x)
+			dst_row[x] = src_tile_row[(u64)(x / TILED_TILE_SIZE) * TILED_TILE_TEXELS + tiled_texel_in_tile(x % TILED_TILE_SIZE, y % TILED_TILE_SIZE)];
+	}
+	_mm_sfence();
+}
@@ -20,7 +20,13 @@ using b32 = s32;
 
 using byte = u8;
 
-#define SoftAssert(cond) do { if (!(cond)) __debugbreak(); } while (0)
+#if defined(_MSC_VER)
+#define DebugTrap() __debugbreak()
+#else
+#define DebugTrap() __builtin_trap()
+#endif
+
+#define SoftAssert(cond) do { if (!(cond)) DebugTrap(); } while (0)
 
 #define KiB(Value) ((Value)*1024LL)
 #define MiB(Value) (KiB(Value) * 1024LL)
@@ -31,6 +37,12 @@ using byte = u8;
 #define local_persist static
 #define global_variable static
 
+#if defined(_MSC_VER)
+#define force_inline __forceinline
+#else
+#define force_inline inline __attribute__((always_inline))
+#endif
+
 constexpr f32 PI32 = 3.14159265359f;
 constexpr f64 PI64 = 3.14159265359;
 
@@ -12,14 +12,16 @@
 //TODO: Rewrite it to match API of other allocators
 #pragma once
 #include <cassert>
-#include "external/Minimal_Windows.hpp"
 
 #include "Utils.hpp"
+#include "VM_Pages.hpp"
 
-struct VM_Alloc_Header
+// 16 byte aligned, so elements keep SIMD alignment after the header
+struct alignas(16) VM_Alloc_Header
 {
 	u64 size;
 	u64 capacity;
+	u64 reserved; // bytes of address space, POSIX needs it to release the reservation
 };
 
 #define VMAllocGetHeader(a) ((VM_Alloc_Header*)((char*)(a) - sizeof(VM_Alloc_Header)))
@@ -43,7 +45,7 @@ inline T* vm_alloc_grow(T* arr, u64 n, u64 initSize = 0)
 		growBy = ( sizeof(T) * n + sizeof(VM_Alloc_Header) + (KiB(4) - 1) ) & -KiB(4);
 		currentCapacity = ( growBy - sizeof(VM_Alloc_Header) ) / sizeof(T);
 		assert(growBy < initSize && "Reached max reservation size limit");
-		arr = (T*)VirtualAlloc(nullptr, initSize, MEM_RESERVE, PAGE_READWRITE);
+		arr = (T*)vm_pages_reserve(initSize);
 		h = (VM_Alloc_Header*)arr;
 	}
 	else
@@ -58,13 +60,15 @@ inline T* vm_alloc_grow(T* arr, u64 n, u64 initSize = 0)
 		currentCapacity = ( growBy - sizeof(VM_Alloc_Header) ) / sizeof(T);
 	}
 
-	arr = (T*)VirtualAlloc(h, growBy, MEM_COMMIT, PAGE_READWRITE);
+	arr = (T*)vm_pages_commit(h, growBy);
 	assert(arr && "Failed to allocate memory");
 	arr = (T*)((char*)arr + sizeof(VM_Alloc_Header));
 
 	h = VMAllocGetHeader(arr);
 	h->capacity = currentCapacity;
 	h->size = size;
+	if (initSize)
+		h->reserved = initSize;
 
 	return arr;
 }
@@ -140,5 +144,5 @@ inline T* vm_alloc_get_end(T* arr)
 template<typename T>
 inline bool vm_alloc_free(T* arr)
 {
-	return !VirtualFree(VMAllocGetHeader(arr), 0, MEM_RELEASE);
+	return !vm_pages_release(VMAllocGetHeader(arr), VMAllocGetHeader(arr)->reserved);
 }
\ No newline at end of file
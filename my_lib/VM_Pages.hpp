@@ -0,0 +1,76 @@
+#pragma once
+//? -----------------------------------------------------------------------------------------------
+//? PAGE RESERVATION PRIMITIVES OF THE OS: RESERVE ADDRESS SPACE ONLY, COMMIT (BACK WITH MEMORY) PAGES INSIDE OF IT,
+//? DECOMMIT THEM BACK AND RELEASE ALL. INTENDED FOR 64BIT OS, RESERVATIONS SHOULD BE MULTIPLE OF 64KB
+//? -----------------------------------------------------------------------------------------------
+
+//? Only platform layer and tools include this header, application gets reserved arenas through "Alloc_Pages"
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+#include "Utils.hpp"
+#include "Allocators.hpp"
+
+inline void *vm_pages_reserve(u64 size_bytes)
+{
+#if defined(_WIN32)
+	return VirtualAlloc(nullptr, size_bytes, MEM_RESERVE, PAGE_READWRITE);
+#else
+	void *out = mmap(nullptr, size_bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	return out == MAP_FAILED ? nullptr : out;
+#endif
+}
+
+inline void *vm_pages_commit(void *at, u64 size_bytes)
+{
+#if defined(_WIN32)
+	return VirtualAlloc(at, size_bytes, MEM_COMMIT, PAGE_READWRITE);
+#else
+	return mprotect(at, size_bytes, PROT_READ | PROT_WRITE) == 0 ? at : nullptr;
+#endif
+}
+
+//? Pages stay reserved, they read as zero once committed again
+inline b32 vm_pages_decommit(void *at, u64 size_bytes)
+{
+#if defined(_WIN32)
+	return VirtualFree(at, size_bytes, MEM_DECOMMIT);
+#else
+	return madvise(at, size_bytes, MADV_DONTNEED) == 0 && mprotect(at, size_bytes, PROT_NONE) == 0;
+#endif
+}
+
+inline b32 vm_pages_release(void *at, u64 reserved_bytes)
+{
+#if defined(_WIN32)
+	return VirtualFree(at, 0, MEM_RELEASE);
+#else
+	return munmap(at, reserved_bytes) == 0;
+#endif
+}
+
+inline const Alloc_Pages g_vm_pages = { vm_pages_commit, vm_pages_decommit };
+
+//? Reserves "max_size" of address space and commits only the first chunk, so a fresh arena can be read at "base"
+//? right away (zero). Rest is committed as the arena grows. "base" is nullptr when reservation failed,
+//? give it back with "vm_pages_release(arena.base, arena.max_size)"
+[[nodiscard]]
+inline Alloc_Arena arena_reserve(const u64 max_size)
+{
+	Alloc_Arena out{ .max_size = max_size, .base = (byte *)vm_pages_reserve(max_size) };
+	if (out.base)
+	{
+		out.pages = &g_vm_pages;
+		arena_commit(&out, 1);
+	}
+	return out;
+}
@@ -0,0 +1,241 @@
+#pragma once
+//? -----------------------------------------------------------------------------------------------
+//? BATCHED VERTEX TRANSFORM: N POSITIONS (SOA STREAMS OR AOS "Vec3" ARRAYS) THROUGH MODEL-VIEW-PROJECTION INTO
+//? CLIP SPACE, OR FURTHER THROUGH PERSPECTIVE DIVIDE AND VIEWPORT INTO SCREEN SPACE, AND NORMALS THROUGH NORMAL
+//? MATRIX. 8 VERTICES PER ITERATION ("Math_Wide.hpp"), MATRIX IS BROADCAST ONCE PER CALL, OUTPUTS ARE SOA STREAMS,
+//? BIG ONES WRITTEN WITH NON-TEMPORAL STORES, SO A MILLION-VERTEX OUTPUT DOES NOT EVICT THE WORKING SET OF THE CALLER.
+//? -----------------------------------------------------------------------------------------------
+
+//? Output streams are preallocated by caller, 32B aligned (streaming stores), at least "count" long.
+//? Batches of at least VERTEX_STREAMING_MIN_COUNT vertices are written with non-temporal stores, smaller ones with plain
+//? stores: their output is consumed while it is still in cache, and streaming stores to cached lines are ~2-5x slower
+//? there (lib_bench "vertex transform")
+//? Last "count % 8" vertices are done with masked loads/stores, nothing is read or written past "count".
+//? Functions work on a range only, so a "parallel_for" over chunks of the stream is all that is needed for threads.
+//! Screen space variants do no clipping, vertices with w <= 0 produce garbage: clip ("clip" variants) first
+//! when geometry can cross the near plane
+
+#include <cassert>
+#include <immintrin.h>
+
+#include "Utils.hpp"
+#include "Math.hpp"
+#include "Math_Wide.hpp"
+#include "Cpu_Features.hpp"
+
+//? SoA stream of 3 or 4 components, element "i" is (x[i], y[i], z[i](, w[i]))
+struct Vertex_Stream3
+{
+	f32 *x;
+	f32 *y;
+	f32 *z;
+};
+
+struct Vertex_Stream4
+{
+	f32 *x;
+	f32 *y;
+	f32 *z;
+	f32 *w;
+};
+
+//? NDC (x, y in [-1, 1] up, z in [0, 1]) to pixels with y down and depth range, like D3D viewport.
+//? Defaults match "Raster_Vertex" positions for a framebuffer of given size
+struct Viewport
+{
+	f32 x, y;
+	f32 width, height;
+	f32 min_depth = 0.0f;
+	f32 max_depth = 1.0f;
+};
+
+constexpr u32 VERTEX_STREAMING_MIN_COUNT = 1 << 16; // 1MiB of 4 component output, past L2 of most cores
+
+enum class Vertex_Access : u32
+{
+	Streamed, // full 8 lanes, non-temporal store
+	Cached,   // full 8 lanes, plain store
+	Masked,   // tail, first "count % 8" lanes only
+};
+
+inline b32 vertex_stream_is_aligned(const f32 *p)
+{
+	return ((u64)p & 31) == 0;
+}
+
+CPU_TARGET_AVX2_BEGIN
+// ===============================================================================================================================
+// ======================================================== INTERNALS ============================================================
+// ===============================================================================================================================
+//? Shared loop of every batch: "load(i, mask, access)" gives 8 inputs starting at "i" (mask is only valid for the tail),
+//? "store(i, values, mask, access)" writes 8 outputs or the masked tail
+template <typename Load, typename Transform, typename Store>
+inline void vertex_batch_loop(u32 count, const Load &load, const Transform &transform, const Store &store)
+{
+	u32 i = 0;
+	__m256 full = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+	Vertex_Access access = count >= VERTEX_STREAMING_MIN_COUNT ? Vertex_Access::Streamed : Vertex_Access::Cached;
+	for (; i + lib::WIDE_LANES <= count; i += lib::WIDE_LANES)
+		store(i, transform(load(i, full, access)), full, access);
+
+	if (i < count)
+	{
+		__m256 mask = lib::lane_mask(count - i);
+		store(i, transform(load(i, mask, Vertex_Access::Masked)), mask, Vertex_Access::Masked);
+	}
+	// Streamed lines must be visible to other threads (e.g. setup jobs) before they are told to read them
+	if (access == Vertex_Access::Streamed)
+		_mm_sfence();
+}
+
+inline lib::Vec3x8 vertex_load(const Vertex_Stream3 &in, u32 i, __m256 mask, Vertex_Access access)
+{
+	return access == Vertex_Access::Masked ? lib::load_vec3x8_masked(in.x + i, in.y + i, in.z + i, mask) : lib::load_vec3x8(in.x + i, in.y + i, in.z + i);
+}
+
+//? Tail of AoS input goes through a small copy, 24 floats can not be loaded masked without reading past the array
+inline lib::Vec3x8 vertex_load(const lib::Vec3 *in, u32 i, u32 count, Vertex_Access access)
+{
+	if (access != Vertex_Access::Masked)
+		return lib::load_vec3x8_aos(in + i);
+
+	lib::Vec3 tail[lib::WIDE_LANES] = {};
+	for (u32 k = 0; i + k < count; ++k)
+		tail[k] = in[i + k];
+	return lib::load_vec3x8_aos(tail);
+}
+
+inline void vertex_store(const Vertex_Stream3 &out, u32 i, const lib::Vec3x8 v, __m256 mask, Vertex_Access access)
+{
+	if (access == Vertex_Access::Streamed)
+		lib::stream(out.x + i, out.y + i, out.z + i, v);
+	else if (access == Vertex_Access::Cached)
+		lib::store_aligned(out.x + i, out.y + i, out.z + i, v);
+	else
+		lib::store_masked(out.x + i, out.y + i, out.z + i, v, mask);
+}
+
+inline void vertex_store(const Vertex_Stream4 &out, u32 i, const lib::Vec4x8 v, __m256 mask, Vertex_Access access)
+{
+	if (access == Vertex_Access::Streamed)
+		lib::stream(out.x + i, out.y + i, out.z + i, out.w + i, v);
+	else if (access == Vertex_Access::Cached)
+		lib::store_aligned(out.x + i, out.y + i, out.z + i, out.w + i, v);
+	else
+		lib::store_masked(out.x + i, out.y + i, out.z + i, out.w + i, v, mask);
+}
+
+inline void vertex_assert_aligned(const Vertex_Stream3 &out)
+{
+	assert(vertex_stream_is_aligned(out.x) && vertex_stream_is_aligned(out.y) && vertex_stream_is_aligned(out.z)
+	       && "Output streams must be 32B aligned");
+}
+
+inline void vertex_assert_aligned(const Vertex_Stream4 &out)
+{
+	assert(vertex_stream_is_aligned(out.x) && vertex_stream_is_aligned(out.y) && vertex_stream_is_aligned(out.z)
+	       && vertex_stream_is_aligned(out.w) && "Output streams must be 32B aligned");
+}
+
+//? Clip space to screen space: x, y, z in pixels and depth, w becomes 1/w (kept for perspective correct interpolation)
+inline lib::Vec4x8 vertex_clip_to_screen(const lib::Vec4x8 clip, const Viewport &viewport)
+{
+	__m256 inv_w = _mm256_div_ps(_mm256_set1_ps(1.0f), clip.w);
+	__m256 half_w = _mm256_set1_ps(0.5f * viewport.width);
+	__m256 half_h = _mm256_set1_ps(0.5f * viewport.height);
+	__m256 depth_scale = _mm256_set1_ps(viewport.max_depth - viewport.min_depth);
+
+	lib::Vec4x8 out;
+	out.x = _mm256_fmadd_ps(_mm256_mul_ps(clip.x, inv_w), half_w, _mm256_set1_ps(viewport.x + 0.5f * viewport.width));
+	out.y = _mm256_fnmadd_ps(_mm256_mul_ps(clip.y, inv_w), half_h, _mm256_set1_ps(viewport.y + 0.5f * viewport.height));
+	out.z = _mm256_fmadd_ps(_mm256_mul_ps(clip.z, inv_w), depth_scale, _mm256_set1_ps(viewport.min_depth));
+	out.w = inv_w;
+	return out;
+}
+
+// ===============================================================================================================================
+// ========================================================= POSITIONS ===========================================================
+// ===============================================================================================================================
+//? Points (w=1) into clip space, e.g. for clipping or culling before the divide
+inline void vertex_transform_clip(const lib::Mat4 &mvp, const Vertex_Stream3 &in, u32 count, const Vertex_Stream4 &out)
+{
+	vertex_assert_aligned(out);
+	lib::Mat4_Wide m = lib::broadcast(mvp);
+	vertex_batch_loop(count,
+		[&](u32 i, __m256 mask, Vertex_Access access) { return vertex_load(in, i, mask, access); },
+		[&](const lib::Vec3x8 p) { return lib::mul_point(m, p); },
+		[&](u32 i, const lib::Vec4x8 v, __m256 mask, Vertex_Access access) { vertex_store(out, i, v, mask, access); });
+}
+
+inline void vertex_transform_clip(const lib::Mat4 &mvp, const lib::Vec3 *in, u32 count, const Vertex_Stream4 &out)
+{
+	vertex_assert_aligned(out);
+	lib::Mat4_Wide m = lib::broadcast(mvp);
+	vertex_batch_loop(count,
+		[&](u32 i, __m256 mask, Vertex_Access access) { return vertex_load(in, i, count, access); },
+		[&](const lib::Vec3x8 p) { return lib::mul_point(m, p); },
+		[&](u32 i, const lib::Vec4x8 v, __m256 mask, Vertex_Access access) { vertex_store(out, i, v, mask, access); });
+}
+
+//? Points (w=1) all the way into screen space: x, y in pixels, z depth, w = 1/w_clip
+inline void vertex_transform_screen(const lib::Mat4 &mvp, const Viewport &viewport, const Vertex_Stream3 &in, u32 count,
+                                    const Vertex_Stream4 &out)
+{
+	vertex_assert_aligned(out);
+	lib::Mat4_Wide m = lib::broadcast(mvp);
+	vertex_batch_loop(count,
+		[&](u32 i, __m256 mask, Vertex_Access access) { return vertex_load(in, i, mask, access); },
+		[&](const lib::Vec3x8 p) { return vertex_clip_to_screen(lib::mul_point(m, p), viewport); },
+		[&](u32 i, const lib::Vec4x8 v, __m256 mask, Vertex_Access access) { vertex_store(out, i, v, mask, access); });
+}
+
+inline void vertex_transform_screen(const lib::Mat4 &mvp, const Viewport &viewport, const lib::Vec3 *in, u32 count,
+                                    const Vertex_Stream4 &out)
+{
+	vertex_assert_aligned(out);
+	lib::Mat4_Wide m = lib::broadcast(mvp);
+	vertex_batch_loop(count,
+		[&](u32 i, __m256 mask, Vertex_Access access) { return vertex_load(in, i, count, access); },
+		[&](const lib::Vec3x8 p) { return vertex_clip_to_screen(lib::mul_point(m, p), viewport); },
+		[&](u32 i, const lib::Vec4x8 v, __m256 mask, Vertex_Access access) { vertex_store(out, i, v, mask, access); });
+}
+
+//? Clip space stream (e.g. output of clipping) into screen space, same output as "vertex_transform_screen"
+inline void vertex_clip_to_screen(const Viewport &viewport, const Vertex_Stream4 &in, u32 count, const Vertex_Stream4 &out)
+{
+	vertex_assert_aligned(out);
+	vertex_batch_loop(count,
+		[&](u32 i, __m256 mask, Vertex_Access access)
+		{
+			return access == Vertex_Access::Masked ? lib::load_vec4x8_masked(in.x + i, in.y + i, in.z + i, in.w + i, mask)
+			               : lib::load_vec4x8(in.x + i, in.y + i, in.z + i, in.w + i);
+		},
+		[&](const lib::Vec4x8 clip) { return vertex_clip_to_screen(clip, viewport); },
+		[&](u32 i, const lib::Vec4x8 v, __m256 mask, Vertex_Access access) { vertex_store(out, i, v, mask, access); });
+}
+
+// ===============================================================================================================================
+// ========================================================== NORMALS ============================================================
+// ===============================================================================================================================
+//? Vectors (w=0) through "normal_matrix" (inverse transpose of model(-view) for non-uniform scale, model itself otherwise),
+//? renormalized, zero normals stay zero
+inline void vertex_transform_normals(const lib::Trans4 &normal_matrix, const Vertex_Stream3 &in, u32 count, const Vertex_Stream3 &out)
+{
+	vertex_assert_aligned(out);
+	lib::Trans4_Wide m = lib::broadcast(normal_matrix);
+	vertex_batch_loop(count,
+		[&](u32 i, __m256 mask, Vertex_Access access) { return vertex_load(in, i, mask, access); },
+		[&](const lib::Vec3x8 n) { return lib::normalize(lib::mul_vec(m, n)); },
+		[&](u32 i, const lib::Vec3x8 v, __m256 mask, Vertex_Access access) { vertex_store(out, i, v, mask, access); });
+}
+
+inline void vertex_transform_normals(const lib::Trans4 &normal_matrix, const lib::Vec3 *in, u32 count, const Vertex_Stream3 &out)
+{
+	vertex_assert_aligned(out);
+	lib::Trans4_Wide m = lib::broadcast(normal_matrix);
+	vertex_batch_loop(count,
+		[&](u32 i, __m256 mask, Vertex_Access access) { return vertex_load(in, i, count, access); },
+		[&](const lib::Vec3x8 n) { return lib::normalize(lib::mul_vec(m, n)); },
+		[&](u32 i, const lib::Vec3x8 v, __m256 mask, Vertex_Access access) { vertex_store(out, i, v, mask, access); });
+}
+CPU_TARGET_END
@@ -139,4 +139,59 @@ bool dx_init_resources(DX_Machine* dxr, DX_Context* dxc, HWND win_handle)
 	}
 	
 	return true;
-}
\ No newline at end of file
+}
+
+//? Everything the present thread of "Frame_Ring" touches, main thread changes it only while the ring is flushed
+//? "cpu_buffer" is created once for the maximum extent, only the active extent of it is written and copied
+struct DX_Present_Target
+{
+	DX_Machine *machine;
+	DX_Context *context;
+	ID3D11Texture2D *back_buffer;
+	ID3D11Texture2D *cpu_buffer;
+};
+
+bool dx_create_cpu_buffer(DX_Machine *dxr, DX_Present_Target *target, u32 max_width, u32 max_height)
+{
+	D3D11_TEXTURE2D_DESC tex_desc
+	{
+		.Width = max_width,
+		.Height = max_height,
+		.MipLevels = 1,
+		.ArraySize = 1,
+		.Format = DXGI_FORMAT_R8G8B8A8_UNORM,
+		.SampleDesc = { 1, 0 },
+		.Usage = D3D11_USAGE_DYNAMIC,
+		.BindFlags = D3D11_BIND_SHADER_RESOURCE,
+		.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE,
+	};
+
+	HRESULT hr = dxr->device->CreateTexture2D(&tex_desc, nullptr, &target->cpu_buffer);
+	AssertHR(hr);
+	return SUCCEEDED(hr);
+}
+
+//? Present stage of the frame ring: detiles/streams finished CPU frame into the mapped texture, rendering itself
+//? never touches mapped (write-combined) memory. This copy is the only one per frame, game is never handed "mapped.pData"
+//? as a Linear "Game_Framebuffer", see "Win32_x64_Platform.cpp" for why
+void dx_present_frame(void *user_data, const Frame_Ring_Slot *slot)
+{
+	DX_Present_Target *target = (DX_Present_Target *)user_data;
+	HRESULT hr;
+
+	D3D11_MAPPED_SUBRESOURCE mapped;
+	// Stop GPU access to the CPU-pixel buffer data
+	hr = target->context->imm_context->Map((ID3D11Resource *)target->cpu_buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
+	AssertHR(hr);
+
+	frame_ring_stream_slot((u32 *)mapped.pData, mapped.RowPitch, slot);
+
+	// Allow GPU access to the CPU-pixel buffer data
+	target->context->imm_context->Unmap((ID3D11Resource *)target->cpu_buffer, 0);
+	D3D11_BOX extent{ .left = 0, .top = 0, .front = 0, .right = slot->width, .bottom = slot->height, .back = 1 };
+	target->context->imm_context->CopySubresourceRegion((ID3D11Resource *)target->back_buffer, 0, 0, 0, 0,
+	                                                    (ID3D11Resource *)target->cpu_buffer, 0, &extent);
+
+	hr = target->machine->swap_chain->Present(0, 0);
+	AssertHR(hr);
+}
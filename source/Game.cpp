@@ -1,3 +1,102 @@
 #include "Game.hpp"
+#include "Raster.hpp"
 
+//? Persistent application state, lives at the very beginning of the global memory provided by platform
+struct Game_State
+{
+	b32 is_initialized;
+	u32 frame_counter;
+	f32 time_s;       // advanced only by "Game_Input::delta_s", so replayed input reproduces every frame
+	lib::Vec2 camera; // scene offset in pixels, panned by move buttons
 
+	Alloc_Arena transient; // per frame application data, reset at the beginning of every frame
+	Raster_Context raster;
+};
+
+constexpr u32 SCENE_GRID_X = 24;
+constexpr u32 SCENE_GRID_Y = 14;
+constexpr u32 SCENE_BIG_TRIANGLES = 3;
+constexpr u32 SCENE_TRIANGLES_MAX = SCENE_GRID_X * SCENE_GRID_Y * 2 + SCENE_BIG_TRIANGLES;
+
+internal lib::Vec3 scene_palette(u32 i)
+{
+	f32 t = (f32)i * 0.618034f;
+	return { 0.5f + 0.5f * cosf(6.2831f * t), 0.5f + 0.5f * cosf(6.2831f * (t + 0.33f)), 0.5f + 0.5f * cosf(6.2831f * (t + 0.67f)) };
+}
+
+//? Grid of spinning triangles over whole screen, with few big triangles sweeping through it at different depths
+internal u32 scene_build(Raster_Triangle *out, f32 width, f32 height, f32 time_s, lib::Vec2 camera)
+{
+	ProfileFunction();
+	u32 count = 0;
+	f32 cell_w = width / SCENE_GRID_X;
+	f32 cell_h = height / SCENE_GRID_Y;
+	f32 radius = 0.7f * lib::min(cell_w, cell_h);
+
+	for (u32 cy = 0; cy < SCENE_GRID_Y; ++cy)
+	{
+		for (u32 cx = 0; cx < SCENE_GRID_X; ++cx)
+		{
+			lib::Vec2 center = { (cx + 0.5f) * cell_w + camera.x, (cy + 0.5f) * cell_h + camera.y };
+			for (u32 k = 0; k < 2; ++k)
+			{
+				f32 angle = (k ? -time_s : time_s) * (0.5f + 0.1f * (f32)((cx + cy) % 5));
+				f32 z = 0.5f + 0.3f * sinf(time_s + (f32)(cx * 3 + cy * 7 + k));
+				Raster_Triangle *tri = &out[count++];
+				for (u32 v = 0; v < 3; ++v)
+				{
+					f32 a = angle + (f32)v * (2.0f * PI32 / 3.0f);
+					tri->v[v].position = { center.x + radius * cosf(a), center.y + radius * sinf(a), z };
+					tri->v[v].color = scene_palette(cx * 5 + cy * 11 + k * 3 + v);
+				}
+			}
+		}
+	}
+
+	for (u32 i = 0; i < SCENE_BIG_TRIANGLES; ++i)
+	{
+		f32 sweep = fmodf(time_s * 0.1f + (f32)i / SCENE_BIG_TRIANGLES, 1.0f) * 2.0f - 0.5f;
+		f32 z = 0.25f + 0.25f * (f32)i;
+		Raster_Triangle *tri = &out[count++];
+		tri->v[0].position = { sweep * width + camera.x, -0.1f * height + camera.y, z };
+		tri->v[1].position = { (sweep + 0.6f) * width + camera.x, 0.5f * height + camera.y, z };
+		tri->v[2].position = { sweep * width + camera.x, 1.1f * height + camera.y, z };
+		tri->v[0].color = scene_palette(100 + i);
+		tri->v[1].color = scene_palette(200 + i);
+		tri->v[2].color = scene_palette(300 + i);
+	}
+
+	return count;
+}
+
+void game_update_and_render(Alloc_Arena *memory, Job_System *jobs, Game_Input *input, const Game_Framebuffer *framebuffer)
+{
+	ProfileFunction();
+	Game_State *state = (Game_State *)memory->base;
+	if (!state->is_initialized)
+	{
+		Game_State *pushed = push_type<Game_State>(memory);
+		GameAssert(pushed == state);
+		state->transient = arena_from_allocator(memory, MiB(64));
+		state->raster = raster_create(memory, MiB(512), jobs, framebuffer->max_width, framebuffer->max_height);
+		state->is_initialized = true;
+	}
+
+	Alloc_Arena *transient = &state->transient;
+	arena_reset(transient);
+
+	constexpr f32 camera_speed = 400.0f; // pixels per second
+	Game_Controller *controller = get_game_controller(input, 0);
+	f32 move_x = (f32)(controller->moveRight.wasDown != 0) - (f32)(controller->moveLeft.wasDown != 0);
+	f32 move_y = (f32)(controller->moveDown.wasDown != 0) - (f32)(controller->moveUp.wasDown != 0);
+	state->camera.x -= move_x * camera_speed * input->delta_s;
+	state->camera.y -= move_y * camera_speed * input->delta_s;
+
+	Raster_Triangle *triangles = push_type<Raster_Triangle>(transient, SCENE_TRIANGLES_MAX);
+	u32 triangle_count = scene_build(triangles, (f32)framebuffer->width, (f32)framebuffer->height, state->time_s, state->camera);
+
+	raster_render(&state->raster, framebuffer, 0xFF201810, triangles, triangle_count);
+
+	state->frame_counter++;
+	state->time_s += input->delta_s;
+}
@@ -1,4 +1,12 @@
 #pragma once
 #include "Utils.hpp"
 #include "GameAsserts.hpp"
-#include "Game_Services.hpp"
\ No newline at end of file
+#include "Allocators.hpp"
+#include "Game_Services.hpp"
+#include "Job_System.hpp"
+
+//? The only entry point from platform to the application layer, called once per frame by every platform.
+//? Global memory is assumed to be zeroed on first call and is owned by application from then on.
+//? Job system is owned by platform and the calling thread is its worker 0.
+//? Framebuffer may be linear with any pitch (mapped GPU memory, heap memory) or tiled, see "Game_Framebuffer"
+void game_update_and_render(Alloc_Arena *memory, Job_System *jobs, Game_Input *input, const Game_Framebuffer *framebuffer);
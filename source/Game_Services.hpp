@@ -14,9 +14,10 @@ struct Game_Mouse_Data
 	s32 deltaWheel;
 };
 
+//? No padding anywhere in "Game_Input", so equal inputs are equal bytes (see "Input_Recording.hpp")
 struct Game_Controller
 {
-	b16 isConnected;
+	b32 isConnected;
 	Game_Mouse_Data mouse;
 
 	union
@@ -48,6 +49,38 @@ struct Game_Controller
 struct Game_Input
 {
 	Game_Controller controllers[2];
+	f32 delta_s; // simulation time step of this frame, set by platform (or replayed), never measured by application
+};
+
+enum class Game_Pixel_Format : u32
+{
+	RGBA8, // 32bit, R in lowest byte
+};
+
+enum class Game_Framebuffer_Layout : u32
+{
+	Linear, // rows of "pitch" bytes, e.g. mapped GPU texture or plain heap memory
+	Tiled,  // "tile_size" squares stored contiguously, "block_size" squares inside of them (see "Tiled_Surface.hpp")
+};
+
+//? Destination of a frame, handed by platform every frame, application renders directly into it.
+//? Linear memory is written only, never read back, so it may be write-combined.
+//? "max_width" x "max_height" is the biggest extent platform will ever hand over (e.g. biggest monitor), fixed for
+//? the whole run, so application can reserve everything once and only rebind on resize.
+//? Win32 layer currently hands over tiled CPU slots of its frame ring, never the mapped texture (see "Win32_x64_Platform.cpp"),
+//? the Linear path is exercised by POSIX "-linear"
+struct Game_Framebuffer
+{
+	u32 *base;
+	u32 width;
+	u32 height;
+	u32 max_width;
+	u32 max_height;
+	u32 pitch; // bytes, Linear only, any value >= width * 4
+	Game_Pixel_Format format;
+	Game_Framebuffer_Layout layout;
+	u32 tile_size;  // Tiled only
+	u32 block_size; // Tiled only
 };
 
 #if GAME_INTERNAL
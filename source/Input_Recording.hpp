@@ -0,0 +1,141 @@
+#pragma once
+//? -----------------------------------------------------------------------------------------------
+//? INPUT RECORDING AND REPLAY: EVERY FRAME'S "Game_Input" (DELTA TIME INCLUDED) IS STREAMED INTO A BINARY FILE,
+//? REPLAY FEEDS IT BACK FRAME BY FRAME. APPLICATION IS DETERMINISTIC FOR A GIVEN INPUT SEQUENCE AND FRAMEBUFFER
+//? EXTENT, SO A REPLAYED RUN AT THE RECORDED EXTENT SIMULATES AND RENDERS EXACTLY THE SAME FRAMES ON EVERY BUILD AND
+//? EVERY MACHINE. PLATFORM LAYERS RENDER REPLAYS AT "header.width" x "header.height", RESIZING THE WINDOW DURING A REPLAY
+//? (OR A SCREEN TOO SMALL FOR THE RECORDED EXTENT) GIVES UP THAT GUARANTEE.
+//? -----------------------------------------------------------------------------------------------
+
+//? Used by platform layers only, application never knows whether its input is live or replayed.
+//? Recording made on Win32 replays on headless POSIX and vice versa, both are x64 with the same "Game_Input" layout.
+//? File is a header followed by runs: u32 repeat count + raw "Game_Input". Idle frames are byte identical
+//? (same delta, no transitions, no mouse movement), so a run of them costs a single record.
+//! Records are raw struct bytes, "input_size" in the header rejects files of a build with different "Game_Input"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "Utils.hpp"
+#include "GameAsserts.hpp"
+#include "Game_Services.hpp"
+
+constexpr u32 INPUT_RECORDING_MAGIC = 'R' | ('I' << 8) | ('N' << 16) | ('P' << 24);
+constexpr u32 INPUT_RECORDING_VERSION = 1;
+
+struct Input_Recording_Header
+{
+	u32 magic;
+	u32 version;
+	u32 input_size;
+	u32 frame_count; // patched when recording ends
+	u32 width;       // framebuffer extent when recording started, replay should render at the same one
+	u32 height;
+};
+
+struct Input_Recording
+{
+	FILE *file;
+	Input_Recording_Header header;
+	b32 is_replaying;
+
+	Game_Input run_input; // pending (recording) or current (replay) run
+	u32 run_count;        // frames written into pending run / frames of current run left to replay
+};
+
+//? Starts a new file, overwriting existing one
+inline b32 input_recording_begin(Input_Recording *rec, const char *file_name, u32 width, u32 height)
+{
+	*rec = {};
+	rec->file = fopen(file_name, "wb");
+	if (!rec->file)
+		return false;
+
+	rec->header = { INPUT_RECORDING_MAGIC, INPUT_RECORDING_VERSION, (u32)sizeof(Game_Input), 0, width, height };
+	return fwrite(&rec->header, sizeof(rec->header), 1, rec->file) == 1;
+}
+
+inline b32 input_recording_flush_run(Input_Recording *rec)
+{
+	if (rec->run_count == 0)
+		return true;
+
+	b32 ok = fwrite(&rec->run_count, sizeof(rec->run_count), 1, rec->file) == 1
+	         && fwrite(&rec->run_input, sizeof(rec->run_input), 1, rec->file) == 1;
+	rec->run_count = 0;
+	return ok;
+}
+
+inline b32 input_recording_write(Input_Recording *rec, const Game_Input *input)
+{
+	GameAssert(rec->file && !rec->is_replaying);
+	b32 ok = true;
+	if (rec->run_count && memcmp(&rec->run_input, input, sizeof(Game_Input)) != 0)
+		ok = input_recording_flush_run(rec);
+
+	rec->run_input = *input;
+	rec->run_count++;
+	rec->header.frame_count++;
+	return ok;
+}
+
+//? Header is validated, "header.width" and "header.height" tell the extent recording was made at.
+//? On failure "rec" is left inactive (no file, not replaying)
+inline b32 input_replay_begin(Input_Recording *rec, const char *file_name)
+{
+	*rec = {};
+	rec->file = fopen(file_name, "rb");
+	if (!rec->file)
+		return false;
+
+	if (fread(&rec->header, sizeof(rec->header), 1, rec->file) != 1
+	    || rec->header.magic != INPUT_RECORDING_MAGIC
+	    || rec->header.version != INPUT_RECORDING_VERSION
+	    || rec->header.input_size != sizeof(Game_Input))
+	{
+		fclose(rec->file);
+		*rec = {};
+		return false;
+	}
+	rec->is_replaying = true;
+	return true;
+}
+
+//? Returns false once every recorded frame was replayed, "out" is left untouched then
+inline b32 input_replay_read(Input_Recording *rec, Game_Input *out)
+{
+	GameAssert(rec->file && rec->is_replaying);
+	if (rec->run_count == 0)
+	{
+		if (fread(&rec->run_count, sizeof(rec->run_count), 1, rec->file) != 1
+		    || fread(&rec->run_input, sizeof(rec->run_input), 1, rec->file) != 1
+		    || rec->run_count == 0)
+		{
+			rec->run_count = 0;
+			return false;
+		}
+	}
+
+	*out = rec->run_input;
+	rec->run_count--;
+	return true;
+}
+
+//? Recording: writes pending run and final frame count. Safe to call on inactive recording or finished replay
+inline b32 input_recording_end(Input_Recording *rec)
+{
+	if (!rec->file)
+		return true;
+
+	b32 ok = true;
+	if (!rec->is_replaying)
+	{
+		ok = input_recording_flush_run(rec)
+		     && fseek(rec->file, 0, SEEK_SET) == 0
+		     && fwrite(&rec->header, sizeof(rec->header), 1, rec->file) == 1;
+	}
+	ok = (fclose(rec->file) == 0) && ok;
+	rec->file = nullptr;
+	rec->is_replaying = false;
+	return ok;
+}
@@ -0,0 +1,225 @@
+//? This Translation Unit provides data and services (declared by application) from OS to a game/app layer
+//? Headless counterpart of "Win32_x64_Platform.cpp" for POSIX x64 machines without GPU (render boxes):
+//? the same frame loop and the same application layer, but frames go into a page-aligned memory framebuffer
+//? which can be dumped to disk, and frame times are reported to stdout instead of the window title
+//? In case of porting to a different platform, this is the ONLY file you need to change
+
+#include <stdio.h>
+
+#include "Utils.hpp"
+#include "GameAsserts.hpp"
+#include "Game_Services.hpp"
+#include "Game.hpp"
+#include "Frame_Ring.hpp"
+#include "Frame_Pacing.hpp"
+#include "Cpu_Features.hpp"
+#include "Posix_x64_Platform.hpp"
+#include "Input_Recording.hpp"
+#include "Allocators.hpp"
+#include "VM_Pages.hpp"
+
+int main(int argc, char **argv)
+{
+	Posix::Platform_Options options = Posix::parse_options(argc, argv);
+	u32 cores_count = options.threads ? options.threads : Posix::get_cores_count();
+	AlwaysAssert(sizeof(void *) == 8 && "This is not a 64-bit OS!");
+	AlwaysAssert(options.width && options.height && "Framebuffer dimensions must be non zero");
+	// Before anything else, every hot path picks its kernels by "g_cpu.isa"
+	AlwaysAssert(cpu_init(options.max_isa) && "CPU without SSE4.2 and POPCNT, this build can not run on it");
+
+	Posix::Platform_Clock clock = Posix::clock_create((s32)options.fps);
+	// Linux timer slack is ~50us, margin calibrates itself from there
+	Frame_Pacer pacer = frame_pacer_create((f64)options.fps, 0.0002);
+	Frame_Time_Stats frame_stats{};
+	Posix::register_stop_signals();
+
+	// Replay renders at the extent it was recorded at, otherwise frames would not be the same
+	Input_Recording input_recording{};
+	if (options.replay_file)
+	{
+		if (!input_replay_begin(&input_recording, options.replay_file))
+		{
+			fprintf(stderr, "Could not replay \"%s\", missing file or recording of a different build\n", options.replay_file);
+			return 1;
+		}
+		options.width = input_recording.header.width;
+		options.height = input_recording.header.height;
+		printf("replaying %u frames of \"%s\"\n", input_recording.header.frame_count, options.replay_file);
+	}
+	else if (options.record_file && !input_recording_begin(&input_recording, options.record_file, options.width, options.height))
+	{
+		fprintf(stderr, "Could not create recording \"%s\"\n", options.record_file);
+		return 1;
+	}
+
+	// Only reserved, application memory is committed as it grows
+	Alloc_Arena global_memory = arena_reserve(GiB(2));
+	AlwaysAssert(global_memory.base && "Failed to reserve memory from OS");
+
+	// Worker threads live for the whole run, main thread is worker 0 and joins every fork inside of the frame
+	constexpr u32 profiler_events_per_thread = 1 << 16;
+	u64 platform_memory_size = job_system_memory_size(cores_count) + profiler_memory_size(cores_count + 1, profiler_events_per_thread);
+	Alloc_Arena platform_memory
+	{
+		.max_size = platform_memory_size,
+		.base = (byte*)Posix::allocate_pages(platform_memory_size)
+	};
+	AlwaysAssert(platform_memory.base && "Failed to allocate memory from OS");
+	profiler_init(&platform_memory, cores_count + 1, profiler_events_per_thread);
+	profiler_register_thread("Main");
+	Job_System jobs{};
+	job_system_create(&jobs, &platform_memory, cores_count);
+
+	// Stand-in for the GPU owned buffer on Win32, kept outside of global memory which belongs to application
+	u32 width = options.width;
+	u32 height = options.height;
+	u32 pitch = width * sizeof(u32);
+	u64 framebuffer_size = AlignAddressPow2((u64)pitch * height, Posix::get_page_size());
+	u32 *framebuffer = (u32 *)Posix::allocate_pages(framebuffer_size);
+	byte *dump_row = (byte *)Posix::allocate_pages(width * 3);
+	AlwaysAssert(framebuffer && dump_row && "Failed to allocate framebuffer from OS");
+
+	if (options.dump_dir && !Posix::create_directory(options.dump_dir))
+	{
+		fprintf(stderr, "Could not create dump directory \"%s\"\n", options.dump_dir);
+		return 1;
+	}
+
+	// Frames are rendered into CPU side slots and streamed (detiled) into the framebuffer by present thread.
+	// Linear slots get row pitch padded to 256 bytes like mapped GPU textures, so pitch != width * 4 is exercised
+	Posix::Present_Target present_target
+	{
+		.pixels = framebuffer,
+		.pitch = pitch,
+		.dump_every = options.dump_every,
+		.dump_dir = options.dump_dir,
+		.dump_row = dump_row,
+	};
+	Frame_Ring frame_ring{};
+	frame_ring_create(&frame_ring, FRAME_RING_MAX_SLOTS, Posix::present_frame, &present_target);
+	u32 slot_pitch = options.is_linear ? (u32)AlignAddressPow2(pitch, 256) : 0;
+	u64 slot_size = frame_ring_slot_size(width, height, slot_pitch, !options.is_linear);
+	u32 *ring_pixels[FRAME_RING_MAX_SLOTS] = {};
+	for (u32 i = 0; i < frame_ring.slot_count; ++i)
+	{
+		ring_pixels[i] = (u32 *)Posix::allocate_pages(slot_size);
+		AlwaysAssert(ring_pixels[i] && "Failed to allocate framebuffer from OS");
+		frame_ring_bind_slot(&frame_ring, i, ring_pixels[i], width, height, slot_pitch, !options.is_linear);
+	}
+
+	Game_Input gameInputBuffer[2] = {};
+	Game_Input *newInputs = &gameInputBuffer[0];
+	Game_Input *oldInputs = &gameInputBuffer[1];
+
+	printf("Raster headless: %ux%u %s, %u threads, %u frames, %s, %s kernels (%s)\n", width, height, options.is_linear ? "linear" : "tiled",
+	       cores_count, options.frames, options.fps ? "paced" : "unpaced", cpu_isa_name(g_cpu.isa), g_cpu.brand);
+
+	u32 counter = 0;
+
+	while (Posix::g_is_running && (options.frames == 0 || counter < options.frames))
+	{
+		ProfileScope("Frame");
+		u64 tick_start = Posix::get_performance_ticks();
+
+		// No input devices on headless machine, controller state is only carried over like on Win32
+		Game_Controller *oldKeyboardMouseController = get_game_controller(oldInputs, 0);
+		Game_Controller *newKeyboardMouseController = get_game_controller(newInputs, 0);
+		*newKeyboardMouseController = {};
+		newKeyboardMouseController->isConnected = true;
+		for (u32 i = 0; i < array_count_32(newKeyboardMouseController->buttons); ++i)
+		{
+			newKeyboardMouseController->buttons[i].wasDown = oldKeyboardMouseController->buttons[i].wasDown;
+			newKeyboardMouseController->mouse.x = oldKeyboardMouseController->mouse.x;
+			newKeyboardMouseController->mouse.y = oldKeyboardMouseController->mouse.y;
+		}
+		// Fixed step even when unpaced, simulation must not depend on how fast this machine renders
+		newInputs->delta_s = 1.0f / (f32)(options.fps ? options.fps : 60);
+
+		if (input_recording.is_replaying)
+		{
+			if (!input_replay_read(&input_recording, newInputs))
+				break;
+		}
+		else if (input_recording.file && !input_recording_write(&input_recording, newInputs))
+		{
+			fprintf(stderr, "Failed to write input recording, recording stopped\n");
+			input_recording_end(&input_recording);
+		}
+
+		Frame_Ring_Slot *slot;
+		{
+			ProfileScope("Frame Ring Acquire");
+			slot = frame_ring_acquire(&frame_ring);
+		}
+		Game_Framebuffer game_framebuffer
+		{
+			.base = slot->pixels,
+			.width = slot->width,
+			.height = slot->height,
+			.max_width = width,
+			.max_height = height,
+			.pitch = slot->pitch,
+			.format = Game_Pixel_Format::RGBA8,
+			.layout = slot->is_tiled ? Game_Framebuffer_Layout::Tiled : Game_Framebuffer_Layout::Linear,
+			.tile_size = TILED_TILE_SIZE,
+			.block_size = TILED_BLOCK_SIZE,
+		};
+		game_update_and_render(&global_memory, &jobs, newInputs, &game_framebuffer);
+		frame_ring_submit(&frame_ring);
+
+		Game_Input *temp_inputs = newInputs;
+		newInputs = oldInputs;
+		oldInputs = temp_inputs;
+
+		// Whole frame period including pacing wait
+		{
+			ProfileScope("Pacing Wait");
+			Posix::clock_update_and_wait(clock, &pacer, tick_start);
+		}
+		frame_stats_push(&frame_stats, clock.delta_s * 1000.0f);
+
+		if (counter % 100 == 0)
+			printf("frame %6u: %.3f ms\n", counter, clock.delta_s * 1000.0f);
+
+		counter++;
+	}
+
+	if (counter)
+	{
+		Frame_Time_Report report = frame_stats_report(&frame_stats);
+		printf("%u frames (last %u): min %.3f, avg %.3f, p50 %.3f, p95 %.3f, p99 %.3f, max %.3f ms\n",
+		       counter, report.sample_count, report.min_ms, report.avg_ms, report.p50_ms, report.p95_ms, report.p99_ms, report.max_ms);
+		if (pacer.target_s > 0.0)
+		{
+			printf("pacing %.3f ms: %llu sleeps, oversleep mean %.3f ms, max %.3f ms, spin margin %.3f ms, %llu late frames\n",
+			       pacer.target_s * 1000.0, (unsigned long long)pacer.sleep_count, pacer.oversleep_mean_s * 1000.0,
+			       pacer.oversleep_max_s * 1000.0, pacer.spin_margin_s * 1000.0, (unsigned long long)pacer.missed_count);
+		}
+	}
+
+	frame_ring_destroy(&frame_ring);
+	job_system_destroy(&jobs);
+	if (options.record_file && input_recording.file)
+	{
+		u32 recorded = input_recording.header.frame_count;
+		if (input_recording_end(&input_recording))
+			printf("%u frames of input recorded to \"%s\"\n", recorded, options.record_file);
+		else
+			fprintf(stderr, "Failed to finish input recording \"%s\"\n", options.record_file);
+	}
+	input_recording_end(&input_recording);
+	if (options.trace_file)
+	{
+		if (profiler_export_chrome_trace(options.trace_file))
+			printf("trace written to \"%s\"\n", options.trace_file);
+		else
+			fprintf(stderr, "Could not write trace \"%s\", profiler needs \"-Profile\" build\n", options.trace_file);
+	}
+	for (u32 i = 0; i < frame_ring.slot_count; ++i)
+		Posix::free_pages(ring_pixels[i], slot_size);
+	Posix::free_pages(platform_memory.base, platform_memory.max_size);
+	Posix::free_pages(dump_row, width * 3);
+	Posix::free_pages(framebuffer, framebuffer_size);
+	vm_pages_release(global_memory.base, global_memory.max_size);
+	return 0;
+}
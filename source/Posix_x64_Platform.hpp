@@ -0,0 +1,290 @@
+#pragma once
+
+#include <time.h>
+#include <immintrin.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//? Headless POSIX Platform layer implementations, intended to be used with "main" of Posix_x64_Platform.cpp only!
+//? Mirrors the "Win32" namespace so both entry points read the same way, but there is no window nor GPU here,
+//? every frame is rendered into a plain page-aligned memory framebuffer
+//! DO NOT INCLUDE IT ENYWHERE ELSE THAN IN POSIX ENTRY POINT COMPILATION UNIT FILE!
+namespace Posix
+{
+	struct Platform_Clock
+	{
+		f32 delta_s;
+		s32 target_fps;
+		u64 clock_freq;
+	};
+
+	struct Platform_Options
+	{
+		u32 width;
+		u32 height;
+		u32 frames;      // 0 means run until SIGINT/SIGTERM (or until replay ends)
+		u32 threads;     // 0 means all online cores
+		u32 fps;         // 0 means unpaced, as fast as possible
+		u32 dump_every;  // dump every n-th frame, 0 disables dumping
+		const char *dump_dir;
+		b32 is_linear;   // render straight into linear slots (GPU-like padded pitch) instead of tiled ones
+		const char *trace_file; // Chrome trace of last frames written at exit, "-Profile" builds only
+		const char *record_file; // every frame's input written there, see "Input_Recording.hpp"
+		const char *replay_file; // input read from there instead, extent of the recording overrides -width/-height
+		Cpu_Isa max_isa;         // kernels of at most this ISA even when CPU has wider ones, see "Cpu_Features.hpp"
+	};
+
+	global_variable volatile sig_atomic_t g_is_running = true;
+
+	internal void stop_signal_callback(int signal)
+	{
+		g_is_running = false;
+	}
+
+	internal void register_stop_signals()
+	{
+		struct sigaction action{};
+		action.sa_handler = Posix::stop_signal_callback;
+		sigemptyset(&action.sa_mask);
+		sigaction(SIGINT, &action, nullptr);
+		sigaction(SIGTERM, &action, nullptr);
+	}
+
+	internal u32 get_cores_count()
+	{
+		long count = sysconf(_SC_NPROCESSORS_ONLN);
+		return count > 0 ? (u32)count : 1;
+	}
+
+	// ===============================================================================================================================
+	// ========================================================= MEMORY ==============================================================
+	// ===============================================================================================================================
+	internal u64 get_page_size()
+	{
+		long size = sysconf(_SC_PAGESIZE);
+		return size > 0 ? (u64)size : KiB(4);
+	}
+
+	//? Page-aligned, zero-initialized and lazily backed by the kernel - equivalent of VirtualAlloc(MEM_RESERVE | MEM_COMMIT)
+	internal void *allocate_pages(u64 size_bytes)
+	{
+		void *out = mmap(nullptr, size_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		return out == MAP_FAILED ? nullptr : out;
+	}
+
+	internal void free_pages(void *memory, u64 size_bytes)
+	{
+		if (memory != nullptr)
+			munmap(memory, size_bytes);
+	}
+
+	// ===============================================================================================================================
+	// ====================================================== COMMAND LINE ===========================================================
+	// ===============================================================================================================================
+	internal void print_usage(const char *exe)
+	{
+		printf("usage: %s [-width W] [-height H] [-frames N] [-threads T] [-fps N] [-dump DIR] [-dump_every N] [-linear] [-trace FILE]\n"
+		       "       [-record FILE | -replay FILE] [-isa sse42|avx2|avx512]\n", exe);
+	}
+
+	internal Platform_Options parse_options(int argc, char **argv)
+	{
+		Platform_Options out
+		{
+			.width = 1280,
+			.height = 720,
+			.frames = 0,
+			.threads = 0,
+			.fps = 0,
+			.dump_every = 0,
+			.dump_dir = nullptr,
+			.is_linear = false,
+			.trace_file = nullptr,
+			.record_file = nullptr,
+			.replay_file = nullptr,
+			.max_isa = Cpu_Isa::AVX512,
+		};
+		b32 has_frames = false;
+
+		for (s32 i = 1; i < argc; ++i)
+		{
+			const char *arg = argv[i];
+			const char *value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+			b32 has_value = true;
+
+			if (!strcmp(arg, "-width") && value)
+				out.width = (u32)strtoul(value, nullptr, 10);
+			else if (!strcmp(arg, "-height") && value)
+				out.height = (u32)strtoul(value, nullptr, 10);
+			else if (!strcmp(arg, "-frames") && value)
+			{
+				out.frames = (u32)strtoul(value, nullptr, 10);
+				has_frames = true;
+			}
+			else if (!strcmp(arg, "-threads") && value)
+				out.threads = (u32)strtoul(value, nullptr, 10);
+			else if (!strcmp(arg, "-fps") && value)
+				out.fps = (u32)strtoul(value, nullptr, 10);
+			else if (!strcmp(arg, "-dump_every") && value)
+				out.dump_every = (u32)strtoul(value, nullptr, 10);
+			else if (!strcmp(arg, "-dump") && value)
+				out.dump_dir = value;
+			else if (!strcmp(arg, "-trace") && value)
+				out.trace_file = value;
+			else if (!strcmp(arg, "-record") && value)
+				out.record_file = value;
+			else if (!strcmp(arg, "-replay") && value)
+				out.replay_file = value;
+			else if (!strcmp(arg, "-isa") && value)
+			{
+				if (!cpu_isa_parse(value, &out.max_isa))
+				{
+					fprintf(stderr, "Unknown ISA \"%s\"\n", value);
+					exit(1);
+				}
+			}
+			else if (!strcmp(arg, "-linear"))
+			{
+				out.is_linear = true;
+				has_value = false;
+			}
+			else
+			{
+				has_value = false;
+				print_usage(argv[0]);
+				exit(!strcmp(arg, "-help") ? 0 : 1);
+			}
+
+			if (has_value)
+				++i;
+		}
+
+		if (out.dump_dir && out.dump_every == 0)
+			out.dump_every = 1;
+
+		// Replay runs until the recording ends unless limited explicitly
+		if (!has_frames && !out.replay_file)
+			out.frames = 600;
+
+		if (out.record_file && out.replay_file)
+		{
+			fprintf(stderr, "-record and -replay are exclusive\n");
+			exit(1);
+		}
+
+		return out;
+	}
+
+	// ===============================================================================================================================
+	// ========================================================= TIMERS ==============================================================
+	// ===============================================================================================================================
+	internal Platform_Clock clock_create(s32 fps = 60)
+	{
+		Platform_Clock out{ .target_fps = fps };
+		out.clock_freq = 1'000'000'000ull; // CLOCK_MONOTONIC ticks are nanoseconds
+		return out;
+	}
+
+	internal u64 get_performance_ticks()
+	{
+		timespec now{};
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		return (u64)now.tv_sec * 1'000'000'000ull + (u64)now.tv_nsec;
+	}
+
+	internal f64 get_elapsed_seconds_here(const Platform_Clock &clock, u64 tick_start)
+	{
+		return (f64)(get_performance_ticks() - tick_start) / clock.clock_freq;
+	}
+
+	internal f64 get_elapsed_ms_here(const Platform_Clock &clock, u64 tick_start)
+	{
+		return (f64)((get_performance_ticks() - tick_start) * 1000) / clock.clock_freq;
+	}
+
+	//? Hybrid pacing: "nanosleep" until calibrated margin before the deadline, then spin.
+	//? Every sleep is measured, so the margin follows oversleep of this machine instead of a guessed constant
+	internal void clock_update_and_wait(Platform_Clock &clock, Frame_Pacer *pacer, u64 tick_start)
+	{
+		if (pacer->target_s > 0.0)
+		{
+			f64 sleep_s = frame_pacer_sleep_budget(pacer, pacer->target_s - get_elapsed_seconds_here(clock, tick_start));
+			if (sleep_s > 0.0)
+			{
+				u64 sleep_start = get_performance_ticks();
+				timespec duration{ .tv_sec = (time_t)sleep_s, .tv_nsec = (long)((sleep_s - (f64)(time_t)sleep_s) * 1e9) };
+				nanosleep(&duration, nullptr);
+				frame_pacer_record_sleep(pacer, sleep_s, get_elapsed_seconds_here(clock, sleep_start));
+			}
+			while (get_elapsed_seconds_here(clock, tick_start) < pacer->target_s)
+				_mm_pause();
+		}
+
+		clock.delta_s = (f32)get_elapsed_seconds_here(clock, tick_start);
+	}
+
+	// ===============================================================================================================================
+	// ====================================================== FRAME OUTPUT ===========================================================
+	// ===============================================================================================================================
+	//? Binary PPM (P6), RGBA pixels with R in lowest byte - alpha is dropped, "row_scratch" must hold width*3 bytes
+	internal b32 write_frame_ppm(const char *file_name, const u32 *pixels, u32 width, u32 height, u32 pitch, byte *row_scratch)
+	{
+		FILE *file = fopen(file_name, "wb");
+		if (!file)
+			return false;
+		auto d = defer([&]
+		               {
+		               fclose(file);
+					   });
+
+		fprintf(file, "P6\n%u %u\n255\n", width, height);
+		for (u32 y = 0; y < height; ++y)
+		{
+			const u32 *row = (const u32 *)((const byte *)pixels + (u64)y * pitch);
+			for (u32 x = 0; x < width; ++x)
+			{
+				row_scratch[x * 3 + 0] = (byte)(row[x] >> 0);
+				row_scratch[x * 3 + 1] = (byte)(row[x] >> 8);
+				row_scratch[x * 3 + 2] = (byte)(row[x] >> 16);
+			}
+			if (fwrite(row_scratch, 3, width, file) != width)
+				return false;
+		}
+		return true;
+	}
+
+	internal b32 create_directory(const char *path)
+	{
+		return mkdir(path, 0755) == 0 || access(path, W_OK) == 0;
+	}
+
+	//? Stand-in for the mapped GPU texture and swap chain of Win32, touched only by present thread of frame ring
+	struct Present_Target
+	{
+		u32 *pixels;
+		u32 pitch;
+		u32 dump_every;
+		const char *dump_dir;
+		byte *dump_row;
+	};
+
+	internal void present_frame(void *user_data, const Frame_Ring_Slot *slot)
+	{
+		Present_Target *target = (Present_Target *)user_data;
+		frame_ring_stream_slot(target->pixels, target->pitch, slot);
+
+		if (target->dump_every && slot->frame_index % target->dump_every == 0)
+		{
+			char file_name[512];
+			snprintf(file_name, sizeof(file_name), "%s/frame_%06llu.ppm", target->dump_dir, (unsigned long long)slot->frame_index);
+			if (!write_frame_ppm(file_name, target->pixels, slot->width, slot->height, target->pitch, target->dump_row))
+				fprintf(stderr, "Failed to write \"%s\"\n", file_name);
+		}
+	}
+
+} // namespace Posix
@@ -0,0 +1,1617 @@
+#pragma once
+#include "Utils.hpp"
+#include "GameAsserts.hpp"
+#include "Allocators.hpp"
+#include "Math.hpp"
+#include "Game_Services.hpp"
+#include "Job_System.hpp"
+#include "Tiled_Surface.hpp"
+#include "Vertex_Transform.hpp"
+#include "Cpu_Features.hpp"
+
+//? Tile-binned software rasterizer, part of application layer.
+//? Frame is split into fixed size screen tiles. Front-end pass sets up triangles and bins them into every tile
+//? that their bounding box overlaps, back-end pass shades whole tiles in parallel - each core works only on
+//? a tile-sized color and depth working set, which stays in L1/L2 for all triangles of that tile.
+//? Binning is done in two passes (count, then fill) so bins are exact, contiguous and keep submission order.
+//? Color and depth of a tile use the tiled layout of "Tiled_Surface.hpp", so a screen tile is one contiguous run of memory.
+//? Tiled framebuffers are rendered in place, for linear ones every tile is rendered into per-worker scratch tile
+//? and resolved into the destination once finished, so linear memory is only ever written, once per pixel
+//? Depth, HiZ, bin counters and scratch tiles are allocated once for the maximum extent in "raster_create",
+//? a frame of any smaller size only rebinds dimensions (O(1)) and uses the first tiles of them, so resizing
+//? touches neither the allocator nor new pages. Frame arena holds only what depends on triangle count
+//? Input is screen space, geometry in clip space goes through "raster_clip_triangles" (near / far clipping and guard band) first
+//? Setup, tile clear and triangle kernels are compiled per ISA and picked by "g_cpu.isa" (see "Raster_Kernels"), all of them
+//? produce the same bits
+//! Intended to be included only by the application layer translation unit
+
+constexpr u32 RASTER_TILE_SIZE = TILED_TILE_SIZE;
+constexpr u32 RASTER_BLOCK_SIZE = TILED_BLOCK_SIZE; // matches 8 lanes of AVX2, so each block row is one register (half of AVX-512 one)
+constexpr u32 RASTER_BLOCKS_PER_TILE = (RASTER_TILE_SIZE / RASTER_BLOCK_SIZE) * (RASTER_TILE_SIZE / RASTER_BLOCK_SIZE);
+constexpr u32 RASTER_MAX_THREADS = 256;
+
+struct Raster_Vertex
+{
+	lib::Vec3 position; // x, y in pixels (screen space, y down), z is depth in [0, 1] - lower is closer
+	lib::Vec3 color;
+};
+
+struct Raster_Triangle
+{
+	Raster_Vertex v[3];
+};
+
+//? Triangle setup is done in fixed point: positions are snapped to 1/16 of pixel (28.4) and edge equations
+//? are exact integers, so coverage is watertight and deterministic. Edge "i" is opposite to vertex "i":
+//? E_i(X, Y) = a_i*X + b_i*Y + c_i in subpixel units, pixel is covered when E_i >= 0 at its center for all edges,
+//? "c_i" already includes top-left fill rule bias, so pixels on shared edges are hit by exactly one triangle.
+//? Attributes are interpolated with float plane equations relative to snapped vertex 0
+constexpr s32 RASTER_SUBPIXEL_BITS = 4;
+constexpr s32 RASTER_SUBPIXEL_ONE = 1 << RASTER_SUBPIXEL_BITS;
+constexpr s32 RASTER_SUBPIXEL_HALF = RASTER_SUBPIXEL_ONE / 2;
+
+//? Vertices must stay within +-RASTER_GUARD_BAND pixels, so that |a|, |b| <= 2^18 and per tile edge offsets
+//? (64 pixels * 16 subpixels * 2^18, both axes) stay below 2^29. Thanks to that, edge value at a tile origin
+//? can be clamped to +-RASTER_EDGE_CLAMP and stepped inside the tile with exact 32bit adds without changing its sign
+constexpr s32 RASTER_GUARD_BAND = 8192;
+constexpr s64 RASTER_EDGE_CLAMP = 1ll << 30;
+
+struct Raster_Setup
+{
+	s32 edge_a[3];
+	s32 edge_b[3];
+	s64 edge_c[3];
+
+	f32 origin_x, origin_y;
+	f32 z, z_dx, z_dy;
+	f32 z_min, z_max; // depth range of vertices, bounds the plane when testing against hierarchical Z
+	lib::Vec3 color, color_dx, color_dy;
+
+	// Inclusive pixel bounds clamped to the target, min > max means nothing to draw
+	s32 min_x, min_y, max_x, max_y;
+};
+
+//? Counters of the last rendered frame, gathered per thread (cache line each) and summed after the frame.
+//? Block counters are for 8x8 blocks of triangle bounds inside a tile, every visited block ends up in exactly one of
+//? "edge_rejected", "hiz_rejected" or "rasterized", "depth_accepted" is a subset of rasterized ones
+struct alignas(64) Raster_Stats
+{
+	u64 triangles_submitted;
+	u64 triangles_binned;
+	u64 bin_entries;
+
+	// Rejected before setup, every submitted triangle is either binned or in exactly one of these
+	u64 triangles_culled_facing;    // back-facing (front-facing) for "Raster_Cull_Mode::Back" ("Front")
+	u64 triangles_culled_zero_area; // degenerate after snapping to subpixels
+	u64 triangles_culled_bounds;    // bounds hold no pixel center of the target (small, off-target or past guard band)
+
+	u64 tiles_hiz_rejected;    // whole triangle behind farthest depth of the tile
+	u64 blocks_visited;
+	u64 blocks_edge_rejected;  // no pixel center of the block inside triangle
+	u64 blocks_hiz_rejected;   // triangle behind farthest depth of the block
+	u64 blocks_rasterized;
+	u64 blocks_depth_accepted; // triangle in front of nearest depth of the block, no per pixel depth test needed
+};
+
+inline void raster_stats_add(Raster_Stats *to, const Raster_Stats *from)
+{
+	to->triangles_submitted += from->triangles_submitted;
+	to->triangles_binned += from->triangles_binned;
+	to->bin_entries += from->bin_entries;
+	to->triangles_culled_facing += from->triangles_culled_facing;
+	to->triangles_culled_zero_area += from->triangles_culled_zero_area;
+	to->triangles_culled_bounds += from->triangles_culled_bounds;
+	to->tiles_hiz_rejected += from->tiles_hiz_rejected;
+	to->blocks_visited += from->blocks_visited;
+	to->blocks_edge_rejected += from->blocks_edge_rejected;
+	to->blocks_hiz_rejected += from->blocks_hiz_rejected;
+	to->blocks_rasterized += from->blocks_rasterized;
+	to->blocks_depth_accepted += from->blocks_depth_accepted;
+}
+
+enum class Raster_Kernel : u32
+{
+	Wide,   // SIMD kernel of "Raster_Context::isa", 8 (16 with AVX-512) pixels per iteration
+	Scalar, // reference, one pixel per iteration
+};
+
+//? Facing is winding on screen (y down), clockwise is front like D3D default
+enum class Raster_Cull_Mode : u32
+{
+	None,  // both drawn, counter-clockwise triangles are flipped by setup
+	Back,  // counter-clockwise rejected
+	Front, // clockwise rejected
+};
+
+struct Raster_Context
+{
+	Alloc_Arena frame_arena; // triangle setups and bin indices, lives only for a single frame
+	Job_System *jobs;
+	u32 thread_count; // also number of front-end slices, each bins a contiguous range of triangles
+	Raster_Kernel kernel;
+	Cpu_Isa isa; // of "g_raster_kernels", "g_cpu.isa" unless lowered (never raised) after create
+	Raster_Cull_Mode cull_mode;
+
+	u32 max_width;
+	u32 max_height;
+	u32 max_tiles;
+
+	// Active extent, rebound every frame
+	u32 width;
+	u32 height;
+	u32 tiles_x;
+	u32 tiles_y;
+
+	// Persistent, sized for "max_tiles"
+	f32 *depth; // tiled, same layout as color target
+	// Hierarchical Z: nearest and farthest depth of every tile and of every 8x8 block [tile][block]
+	f32 *hiz_tile_min;
+	f32 *hiz_tile_max;
+	f32 *hiz_block_min;
+	f32 *hiz_block_max;
+
+	u32 *scratch_tiles; // [worker][TILED_TILE_TEXELS], color of tile being rendered for linear framebuffers
+	u32 *coverage_hits; // [tile][texel] like "depth", inside lanes of every kernel add one, null unless validating (see "raster_validate_coverage")
+
+	u32 *bin_counts;  // [slice][tile], turned into write cursors after prefix sum
+	u32 *bin_offsets; // [tile + 1], beginning of each tile in "bin_indices"
+
+	// Per frame, from "frame_arena"
+	Raster_Setup *setups;
+	u32 *bin_indices;
+
+	Raster_Stats stats;
+	Raster_Stats thread_stats[RASTER_MAX_THREADS]; // [worker]
+};
+
+//? Bytes "raster_create" takes from its allocator on top of "frame_memory_size", including alignment padding
+inline u64 raster_memory_size(u32 max_width, u32 max_height, u32 thread_count)
+{
+	u64 tiles = tiled_tiles_x(max_width) * tiled_tiles_y(max_height);
+	u64 slices = lib::min(thread_count, RASTER_MAX_THREADS);
+	return tiles * TILED_TILE_TEXELS * sizeof(f32)               // depth
+	     + tiles * 2 * sizeof(f32)                               // tile HiZ
+	     + tiles * RASTER_BLOCKS_PER_TILE * 2 * sizeof(f32)      // block HiZ
+	     + slices * TILED_TILE_TEXELS * sizeof(u32)              // scratch tiles
+	     + slices * tiles * sizeof(u32) + (tiles + 1) * sizeof(u32) // bins
+	     + 8 * 64;
+}
+
+//? Frames of any size up to "max_width" x "max_height" can be rendered without allocating
+[[nodiscard]]
+inline Raster_Context raster_create(auto *allocator, const u64 frame_memory_size, Job_System *jobs, u32 max_width, u32 max_height)
+{
+	GameAssert(max_width && max_height);
+	Raster_Context out{};
+	out.frame_arena = arena_from_allocator(allocator, frame_memory_size);
+	out.jobs = jobs;
+	out.thread_count = lib::min(jobs->worker_count, RASTER_MAX_THREADS);
+	out.kernel = Raster_Kernel::Wide;
+	GameAssert(g_cpu.is_initialized && "Platform must call \"cpu_init\" first");
+	out.isa = g_cpu.isa;
+	out.cull_mode = Raster_Cull_Mode::None;
+
+	out.max_width = max_width;
+	out.max_height = max_height;
+	out.max_tiles = tiled_tiles_x(max_width) * tiled_tiles_y(max_height);
+	u64 tiles = out.max_tiles;
+	out.depth = (f32 *)allocate(allocator, tiles * TILED_TILE_TEXELS * sizeof(f32), 64);
+	out.hiz_tile_min = (f32 *)allocate(allocator, tiles * sizeof(f32), 64);
+	out.hiz_tile_max = (f32 *)allocate(allocator, tiles * sizeof(f32), 64);
+	out.hiz_block_min = (f32 *)allocate(allocator, tiles * RASTER_BLOCKS_PER_TILE * sizeof(f32), 64);
+	out.hiz_block_max = (f32 *)allocate(allocator, tiles * RASTER_BLOCKS_PER_TILE * sizeof(f32), 64);
+	out.scratch_tiles = (u32 *)allocate(allocator, (u64)out.thread_count * TILED_TILE_TEXELS * sizeof(u32), 64);
+	out.bin_counts = (u32 *)allocate(allocator, (u64)out.thread_count * tiles * sizeof(u32), 64);
+	out.bin_offsets = (u32 *)allocate(allocator, (tiles + 1) * sizeof(u32), 64);
+	return out;
+}
+
+//? O(1) switch of the active extent, tile "i" of any extent uses the same persistent memory
+inline void raster_bind_extent(Raster_Context *ctx, u32 width, u32 height)
+{
+	GameAssert(width <= ctx->max_width && height <= ctx->max_height && "Extent is bigger than what raster was created for");
+	ctx->width = width;
+	ctx->height = height;
+	ctx->tiles_x = tiled_tiles_x(width);
+	ctx->tiles_y = tiled_tiles_y(height);
+}
+
+inline u32 raster_pack_color(const lib::Vec3 c)
+{
+	u32 r = (u32)(lib::clamp(c.r, 0.0f, 1.0f) * 255.0f + 0.5f);
+	u32 g = (u32)(lib::clamp(c.g, 0.0f, 1.0f) * 255.0f + 0.5f);
+	u32 b = (u32)(lib::clamp(c.b, 0.0f, 1.0f) * 255.0f + 0.5f);
+	return (0xFFu << 24) | (b << 16) | (g << 8) | (r << 0);
+}
+
+inline s32 raster_to_fixed(const f32 f)
+{
+	return lib::round(f * (f32)RASTER_SUBPIXEL_ONE);
+}
+
+inline s64 raster_edge_at(const Raster_Setup *s, u32 edge, s32 pixel_x, s32 pixel_y)
+{
+	s64 x = ((s64)pixel_x << RASTER_SUBPIXEL_BITS) + RASTER_SUBPIXEL_HALF;
+	s64 y = ((s64)pixel_y << RASTER_SUBPIXEL_BITS) + RASTER_SUBPIXEL_HALF;
+	return s->edge_a[edge] * x + s->edge_b[edge] * y + s->edge_c[edge];
+}
+
+//? Counter-clockwise (on screen) triangles are flipped, there is no face culling at this stage.
+//? Degenerate (zero area after snapping) and out of guard band triangles are rejected
+internal void raster_setup_triangle(const Raster_Triangle *tri, Raster_Setup *out, u32 width, u32 height)
+{
+	out->min_x = out->min_y = 0;
+	out->max_x = out->max_y = -1;
+
+	Raster_Vertex v[3] = { tri->v[0], tri->v[1], tri->v[2] };
+	for (u32 i = 0; i < 3; ++i)
+	{
+		if (!(lib::abs(v[i].position.x) < (f32)RASTER_GUARD_BAND && lib::abs(v[i].position.y) < (f32)RASTER_GUARD_BAND))
+			return;
+	}
+
+	s32 fx[3], fy[3];
+	for (u32 i = 0; i < 3; ++i)
+	{
+		fx[i] = raster_to_fixed(v[i].position.x);
+		fy[i] = raster_to_fixed(v[i].position.y);
+	}
+
+	s64 area = (s64)(fx[1] - fx[0]) * (fy[2] - fy[0]) - (s64)(fy[1] - fy[0]) * (fx[2] - fx[0]);
+	if (area == 0)
+		return;
+	if (area < 0)
+	{
+		swap(v[1], v[2]);
+		swap(fx[1], fx[2]);
+		swap(fy[1], fy[2]);
+		area = -area;
+	}
+
+	for (u32 i = 0; i < 3; ++i)
+	{
+		u32 from = (i + 1) % 3;
+		u32 to = (i + 2) % 3;
+		s32 a = fy[from] - fy[to];
+		s32 b = fx[to] - fx[from];
+		// Top-left rule: interior is below a horizontal top edge or to the right of a left edge,
+		// every other edge does not own pixels lying exactly on it
+		b32 is_top_left = (a > 0) || (a == 0 && b > 0);
+		out->edge_a[i] = a;
+		out->edge_b[i] = b;
+		out->edge_c[i] = -((s64)a * fx[from] + (s64)b * fy[from]) - (is_top_left ? 0 : 1);
+	}
+
+	// d(lambda_i)/dx = a_i * 16 / area in pixel units, attributes are planes through snapped vertex 0
+	f32 pixel_area = (f32)area / (f32)(RASTER_SUBPIXEL_ONE * RASTER_SUBPIXEL_ONE);
+	f32 inv_area = 1.0f / pixel_area;
+	f32 l1_dx = (f32)out->edge_a[1] / RASTER_SUBPIXEL_ONE * inv_area;
+	f32 l1_dy = (f32)out->edge_b[1] / RASTER_SUBPIXEL_ONE * inv_area;
+	f32 l2_dx = (f32)out->edge_a[2] / RASTER_SUBPIXEL_ONE * inv_area;
+	f32 l2_dy = (f32)out->edge_b[2] / RASTER_SUBPIXEL_ONE * inv_area;
+
+	f32 dz1 = v[1].position.z - v[0].position.z;
+	f32 dz2 = v[2].position.z - v[0].position.z;
+	lib::Vec3 dcolor1 = v[1].color - v[0].color;
+	lib::Vec3 dcolor2 = v[2].color - v[0].color;
+
+	out->origin_x = (f32)fx[0] / RASTER_SUBPIXEL_ONE;
+	out->origin_y = (f32)fy[0] / RASTER_SUBPIXEL_ONE;
+	out->z = v[0].position.z;
+	out->z_min = lib::min(v[0].position.z, lib::min(v[1].position.z, v[2].position.z));
+	out->z_max = lib::max(v[0].position.z, lib::max(v[1].position.z, v[2].position.z));
+	out->z_dx = l1_dx * dz1 + l2_dx * dz2;
+	out->z_dy = l1_dy * dz1 + l2_dy * dz2;
+	out->color = v[0].color;
+	out->color_dx = l1_dx * dcolor1 + l2_dx * dcolor2;
+	out->color_dy = l1_dy * dcolor1 + l2_dy * dcolor2;
+
+	// Pixel "i" is covered only if its center 16*i + 8 lies within snapped bounds
+	s32 min_fx = lib::min(fx[0], lib::min(fx[1], fx[2]));
+	s32 min_fy = lib::min(fy[0], lib::min(fy[1], fy[2]));
+	s32 max_fx = lib::max(fx[0], lib::max(fx[1], fx[2]));
+	s32 max_fy = lib::max(fy[0], lib::max(fy[1], fy[2]));
+	out->min_x = lib::max((min_fx - RASTER_SUBPIXEL_HALF + RASTER_SUBPIXEL_ONE - 1) >> RASTER_SUBPIXEL_BITS, 0);
+	out->min_y = lib::max((min_fy - RASTER_SUBPIXEL_HALF + RASTER_SUBPIXEL_ONE - 1) >> RASTER_SUBPIXEL_BITS, 0);
+	out->max_x = lib::min((max_fx - RASTER_SUBPIXEL_HALF) >> RASTER_SUBPIXEL_BITS, (s32)width - 1);
+	out->max_y = lib::min((max_fy - RASTER_SUBPIXEL_HALF) >> RASTER_SUBPIXEL_BITS, (s32)height - 1);
+}
+
+inline b32 raster_setup_is_empty(const Raster_Setup *setup)
+{
+	return setup->min_x > setup->max_x || setup->min_y > setup->max_y;
+}
+
+//? Rejects triangles that can never produce a pixel before the full setup. Vertices are snapped exactly like
+//? "raster_setup_triangle" does, signed area is exact and bounds are rounded to pixel centers and clamped to the target,
+//? so what is rejected here would end up empty in setup anyway (face culling aside).
+//? Rejected triangles only get empty bounds written, survivors go through "raster_setup_triangle".
+//? On dense meshes half of the triangles face away and many more fall between pixel centers, none of them pays for
+//? a full setup anymore. Baseline version, one triangle per iteration, see "raster_setup_range_avx2" for 8
+internal void raster_setup_range_sse42(const Raster_Triangle *triangles, u32 first, u32 last, Raster_Setup *setups, u32 width, u32 height,
+                                       Raster_Cull_Mode cull_mode, Raster_Stats *stats)
+{
+	for (u32 i = first; i < last; ++i)
+	{
+		const Raster_Triangle *tri = &triangles[i];
+		Raster_Setup *setup = &setups[i];
+		setup->min_x = setup->min_y = 0;
+		setup->max_x = setup->max_y = -1;
+
+		b32 in_guard = true;
+		for (u32 v = 0; v < 3; ++v)
+			in_guard &= lib::abs(tri->v[v].position.x) < (f32)RASTER_GUARD_BAND && lib::abs(tri->v[v].position.y) < (f32)RASTER_GUARD_BAND;
+		if (!in_guard)
+		{
+			stats->triangles_culled_bounds++;
+			continue;
+		}
+
+		s32 fx[3], fy[3];
+		for (u32 v = 0; v < 3; ++v)
+		{
+			fx[v] = raster_to_fixed(tri->v[v].position.x);
+			fy[v] = raster_to_fixed(tri->v[v].position.y);
+		}
+		// Positive is clockwise on screen
+		s64 area = (s64)(fx[1] - fx[0]) * (fy[2] - fy[0]) - (s64)(fy[1] - fy[0]) * (fx[2] - fx[0]);
+		s32 min_x = lib::max((lib::min(fx[0], lib::min(fx[1], fx[2])) + RASTER_SUBPIXEL_ONE - 1 - RASTER_SUBPIXEL_HALF) >> RASTER_SUBPIXEL_BITS, 0);
+		s32 min_y = lib::max((lib::min(fy[0], lib::min(fy[1], fy[2])) + RASTER_SUBPIXEL_ONE - 1 - RASTER_SUBPIXEL_HALF) >> RASTER_SUBPIXEL_BITS, 0);
+		s32 max_x = lib::min((lib::max(fx[0], lib::max(fx[1], fx[2])) - RASTER_SUBPIXEL_HALF) >> RASTER_SUBPIXEL_BITS, (s32)width - 1);
+		s32 max_y = lib::min((lib::max(fy[0], lib::max(fy[1], fy[2])) - RASTER_SUBPIXEL_HALF) >> RASTER_SUBPIXEL_BITS, (s32)height - 1);
+
+		if (area == 0)
+			stats->triangles_culled_zero_area++;
+		else if ((cull_mode == Raster_Cull_Mode::Back && area < 0) || (cull_mode == Raster_Cull_Mode::Front && area > 0))
+			stats->triangles_culled_facing++;
+		else if (min_x > max_x || min_y > max_y)
+			stats->triangles_culled_bounds++;
+		else
+			raster_setup_triangle(tri, setup, width, height);
+	}
+}
+
+struct Raster_Tile_Rect
+{
+	s32 x0, y0, x1, y1; // inclusive, clamped to target
+};
+
+inline Raster_Tile_Rect raster_tile_rect(const Raster_Context *ctx, u32 tile_id)
+{
+	Raster_Tile_Rect out{};
+	out.x0 = (s32)((tile_id % ctx->tiles_x) * RASTER_TILE_SIZE);
+	out.y0 = (s32)((tile_id / ctx->tiles_x) * RASTER_TILE_SIZE);
+	out.x1 = lib::min(out.x0 + (s32)RASTER_TILE_SIZE, (s32)ctx->width) - 1;
+	out.y1 = lib::min(out.y0 + (s32)RASTER_TILE_SIZE, (s32)ctx->height) - 1;
+	return out;
+}
+
+//? Color and depth of the tile are cleared by "Raster_Kernels::tile_clear"
+internal void raster_tile_clear_hiz(const Raster_Context *ctx, u32 tile_id, const Raster_Tile_Rect rect)
+{
+	// Blocks of border tiles lying completely outside of the target must not hold back the farthest tile depth
+	ctx->hiz_tile_min[tile_id] = 1.0f;
+	ctx->hiz_tile_max[tile_id] = 1.0f;
+	for (u32 block = 0; block < RASTER_BLOCKS_PER_TILE; ++block)
+	{
+		s32 block_x = rect.x0 + (s32)((block % (RASTER_TILE_SIZE / RASTER_BLOCK_SIZE)) * RASTER_BLOCK_SIZE);
+		s32 block_y = rect.y0 + (s32)((block / (RASTER_TILE_SIZE / RASTER_BLOCK_SIZE)) * RASTER_BLOCK_SIZE);
+		b32 is_inside = block_x <= rect.x1 && block_y <= rect.y1;
+		ctx->hiz_block_min[tile_id * RASTER_BLOCKS_PER_TILE + block] = is_inside ? 1.0f : 3.402823466e+38f;
+		ctx->hiz_block_max[tile_id * RASTER_BLOCKS_PER_TILE + block] = is_inside ? 1.0f : -3.402823466e+38f;
+	}
+}
+
+//? Padding of border tiles is cleared as well, it is one contiguous run either way
+internal void raster_tile_clear_sse42(f32 *tile_depth, u32 *tile_color, u32 clear_color)
+{
+	const __m128i color_value = _mm_set1_epi32((s32)clear_color);
+	const __m128 depth_value = _mm_set1_ps(1.0f);
+	for (u32 i = 0; i < TILED_TILE_TEXELS; i += 4)
+	{
+		_mm_store_si128((__m128i *)(tile_color + i), color_value);
+		_mm_store_ps(tile_depth + i, depth_value);
+	}
+}
+
+//? Reference per-pixel path, kept for validation of the wide kernels (raster_bench "-kernel scalar" and "-compare").
+//? Exact 64bit edge value and a plain depth test at every pixel of triangle bounds clipped to the tile, no hierarchical Z.
+//? Depth and color are interpolated in the same order of operations as the wide kernels: plane evaluated at the top-left
+//? pixel of the 8x8 block, plus lane offset, then stepped down the rows. So both render the same bits and any difference
+//? is a bug in one of them
+internal void raster_triangle_scalar(const Raster_Context *ctx, const Raster_Setup *s, u32 tile_id, const Raster_Tile_Rect rect,
+                                     u32 *tile_color)
+{
+	f32 *tile_depth = ctx->depth + (u64)tile_id * TILED_TILE_TEXELS;
+	s32 min_x = lib::max(s->min_x, rect.x0);
+	s32 min_y = lib::max(s->min_y, rect.y0);
+	s32 max_x = lib::min(s->max_x, rect.x1);
+	s32 max_y = lib::min(s->max_y, rect.y1);
+	if (min_x > max_x || min_y > max_y)
+		return;
+
+	s32 first_block_x = rect.x0 + ((min_x - rect.x0) & ~(s32)(RASTER_BLOCK_SIZE - 1));
+	s32 first_block_y = rect.y0 + ((min_y - rect.y0) & ~(s32)(RASTER_BLOCK_SIZE - 1));
+	for (s32 block_y = first_block_y; block_y <= max_y; block_y += (s32)RASTER_BLOCK_SIZE)
+	{
+		for (s32 block_x = first_block_x; block_x <= max_x; block_x += (s32)RASTER_BLOCK_SIZE)
+		{
+			f32 dx = (f32)block_x + 0.5f - s->origin_x;
+			f32 dy = (f32)block_y + 0.5f - s->origin_y;
+			f32 block_z = s->z + dx * s->z_dx + dy * s->z_dy;
+			lib::Vec3 block_color = s->color + dx * s->color_dx + dy * s->color_dy;
+
+			for (s32 lane = 0; lane < (s32)RASTER_BLOCK_SIZE; ++lane)
+			{
+				s32 x = block_x + lane;
+				f32 z = block_z + (f32)lane * s->z_dx;
+				lib::Vec3 color = block_color + (f32)lane * s->color_dx;
+				for (s32 y = block_y; y < block_y + (s32)RASTER_BLOCK_SIZE; ++y)
+				{
+					if (x >= min_x && x <= max_x && y >= min_y && y <= max_y
+					    && (raster_edge_at(s, 0, x, y) | raster_edge_at(s, 1, x, y) | raster_edge_at(s, 2, x, y)) >= 0)
+					{
+						u32 texel = tiled_texel_in_tile((u32)(x - rect.x0), (u32)(y - rect.y0));
+						if (ctx->coverage_hits)
+							ctx->coverage_hits[(u64)tile_id * TILED_TILE_TEXELS + texel]++;
+						if (z < tile_depth[texel])
+						{
+							tile_depth[texel] = z;
+							tile_color[texel] = raster_pack_color(color);
+						}
+					}
+					z += s->z_dy;
+					color += s->color_dy;
+				}
+			}
+		}
+	}
+}
+
+//? Part of a triangle walk shared by all wide kernels, scalar and done once per triangle and tile.
+//? Helpers of the walk are inlined into every kernel, so they run as code of its ISA: a call into baseline SSE code
+//? from an AVX kernel spills all of its constants and pays for SSE / AVX transitions on every block
+struct Raster_Block_Walk
+{
+	s32 block_x0, block_y0, block_x1, block_y1; // blocks of triangle bounds inside of the tile, inclusive
+	s64 reach[3]; // largest increase of edge value from block origin to any other pixel center of the block
+	f32 z_reach_min, z_reach_max;
+};
+
+//? Block that passed edge and HiZ rejection, planes are evaluated at the center of its top-left pixel
+struct Raster_Block
+{
+	s32 x, y;
+	u32 index; // in tile
+	s32 rows;  // inside of the target
+	b32 depth_accepted;
+	s32 edge[3]; // clamped to +-RASTER_EDGE_CLAMP
+	f32 z;
+	lib::Vec3 color;
+};
+
+//? Returns false when whole triangle is behind the farthest depth of the tile
+force_inline b32 raster_walk_begin(const Raster_Context *ctx, const Raster_Setup *s, u32 tile_id, const Raster_Tile_Rect rect,
+                                   Raster_Block_Walk *out, Raster_Stats *stats)
+{
+	if (s->z_min >= ctx->hiz_tile_max[tile_id])
+	{
+		stats->tiles_hiz_rejected++;
+		return false;
+	}
+
+	out->block_x0 = (lib::max(s->min_x, rect.x0) - rect.x0) / (s32)RASTER_BLOCK_SIZE;
+	out->block_y0 = (lib::max(s->min_y, rect.y0) - rect.y0) / (s32)RASTER_BLOCK_SIZE;
+	out->block_x1 = (lib::min(s->max_x, rect.x1) - rect.x0) / (s32)RASTER_BLOCK_SIZE;
+	out->block_y1 = (lib::min(s->max_y, rect.y1) - rect.y0) / (s32)RASTER_BLOCK_SIZE;
+
+	constexpr s32 block_span = (RASTER_BLOCK_SIZE - 1) << RASTER_SUBPIXEL_BITS;
+	for (u32 i = 0; i < 3; ++i)
+		out->reach[i] = lib::max((s64)s->edge_a[i] * block_span, (s64)0) + lib::max((s64)s->edge_b[i] * block_span, (s64)0);
+	out->z_reach_min = lib::min(s->z_dx * 7.0f, 0.0f) + lib::min(s->z_dy * 7.0f, 0.0f);
+	out->z_reach_max = lib::max(s->z_dx * 7.0f, 0.0f) + lib::max(s->z_dy * 7.0f, 0.0f);
+	return true;
+}
+
+//? Returns false when no pixel center of the block is inside of the triangle or triangle is behind the farthest
+//? depth of the block (triangle depth over a block is bounded by the plane at block corners clamped to vertices depth range)
+force_inline b32 raster_block_begin(const Raster_Setup *s, const Raster_Block_Walk *walk, const Raster_Tile_Rect rect, s32 block_x, s32 block_y,
+                                    const f32 *hiz_block_min, const f32 *hiz_block_max, Raster_Block *out, Raster_Stats *stats)
+{
+	s32 x = rect.x0 + block_x * (s32)RASTER_BLOCK_SIZE;
+	s32 y = rect.y0 + block_y * (s32)RASTER_BLOCK_SIZE;
+	stats->blocks_visited++;
+
+	s64 origin[3];
+	b32 is_empty = false;
+	for (u32 i = 0; i < 3; ++i)
+	{
+		origin[i] = raster_edge_at(s, i, x, y);
+		is_empty |= (origin[i] + walk->reach[i]) < 0;
+	}
+	if (is_empty)
+	{
+		stats->blocks_edge_rejected++;
+		return false;
+	}
+
+	f32 dx = (f32)x + 0.5f - s->origin_x;
+	f32 dy = (f32)y + 0.5f - s->origin_y;
+	f32 z_origin = s->z + dx * s->z_dx + dy * s->z_dy;
+	f32 z_near = lib::max(z_origin + walk->z_reach_min, s->z_min);
+	f32 z_far = lib::min(z_origin + walk->z_reach_max, s->z_max);
+
+	u32 block = (u32)(block_y * (s32)(RASTER_TILE_SIZE / RASTER_BLOCK_SIZE) + block_x);
+	if (z_near >= hiz_block_max[block])
+	{
+		stats->blocks_hiz_rejected++;
+		return false;
+	}
+	out->depth_accepted = z_far < hiz_block_min[block];
+	stats->blocks_rasterized++;
+	stats->blocks_depth_accepted += out->depth_accepted;
+
+	out->x = x;
+	out->y = y;
+	out->index = block;
+	out->rows = lib::min((s32)RASTER_BLOCK_SIZE, rect.y1 - y + 1);
+	for (u32 i = 0; i < 3; ++i)
+		out->edge[i] = (s32)lib::clamp(origin[i], -RASTER_EDGE_CLAMP, RASTER_EDGE_CLAMP);
+	out->z = z_origin;
+	out->color = s->color + dx * s->color_dx + dy * s->color_dy;
+	return true;
+}
+
+force_inline f32 raster_hmin(__m128 v)
+{
+	v = _mm_min_ps(v, _mm_movehl_ps(v, v));
+	v = _mm_min_ss(v, _mm_movehdup_ps(v));
+	return _mm_cvtss_f32(v);
+}
+
+force_inline f32 raster_hmax(__m128 v)
+{
+	v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+	v = _mm_max_ss(v, _mm_movehdup_ps(v));
+	return _mm_cvtss_f32(v);
+}
+
+//? Tile HiZ is rebuilt from its blocks after a triangle wrote into any of them
+force_inline void raster_tile_hiz_update(const Raster_Context *ctx, u32 tile_id)
+{
+	const f32 *hiz_block_min = ctx->hiz_block_min + (u64)tile_id * RASTER_BLOCKS_PER_TILE;
+	const f32 *hiz_block_max = ctx->hiz_block_max + (u64)tile_id * RASTER_BLOCKS_PER_TILE;
+	__m128 tile_min = _mm_load_ps(hiz_block_min);
+	__m128 tile_max = _mm_load_ps(hiz_block_max);
+	for (u32 block = 4; block < RASTER_BLOCKS_PER_TILE; block += 4)
+	{
+		tile_min = _mm_min_ps(tile_min, _mm_load_ps(hiz_block_min + block));
+		tile_max = _mm_max_ps(tile_max, _mm_load_ps(hiz_block_max + block));
+	}
+	ctx->hiz_tile_min[tile_id] = raster_hmin(tile_min);
+	ctx->hiz_tile_max[tile_id] = raster_hmax(tile_max);
+}
+
+//? Triangle is walked in 8x8 blocks of its bounds inside the tile, hierarchical Z rejects first:
+//? whole triangle against the farthest depth of the tile, then every block against the farthest depth of the block.
+//? Surviving blocks are shaded one block row per iteration: edge values are computed exactly in 64bit at the block
+//? origin, clamped (see RASTER_EDGE_CLAMP) and stepped with 32bit integer adds only, depth and color planes are
+//? stepped down the rows. Every block row is aligned in the tiled color and depth targets, so results are blended in
+//? and written with plain stores. Lanes outside of the triangle are rejected by the edge test itself, only lanes past
+//? the right border of the target (tile padding) are masked explicitly.
+//? Baseline version, a block row is two 4 lane halves doing exactly the operations of "raster_triangle_avx2" lanes,
+//? so pixels, depth and HiZ are bit identical to it
+internal void raster_triangle_sse42(const Raster_Context *ctx, const Raster_Setup *s, u32 tile_id, const Raster_Tile_Rect rect,
+                                    u32 *tile_color, Raster_Stats *stats)
+{
+	Raster_Block_Walk walk;
+	if (!raster_walk_begin(ctx, s, tile_id, rect, &walk, stats))
+		return;
+
+	f32 *hiz_block_min = ctx->hiz_block_min + (u64)tile_id * RASTER_BLOCKS_PER_TILE;
+	f32 *hiz_block_max = ctx->hiz_block_max + (u64)tile_id * RASTER_BLOCKS_PER_TILE;
+	f32 *tile_depth = ctx->depth + (u64)tile_id * TILED_TILE_TEXELS;
+	u32 *tile_hits = ctx->coverage_hits ? ctx->coverage_hits + (u64)tile_id * TILED_TILE_TEXELS : nullptr;
+
+	const __m128i lane_ids[2] = { _mm_setr_epi32(0, 1, 2, 3), _mm_setr_epi32(4, 5, 6, 7) };
+	__m128i lane_step[2][3], step_y[3];
+	__m128 z_lanes[2], color_lanes[2][3];
+	for (u32 h = 0; h < 2; ++h)
+	{
+		__m128 lane_offsets = _mm_cvtepi32_ps(lane_ids[h]);
+		for (u32 i = 0; i < 3; ++i)
+			lane_step[h][i] = _mm_mullo_epi32(lane_ids[h], _mm_set1_epi32(s->edge_a[i] << RASTER_SUBPIXEL_BITS));
+		z_lanes[h] = _mm_mul_ps(lane_offsets, _mm_set1_ps(s->z_dx));
+		for (u32 c = 0; c < 3; ++c)
+			color_lanes[h][c] = _mm_mul_ps(lane_offsets, _mm_set1_ps(s->color_dx[c]));
+	}
+	for (u32 i = 0; i < 3; ++i)
+		step_y[i] = _mm_set1_epi32(s->edge_b[i] << RASTER_SUBPIXEL_BITS);
+
+	const __m128 z_dy = _mm_set1_ps(s->z_dy);
+	const __m128 color_dy[3] = { _mm_set1_ps(s->color_dy.r), _mm_set1_ps(s->color_dy.g), _mm_set1_ps(s->color_dy.b) };
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 scale = _mm_set1_ps(255.0f);
+	const __m128 half = _mm_set1_ps(0.5f);
+	const __m128 far_min = _mm_set1_ps(3.402823466e+38f);
+	const __m128 far_max = _mm_set1_ps(-3.402823466e+38f);
+	const __m128i alpha = _mm_set1_epi32((s32)0xFF000000);
+
+	b32 tile_changed = false;
+	for (s32 block_y = walk.block_y0; block_y <= walk.block_y1; ++block_y)
+	{
+		for (s32 block_x = walk.block_x0; block_x <= walk.block_x1; ++block_x)
+		{
+			Raster_Block block;
+			if (!raster_block_begin(s, &walk, rect, block_x, block_y, hiz_block_min, hiz_block_max, &block, stats))
+				continue;
+
+			__m128i e[2][3];
+			__m128 z[2], color[2][3], in_target[2];
+			for (u32 h = 0; h < 2; ++h)
+			{
+				for (u32 i = 0; i < 3; ++i)
+					e[h][i] = _mm_add_epi32(_mm_set1_epi32(block.edge[i]), lane_step[h][i]);
+				z[h] = _mm_add_ps(_mm_set1_ps(block.z), z_lanes[h]);
+				for (u32 c = 0; c < 3; ++c)
+					color[h][c] = _mm_add_ps(_mm_set1_ps(block.color[c]), color_lanes[h][c]);
+				in_target[h] = _mm_castsi128_ps(_mm_cmpgt_epi32(_mm_set1_epi32(rect.x1 - block.x + 1), lane_ids[h]));
+			}
+
+			u32 *block_color = tile_color + block.index * TILED_BLOCK_TEXELS;
+			f32 *block_depth = tile_depth + block.index * TILED_BLOCK_TEXELS;
+			__m128 block_min = far_min;
+			__m128 block_max = far_max;
+			b32 written = false;
+
+			for (s32 row = 0; row < block.rows; ++row)
+			{
+				for (u32 h = 0; h < 2; ++h)
+				{
+					u32 *color_row = block_color + row * RASTER_BLOCK_SIZE + h * 4;
+					f32 *depth_row = block_depth + row * RASTER_BLOCK_SIZE + h * 4;
+
+					// Sign bit of (e0 | e1 | e2) is set when any of edges is negative
+					__m128i outside = _mm_or_si128(_mm_or_si128(e[h][0], e[h][1]), e[h][2]);
+					__m128 inside = _mm_and_ps(in_target[h], _mm_castsi128_ps(_mm_cmpgt_epi32(outside, _mm_set1_epi32(-1))));
+					if (tile_hits)
+					{
+						// Inside lanes are -1
+						__m128i *hits = (__m128i *)(tile_hits + block.index * TILED_BLOCK_TEXELS + row * RASTER_BLOCK_SIZE + h * 4);
+						_mm_store_si128(hits, _mm_sub_epi32(_mm_load_si128(hits), _mm_castps_si128(inside)));
+					}
+					__m128 depth = _mm_load_ps(depth_row);
+					__m128 visible = block.depth_accepted ? inside : _mm_and_ps(inside, _mm_cmplt_ps(z[h], depth));
+
+					if (_mm_movemask_ps(visible))
+					{
+						__m128i rgb[3];
+						for (u32 c = 0; c < 3; ++c)
+						{
+							__m128 channel = _mm_min_ps(_mm_max_ps(color[h][c], zero), one);
+							rgb[c] = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(channel, scale), half));
+						}
+						__m128i packed = _mm_or_si128(_mm_or_si128(rgb[0], _mm_slli_epi32(rgb[1], 8)),
+						                              _mm_or_si128(_mm_slli_epi32(rgb[2], 16), alpha));
+
+						depth = _mm_blendv_ps(depth, z[h], visible);
+						__m128 old_color = _mm_load_ps((const f32 *)color_row);
+						_mm_store_ps(depth_row, depth);
+						_mm_store_ps((f32 *)color_row, _mm_blendv_ps(old_color, _mm_castsi128_ps(packed), visible));
+						written = true;
+					}
+
+					block_min = _mm_min_ps(block_min, _mm_blendv_ps(far_min, depth, in_target[h]));
+					block_max = _mm_max_ps(block_max, _mm_blendv_ps(far_max, depth, in_target[h]));
+
+					for (u32 i = 0; i < 3; ++i)
+						e[h][i] = _mm_add_epi32(e[h][i], step_y[i]);
+					z[h] = _mm_add_ps(z[h], z_dy);
+					for (u32 c = 0; c < 3; ++c)
+						color[h][c] = _mm_add_ps(color[h][c], color_dy[c]);
+				}
+			}
+
+			if (written)
+			{
+				hiz_block_min[block.index] = raster_hmin(block_min);
+				hiz_block_max[block.index] = raster_hmax(block_max);
+				tile_changed = true;
+			}
+		}
+	}
+
+	if (tile_changed)
+		raster_tile_hiz_update(ctx, tile_id);
+}
+
+CPU_TARGET_AVX2_BEGIN
+//? "raster_setup_range_sse42" for 8 triangles per iteration, signed area is exact as well (products of 19 bit values fit into f64)
+internal void raster_setup_range_avx2(const Raster_Triangle *triangles, u32 first, u32 last, Raster_Setup *setups, u32 width, u32 height,
+                                      Raster_Cull_Mode cull_mode, Raster_Stats *stats)
+{
+	constexpr s32 stride = sizeof(Raster_Triangle) / sizeof(f32);
+	static_assert(sizeof(Raster_Triangle) % sizeof(f32) == 0);
+	const __m256i lane_ids = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	const __m256i offsets = _mm256_mullo_epi32(lane_ids, _mm256_set1_epi32(stride));
+	const __m256 guard_band = _mm256_set1_ps((f32)RASTER_GUARD_BAND);
+	const __m256 subpixel_one = _mm256_set1_ps((f32)RASTER_SUBPIXEL_ONE);
+	const __m256 sign_mask = _mm256_set1_ps(-0.0f);
+	const __m256i round_up = _mm256_set1_epi32(RASTER_SUBPIXEL_ONE - 1 - RASTER_SUBPIXEL_HALF);
+	const __m256i half = _mm256_set1_epi32(RASTER_SUBPIXEL_HALF);
+	const __m256i max_x = _mm256_set1_epi32((s32)width - 1);
+	const __m256i max_y = _mm256_set1_epi32((s32)height - 1);
+
+	for (u32 i = first; i < last; i += 8)
+	{
+		u32 lanes = lib::min(last - i, 8u);
+		u32 valid = (1u << lanes) - 1;
+		__m256 load_mask = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32((s32)lanes), lane_ids));
+
+		__m256i fx[3], fy[3];
+		__m256 in_guard = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+		for (u32 v = 0; v < 3; ++v)
+		{
+			const f32 *position = &triangles[i].v[v].position.x;
+			__m256 x = _mm256_mask_i32gather_ps(_mm256_setzero_ps(), position, offsets, load_mask, sizeof(f32));
+			__m256 y = _mm256_mask_i32gather_ps(_mm256_setzero_ps(), position + 1, offsets, load_mask, sizeof(f32));
+			in_guard = _mm256_and_ps(in_guard, _mm256_cmp_ps(_mm256_andnot_ps(sign_mask, x), guard_band, _CMP_LT_OQ));
+			in_guard = _mm256_and_ps(in_guard, _mm256_cmp_ps(_mm256_andnot_ps(sign_mask, y), guard_band, _CMP_LT_OQ));
+			fx[v] = _mm256_cvtps_epi32(_mm256_round_ps(_mm256_mul_ps(x, subpixel_one), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+			fy[v] = _mm256_cvtps_epi32(_mm256_round_ps(_mm256_mul_ps(y, subpixel_one), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+		}
+
+		// area = (x1 - x0) * (y2 - y0) - (y1 - y0) * (x2 - x0), positive is clockwise on screen
+		__m256i dx1 = _mm256_sub_epi32(fx[1], fx[0]);
+		__m256i dy1 = _mm256_sub_epi32(fy[1], fy[0]);
+		__m256i dx2 = _mm256_sub_epi32(fx[2], fx[0]);
+		__m256i dy2 = _mm256_sub_epi32(fy[2], fy[0]);
+		u32 positive = 0;
+		u32 negative = 0;
+		for (u32 part = 0; part < 2; ++part)
+		{
+			auto to_f64 = [part](__m256i v)
+			{
+				return _mm256_cvtepi32_pd(part ? _mm256_extracti128_si256(v, 1) : _mm256_castsi256_si128(v));
+			};
+			__m256d area = _mm256_fmsub_pd(to_f64(dx1), to_f64(dy2), _mm256_mul_pd(to_f64(dy1), to_f64(dx2)));
+			positive |= (u32)_mm256_movemask_pd(_mm256_cmp_pd(area, _mm256_setzero_pd(), _CMP_GT_OQ)) << (4 * part);
+			negative |= (u32)_mm256_movemask_pd(_mm256_cmp_pd(area, _mm256_setzero_pd(), _CMP_LT_OQ)) << (4 * part);
+		}
+
+		// Same pixel bounds as setup, a pixel is only covered when its center lies within snapped bounds
+		__m256i min_fx = _mm256_min_epi32(fx[0], _mm256_min_epi32(fx[1], fx[2]));
+		__m256i min_fy = _mm256_min_epi32(fy[0], _mm256_min_epi32(fy[1], fy[2]));
+		__m256i max_fx = _mm256_max_epi32(fx[0], _mm256_max_epi32(fx[1], fx[2]));
+		__m256i max_fy = _mm256_max_epi32(fy[0], _mm256_max_epi32(fy[1], fy[2]));
+		__m256i x0 = _mm256_max_epi32(_mm256_srai_epi32(_mm256_add_epi32(min_fx, round_up), RASTER_SUBPIXEL_BITS), _mm256_setzero_si256());
+		__m256i y0 = _mm256_max_epi32(_mm256_srai_epi32(_mm256_add_epi32(min_fy, round_up), RASTER_SUBPIXEL_BITS), _mm256_setzero_si256());
+		__m256i x1 = _mm256_min_epi32(_mm256_srai_epi32(_mm256_sub_epi32(max_fx, half), RASTER_SUBPIXEL_BITS), max_x);
+		__m256i y1 = _mm256_min_epi32(_mm256_srai_epi32(_mm256_sub_epi32(max_fy, half), RASTER_SUBPIXEL_BITS), max_y);
+		__m256i no_sample = _mm256_or_si256(_mm256_cmpgt_epi32(x0, x1), _mm256_cmpgt_epi32(y0, y1));
+
+		u32 guarded = (u32)_mm256_movemask_ps(in_guard) & valid;
+		u32 sampled = ~(u32)_mm256_movemask_ps(_mm256_castsi256_ps(no_sample));
+		u32 zero_area = guarded & ~(positive | negative);
+		u32 culled_facing = guarded & (cull_mode == Raster_Cull_Mode::Back ? negative : cull_mode == Raster_Cull_Mode::Front ? positive : 0);
+		u32 survivors = guarded & (positive | negative) & ~culled_facing & sampled;
+
+		stats->triangles_culled_zero_area += _mm_popcnt_u32(zero_area);
+		stats->triangles_culled_facing += _mm_popcnt_u32(culled_facing);
+		stats->triangles_culled_bounds += _mm_popcnt_u32(valid & ~survivors & ~zero_area & ~culled_facing);
+
+		for (u32 lane = 0; lane < lanes; ++lane)
+		{
+			Raster_Setup *setup = &setups[i + lane];
+			if (survivors & (1u << lane))
+				raster_setup_triangle(&triangles[i + lane], setup, width, height);
+			else
+			{
+				setup->min_x = setup->min_y = 0;
+				setup->max_x = setup->max_y = -1;
+			}
+		}
+	}
+}
+
+internal void raster_tile_clear_avx2(f32 *tile_depth, u32 *tile_color, u32 clear_color)
+{
+	const __m256i color_value = _mm256_set1_epi32((s32)clear_color);
+	const __m256 depth_value = _mm256_set1_ps(1.0f);
+	for (u32 i = 0; i < TILED_TILE_TEXELS; i += 8)
+	{
+		_mm256_store_si256((__m256i *)(tile_color + i), color_value);
+		_mm256_store_ps(tile_depth + i, depth_value);
+	}
+}
+
+//? "raster_triangle_sse42" with a whole block row (8 pixels) in one register
+internal void raster_triangle_avx2(const Raster_Context *ctx, const Raster_Setup *s, u32 tile_id, const Raster_Tile_Rect rect,
+                                   u32 *tile_color, Raster_Stats *stats)
+{
+	Raster_Block_Walk walk;
+	if (!raster_walk_begin(ctx, s, tile_id, rect, &walk, stats))
+		return;
+
+	f32 *hiz_block_min = ctx->hiz_block_min + (u64)tile_id * RASTER_BLOCKS_PER_TILE;
+	f32 *hiz_block_max = ctx->hiz_block_max + (u64)tile_id * RASTER_BLOCKS_PER_TILE;
+	f32 *tile_depth = ctx->depth + (u64)tile_id * TILED_TILE_TEXELS;
+	u32 *tile_hits = ctx->coverage_hits ? ctx->coverage_hits + (u64)tile_id * TILED_TILE_TEXELS : nullptr;
+
+	const __m256i lane_ids = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	const __m256 lane_offsets = _mm256_cvtepi32_ps(lane_ids);
+	__m256i lane_step[3], step_y[3];
+	for (u32 i = 0; i < 3; ++i)
+	{
+		lane_step[i] = _mm256_mullo_epi32(lane_ids, _mm256_set1_epi32(s->edge_a[i] << RASTER_SUBPIXEL_BITS));
+		step_y[i] = _mm256_set1_epi32(s->edge_b[i] << RASTER_SUBPIXEL_BITS);
+	}
+
+	const __m256 z_lanes = _mm256_mul_ps(lane_offsets, _mm256_set1_ps(s->z_dx));
+	const __m256 z_dy = _mm256_set1_ps(s->z_dy);
+	const __m256 color_lanes[3] = { _mm256_mul_ps(lane_offsets, _mm256_set1_ps(s->color_dx.r)),
+	                                _mm256_mul_ps(lane_offsets, _mm256_set1_ps(s->color_dx.g)),
+	                                _mm256_mul_ps(lane_offsets, _mm256_set1_ps(s->color_dx.b)) };
+	const __m256 color_dy[3] = { _mm256_set1_ps(s->color_dy.r), _mm256_set1_ps(s->color_dy.g), _mm256_set1_ps(s->color_dy.b) };
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 scale = _mm256_set1_ps(255.0f);
+	const __m256 half = _mm256_set1_ps(0.5f);
+	const __m256 far_min = _mm256_set1_ps(3.402823466e+38f);
+	const __m256 far_max = _mm256_set1_ps(-3.402823466e+38f);
+	const __m256i alpha = _mm256_set1_epi32((s32)0xFF000000);
+
+	b32 tile_changed = false;
+	for (s32 block_y = walk.block_y0; block_y <= walk.block_y1; ++block_y)
+	{
+		for (s32 block_x = walk.block_x0; block_x <= walk.block_x1; ++block_x)
+		{
+			Raster_Block block;
+			if (!raster_block_begin(s, &walk, rect, block_x, block_y, hiz_block_min, hiz_block_max, &block, stats))
+				continue;
+
+			__m256i e[3];
+			for (u32 i = 0; i < 3; ++i)
+				e[i] = _mm256_add_epi32(_mm256_set1_epi32(block.edge[i]), lane_step[i]);
+			__m256 z = _mm256_add_ps(_mm256_set1_ps(block.z), z_lanes);
+			__m256 color[3];
+			for (u32 c = 0; c < 3; ++c)
+				color[c] = _mm256_add_ps(_mm256_set1_ps(block.color[c]), color_lanes[c]);
+
+			__m256 in_target = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(rect.x1 - block.x + 1), lane_ids));
+			u32 *block_color = tile_color + block.index * TILED_BLOCK_TEXELS;
+			f32 *block_depth = tile_depth + block.index * TILED_BLOCK_TEXELS;
+			__m256 block_min = far_min;
+			__m256 block_max = far_max;
+			b32 written = false;
+
+			for (s32 row = 0; row < block.rows; ++row)
+			{
+				u32 *color_row = block_color + row * RASTER_BLOCK_SIZE;
+				f32 *depth_row = block_depth + row * RASTER_BLOCK_SIZE;
+
+				// Sign bit of (e0 | e1 | e2) is set when any of edges is negative
+				__m256i outside = _mm256_or_si256(_mm256_or_si256(e[0], e[1]), e[2]);
+				__m256 inside = _mm256_and_ps(in_target, _mm256_castsi256_ps(_mm256_cmpgt_epi32(outside, _mm256_set1_epi32(-1))));
+				if (tile_hits)
+				{
+					// Inside lanes are -1
+					__m256i *hits = (__m256i *)(tile_hits + block.index * TILED_BLOCK_TEXELS + row * RASTER_BLOCK_SIZE);
+					_mm256_store_si256(hits, _mm256_sub_epi32(_mm256_load_si256(hits), _mm256_castps_si256(inside)));
+				}
+				__m256 depth = _mm256_load_ps(depth_row);
+				__m256 visible = block.depth_accepted ? inside : _mm256_and_ps(inside, _mm256_cmp_ps(z, depth, _CMP_LT_OQ));
+
+				if (_mm256_movemask_ps(visible))
+				{
+					// No FMA here, baseline kernel has none and both must round the same
+					__m256i rgb[3];
+					for (u32 c = 0; c < 3; ++c)
+					{
+						__m256 channel = _mm256_min_ps(_mm256_max_ps(color[c], zero), one);
+						rgb[c] = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(channel, scale), half));
+					}
+					__m256i packed = _mm256_or_si256(_mm256_or_si256(rgb[0], _mm256_slli_epi32(rgb[1], 8)),
+					                                 _mm256_or_si256(_mm256_slli_epi32(rgb[2], 16), alpha));
+
+					depth = _mm256_blendv_ps(depth, z, visible);
+					__m256 old_color = _mm256_load_ps((const f32 *)color_row);
+					_mm256_store_ps(depth_row, depth);
+					_mm256_store_ps((f32 *)color_row, _mm256_blendv_ps(old_color, _mm256_castsi256_ps(packed), visible));
+					written = true;
+				}
+
+				block_min = _mm256_min_ps(block_min, _mm256_blendv_ps(far_min, depth, in_target));
+				block_max = _mm256_max_ps(block_max, _mm256_blendv_ps(far_max, depth, in_target));
+
+				for (u32 i = 0; i < 3; ++i)
+					e[i] = _mm256_add_epi32(e[i], step_y[i]);
+				z = _mm256_add_ps(z, z_dy);
+				for (u32 c = 0; c < 3; ++c)
+					color[c] = _mm256_add_ps(color[c], color_dy[c]);
+			}
+
+			if (written)
+			{
+				hiz_block_min[block.index] = raster_hmin(_mm_min_ps(_mm256_castps256_ps128(block_min), _mm256_extractf128_ps(block_min, 1)));
+				hiz_block_max[block.index] = raster_hmax(_mm_max_ps(_mm256_castps256_ps128(block_max), _mm256_extractf128_ps(block_max, 1)));
+				tile_changed = true;
+			}
+		}
+	}
+
+	if (tile_changed)
+		raster_tile_hiz_update(ctx, tile_id);
+}
+CPU_TARGET_END
+
+CPU_TARGET_AVX512_BEGIN
+//? Next pair of block rows [r + 2 | r + 3] from [r | r + 1] of a plane, the second row of a pair is always the first
+//? one plus "dy", so every row gets exactly the sequence of adds it gets from an 8 lane kernel
+inline __m512 raster_next_row_pair(const __m512 rows, const __m512 dy)
+{
+	__m512 last = _mm512_shuffle_f32x4(rows, rows, _MM_SHUFFLE(3, 2, 3, 2));
+	__m512 next = _mm512_add_ps(last, dy);
+	return _mm512_mask_add_ps(next, 0xFF00, next, dy);
+}
+
+//? First pair of block rows [r | r + 1] of a plane from row "r"
+inline __m512 raster_first_row_pair(const __m256 row, const __m512 dy)
+{
+	__m512 rows = _mm512_insertf32x8(_mm512_castps256_ps512(row), row, 1);
+	return _mm512_mask_add_ps(rows, 0xFF00, rows, dy);
+}
+
+//? "raster_triangle_avx2" with two block rows (16 pixels) per iteration. Lanes are masked with AVX-512 masks,
+//? so visible pixels are written with masked stores and nothing is blended. Last row of a block with odd row count
+//? (bottom border of the target) is masked off, the padding row it pairs with is loaded and stored back unchanged
+internal void raster_triangle_avx512(const Raster_Context *ctx, const Raster_Setup *s, u32 tile_id, const Raster_Tile_Rect rect,
+                                     u32 *tile_color, Raster_Stats *stats)
+{
+	Raster_Block_Walk walk;
+	if (!raster_walk_begin(ctx, s, tile_id, rect, &walk, stats))
+		return;
+
+	f32 *hiz_block_min = ctx->hiz_block_min + (u64)tile_id * RASTER_BLOCKS_PER_TILE;
+	f32 *hiz_block_max = ctx->hiz_block_max + (u64)tile_id * RASTER_BLOCKS_PER_TILE;
+	f32 *tile_depth = ctx->depth + (u64)tile_id * TILED_TILE_TEXELS;
+	u32 *tile_hits = ctx->coverage_hits ? ctx->coverage_hits + (u64)tile_id * TILED_TILE_TEXELS : nullptr;
+
+	const __m512i lane_ids = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+	const __m512i lane_x = _mm512_and_si512(lane_ids, _mm512_set1_epi32(RASTER_BLOCK_SIZE - 1));
+	const __m512i lane_row = _mm512_srli_epi32(lane_ids, 3);
+	const __m256 lane_offsets = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+	__m512i lane_step[3], step_y[3];
+	for (u32 i = 0; i < 3; ++i)
+	{
+		lane_step[i] = _mm512_add_epi32(_mm512_mullo_epi32(lane_x, _mm512_set1_epi32(s->edge_a[i] << RASTER_SUBPIXEL_BITS)),
+		                                _mm512_mullo_epi32(lane_row, _mm512_set1_epi32(s->edge_b[i] << RASTER_SUBPIXEL_BITS)));
+		step_y[i] = _mm512_set1_epi32((s->edge_b[i] << RASTER_SUBPIXEL_BITS) * 2);
+	}
+
+	const __m256 z_lanes = _mm256_mul_ps(lane_offsets, _mm256_set1_ps(s->z_dx));
+	const __m512 z_dy = _mm512_set1_ps(s->z_dy);
+	const __m256 color_lanes[3] = { _mm256_mul_ps(lane_offsets, _mm256_set1_ps(s->color_dx.r)),
+	                                _mm256_mul_ps(lane_offsets, _mm256_set1_ps(s->color_dx.g)),
+	                                _mm256_mul_ps(lane_offsets, _mm256_set1_ps(s->color_dx.b)) };
+	const __m512 color_dy[3] = { _mm512_set1_ps(s->color_dy.r), _mm512_set1_ps(s->color_dy.g), _mm512_set1_ps(s->color_dy.b) };
+	const __m512 zero = _mm512_setzero_ps();
+	const __m512 one = _mm512_set1_ps(1.0f);
+	const __m512 scale = _mm512_set1_ps(255.0f);
+	const __m512 half = _mm512_set1_ps(0.5f);
+	const __m512i alpha = _mm512_set1_epi32((s32)0xFF000000);
+
+	b32 tile_changed = false;
+	for (s32 block_y = walk.block_y0; block_y <= walk.block_y1; ++block_y)
+	{
+		for (s32 block_x = walk.block_x0; block_x <= walk.block_x1; ++block_x)
+		{
+			Raster_Block block;
+			if (!raster_block_begin(s, &walk, rect, block_x, block_y, hiz_block_min, hiz_block_max, &block, stats))
+				continue;
+
+			__m512i e[3];
+			for (u32 i = 0; i < 3; ++i)
+				e[i] = _mm512_add_epi32(_mm512_set1_epi32(block.edge[i]), lane_step[i]);
+			__m512 z = raster_first_row_pair(_mm256_add_ps(_mm256_set1_ps(block.z), z_lanes), z_dy);
+			__m512 color[3];
+			for (u32 c = 0; c < 3; ++c)
+				color[c] = raster_first_row_pair(_mm256_add_ps(_mm256_set1_ps(block.color[c]), color_lanes[c]), color_dy[c]);
+
+			__mmask16 in_target = _mm512_cmplt_epi32_mask(lane_x, _mm512_set1_epi32(rect.x1 - block.x + 1));
+			u32 *block_color = tile_color + block.index * TILED_BLOCK_TEXELS;
+			f32 *block_depth = tile_depth + block.index * TILED_BLOCK_TEXELS;
+			__m512 block_min = _mm512_set1_ps(3.402823466e+38f);
+			__m512 block_max = _mm512_set1_ps(-3.402823466e+38f);
+			b32 written = false;
+
+			for (s32 row = 0; row < block.rows; row += 2)
+			{
+				u32 *color_rows = block_color + row * RASTER_BLOCK_SIZE;
+				f32 *depth_rows = block_depth + row * RASTER_BLOCK_SIZE;
+				__mmask16 active = row + 1 < block.rows ? in_target : (__mmask16)(in_target & 0x00FF);
+
+				// Sign bit of (e0 | e1 | e2) is set when any of edges is negative
+				__m512i outside = _mm512_or_si512(_mm512_or_si512(e[0], e[1]), e[2]);
+				__mmask16 inside = _mm512_mask_cmpgt_epi32_mask(active, outside, _mm512_set1_epi32(-1));
+				if (tile_hits)
+				{
+					u32 *hits = tile_hits + block.index * TILED_BLOCK_TEXELS + row * RASTER_BLOCK_SIZE;
+					_mm512_store_si512(hits, _mm512_mask_add_epi32(_mm512_load_si512(hits), inside, _mm512_load_si512(hits), _mm512_set1_epi32(1)));
+				}
+				__m512 depth = _mm512_load_ps(depth_rows);
+				__mmask16 visible = block.depth_accepted ? inside : _mm512_mask_cmp_ps_mask(inside, z, depth, _CMP_LT_OQ);
+
+				if (visible)
+				{
+					__m512i rgb[3];
+					for (u32 c = 0; c < 3; ++c)
+					{
+						__m512 channel = _mm512_min_ps(_mm512_max_ps(color[c], zero), one);
+						rgb[c] = _mm512_cvttps_epi32(_mm512_add_ps(_mm512_mul_ps(channel, scale), half));
+					}
+					__m512i packed = _mm512_or_si512(_mm512_or_si512(rgb[0], _mm512_slli_epi32(rgb[1], 8)),
+					                                 _mm512_or_si512(_mm512_slli_epi32(rgb[2], 16), alpha));
+
+					depth = _mm512_mask_mov_ps(depth, visible, z);
+					_mm512_store_ps(depth_rows, depth);
+					_mm512_mask_store_epi32(color_rows, visible, packed);
+					written = true;
+				}
+
+				block_min = _mm512_mask_min_ps(block_min, active, block_min, depth);
+				block_max = _mm512_mask_max_ps(block_max, active, block_max, depth);
+
+				for (u32 i = 0; i < 3; ++i)
+					e[i] = _mm512_add_epi32(e[i], step_y[i]);
+				z = raster_next_row_pair(z, z_dy);
+				for (u32 c = 0; c < 3; ++c)
+					color[c] = raster_next_row_pair(color[c], color_dy[c]);
+			}
+
+			if (written)
+			{
+				hiz_block_min[block.index] = _mm512_reduce_min_ps(block_min);
+				hiz_block_max[block.index] = _mm512_reduce_max_ps(block_max);
+				tile_changed = true;
+			}
+		}
+	}
+
+	if (tile_changed)
+		raster_tile_hiz_update(ctx, tile_id);
+}
+CPU_TARGET_END
+
+//? Hot paths of the rasterizer compiled once per ISA (see "Cpu_Features.hpp"). Every table produces bit identical setups,
+//? stats, pixels and depth, so recordings replay the same on every machine and the ISA only changes speed
+struct Raster_Kernels
+{
+	void (*setup_range)(const Raster_Triangle *triangles, u32 first, u32 last, Raster_Setup *setups, u32 width, u32 height,
+	                    Raster_Cull_Mode cull_mode, Raster_Stats *stats);
+	void (*tile_clear)(f32 *tile_depth, u32 *tile_color, u32 clear_color);
+	void (*triangle)(const Raster_Context *ctx, const Raster_Setup *s, u32 tile_id, const Raster_Tile_Rect rect,
+	                 u32 *tile_color, Raster_Stats *stats);
+};
+
+//? [Cpu_Isa], AVX-512 only widens the triangle kernel, setup is bound by gathers and clear by stores
+global_variable const Raster_Kernels g_raster_kernels[] =
+{
+	{ raster_setup_range_sse42, raster_tile_clear_sse42, raster_triangle_sse42 },
+	{ raster_setup_range_avx2, raster_tile_clear_avx2, raster_triangle_avx2 },
+	{ raster_setup_range_avx2, raster_tile_clear_avx2, raster_triangle_avx512 },
+};
+static_assert(array_count_32(g_raster_kernels) == (u32)Cpu_Isa::Count);
+
+internal void raster_tile(const Raster_Context *ctx, u32 tile_id, const Game_Framebuffer *target, u32 clear_color,
+                          u32 worker_id, Raster_Stats *stats)
+{
+	const Raster_Kernels *kernels = &g_raster_kernels[(u32)ctx->isa];
+	b32 is_linear = target->layout == Game_Framebuffer_Layout::Linear;
+	u32 *tile_color = is_linear ? ctx->scratch_tiles + (u64)worker_id * TILED_TILE_TEXELS
+	                            : target->base + (u64)tile_id * TILED_TILE_TEXELS;
+
+	Raster_Tile_Rect rect = raster_tile_rect(ctx, tile_id);
+	raster_tile_clear_hiz(ctx, tile_id, rect);
+	kernels->tile_clear(ctx->depth + (u64)tile_id * TILED_TILE_TEXELS, tile_color, clear_color);
+
+	for (u32 bin_id = ctx->bin_offsets[tile_id]; bin_id < ctx->bin_offsets[tile_id + 1]; ++bin_id)
+	{
+		const Raster_Setup *setup = &ctx->setups[ctx->bin_indices[bin_id]];
+		if (ctx->kernel == Raster_Kernel::Wide)
+			kernels->triangle(ctx, setup, tile_id, rect, tile_color, stats);
+		else
+			raster_triangle_scalar(ctx, setup, tile_id, rect, tile_color);
+	}
+
+	if (is_linear)
+	{
+		u32 *dst = (u32 *)((byte *)target->base + (u64)rect.y0 * target->pitch) + rect.x0;
+		tiled_resolve_tile(dst, target->pitch, tile_color, (u32)(rect.x1 - rect.x0 + 1), (u32)(rect.y1 - rect.y0 + 1));
+	}
+}
+
+//? Sets up, bins and shades all triangles into "target", must be called from worker 0 of "ctx->jobs"
+//? Three fork-joins per frame: setup and count per slice, fill bins per slice, shade per tile
+inline void raster_render(Raster_Context *ctx, const Game_Framebuffer *target, u32 clear_color,
+                          const Raster_Triangle *triangles, u32 triangle_count)
+{
+	ProfileFunction();
+	u32 width = target->width;
+	u32 height = target->height;
+	GameAssert(width && height);
+	GameAssert(target->format == Game_Pixel_Format::RGBA8);
+	GameAssert(target->layout == Game_Framebuffer_Layout::Linear ? target->pitch >= width * sizeof(u32)
+	           : (target->tile_size == RASTER_TILE_SIZE && target->block_size == RASTER_BLOCK_SIZE));
+	GameAssert((u32)ctx->isa <= (u32)g_cpu.isa && "Kernels of an ISA the CPU does not have");
+	const Raster_Kernels *kernels = &g_raster_kernels[(u32)ctx->isa];
+	Alloc_Arena *arena = &ctx->frame_arena;
+	arena_reset(arena);
+
+	raster_bind_extent(ctx, width, height);
+	u32 tiles_count = ctx->tiles_x * ctx->tiles_y;
+	u32 slices = ctx->thread_count;
+
+	ctx->setups = (Raster_Setup *)allocate(arena, (u64)lib::max(triangle_count, 1u) * sizeof(Raster_Setup), 64);
+	ctx->bin_indices = nullptr;
+
+	for (u32 t = 0; t < ctx->thread_count; ++t)
+		ctx->thread_stats[t] = {};
+
+	// Front-end: setup and count tile overlaps of every slice's contiguous triangle range
+	parallel_for(ctx->jobs, 0, "Raster Setup", 0, slices, 1, [&](u32 slice_begin, u32 slice_end, u32 worker_id)
+	{
+		Raster_Stats *stats = &ctx->thread_stats[worker_id];
+		for (u32 slice = slice_begin; slice < slice_end; ++slice)
+		{
+			u32 first = (u32)((u64)triangle_count * slice / slices);
+			u32 last = (u32)((u64)triangle_count * (slice + 1) / slices);
+			u32 *counts = ctx->bin_counts + (u64)slice * tiles_count;
+
+			memset(counts, 0, tiles_count * sizeof(u32));
+			kernels->setup_range(triangles, first, last, ctx->setups, width, height, ctx->cull_mode, stats);
+			for (u32 i = first; i < last; ++i)
+			{
+				const Raster_Setup *s = &ctx->setups[i];
+				if (raster_setup_is_empty(s))
+					continue;
+
+				stats->triangles_binned++;
+				for (s32 ty = s->min_y / (s32)RASTER_TILE_SIZE; ty <= s->max_y / (s32)RASTER_TILE_SIZE; ++ty)
+					for (s32 tx = s->min_x / (s32)RASTER_TILE_SIZE; tx <= s->max_x / (s32)RASTER_TILE_SIZE; ++tx)
+						counts[ty * ctx->tiles_x + tx]++;
+			}
+		}
+	});
+
+	// Tile-major, then slice order prefix sum, which preserves submission order inside every bin
+	u32 running = 0;
+	{
+		ProfileScope("Raster Prefix Sum");
+		for (u32 tile = 0; tile < tiles_count; ++tile)
+		{
+			ctx->bin_offsets[tile] = running;
+			for (u32 slice = 0; slice < slices; ++slice)
+			{
+				u32 *count = &ctx->bin_counts[(u64)slice * tiles_count + tile];
+				u32 start = running;
+				running += *count;
+				*count = start;
+			}
+		}
+		ctx->bin_offsets[tiles_count] = running;
+	}
+	ctx->bin_indices = (u32 *)allocate(arena, (u64)lib::max(running, 1u) * sizeof(u32), 64);
+
+	parallel_for(ctx->jobs, 0, "Raster Bin Fill", 0, slices, 1, [&](u32 slice_begin, u32 slice_end, u32 worker_id)
+	{
+		for (u32 slice = slice_begin; slice < slice_end; ++slice)
+		{
+			u32 first = (u32)((u64)triangle_count * slice / slices);
+			u32 last = (u32)((u64)triangle_count * (slice + 1) / slices);
+			u32 *counts = ctx->bin_counts + (u64)slice * tiles_count;
+
+			for (u32 i = first; i < last; ++i)
+			{
+				const Raster_Setup *s = &ctx->setups[i];
+				if (raster_setup_is_empty(s))
+					continue;
+
+				for (s32 ty = s->min_y / (s32)RASTER_TILE_SIZE; ty <= s->max_y / (s32)RASTER_TILE_SIZE; ++ty)
+					for (s32 tx = s->min_x / (s32)RASTER_TILE_SIZE; tx <= s->max_x / (s32)RASTER_TILE_SIZE; ++tx)
+						ctx->bin_indices[counts[ty * ctx->tiles_x + tx]++] = i;
+			}
+		}
+	});
+
+	// Back-end: one tile per job, tile cost varies a lot and idle workers steal the rest
+	parallel_for(ctx->jobs, 0, "Raster Tile", 0, tiles_count, 1, [&](u32 tile_begin, u32 tile_end, u32 worker_id)
+	{
+		for (u32 tile = tile_begin; tile < tile_end; ++tile)
+			raster_tile(ctx, tile, target, clear_color, worker_id, &ctx->thread_stats[worker_id]);
+	});
+
+	ctx->stats = {};
+	ctx->stats.triangles_submitted = triangle_count;
+	ctx->stats.bin_entries = ctx->bin_offsets[tiles_count];
+	for (u32 t = 0; t < ctx->thread_count; ++t)
+		raster_stats_add(&ctx->stats, &ctx->thread_stats[t]);
+}
+
+// ===============================================================================================================================
+// ======================================================== CLIPPING =============================================================
+// ===============================================================================================================================
+//? Front of the pipeline for geometry in homogeneous clip space (before perspective divide), visible volume is
+//? -w <= x, y <= w and 0 <= z <= w (D3D, same as "Viewport"). Only near and far planes are clipped against exactly.
+//? In x and y clipping happens at the guard band instead: a triangle leaving the viewport but staying inside of
+//? RASTER_GUARD_BAND is only divided and passed on, setup clamps its bounds to the target (scissor), which costs nothing
+//? and creates no new vertices. Sutherland-Hodgman runs only for triangles crossing near / far or reaching past
+//? the guard band (big ones close to the camera), "Raster_Clip_Stats" tells how often each path is taken.
+//? Near and far planes alone do not keep w > 0: a vertex at z == 0, w == 0 is inside of both 0 <= z and z <= w.
+//? So triangles are clipped against RASTER_CLIP_W_EPSILON <= w too, and the divide never sees w below it
+struct Raster_Clip_Vertex
+{
+	lib::Vec4 position; // clip space
+	lib::Vec3 color;
+};
+
+struct Raster_Clip_Triangle
+{
+	Raster_Clip_Vertex v[3];
+};
+
+//? Bit "i" of an outcode is set when vertex is outside of plane "i". Clipped ones come first, viewport sides
+//? (inside of the guard band) are used only to cull triangles that lie completely off-screen
+enum Raster_Clip_Plane : u32
+{
+	RASTER_CLIP_GUARD_RIGHT,  // x <= guard_x * w
+	RASTER_CLIP_GUARD_TOP,    // y <= guard_y * w
+	RASTER_CLIP_FAR,          // z <= w
+	RASTER_CLIP_GUARD_LEFT,   // -guard_x * w <= x
+	RASTER_CLIP_GUARD_BOTTOM, // -guard_y * w <= y
+	RASTER_CLIP_NEAR,         // 0 <= z
+	RASTER_CLIP_MIN_W,        // RASTER_CLIP_W_EPSILON <= w
+	RASTER_CLIP_PLANE_COUNT,
+
+	RASTER_CLIP_VIEWPORT_RIGHT = RASTER_CLIP_PLANE_COUNT, // x <= w
+	RASTER_CLIP_VIEWPORT_TOP,                             // y <= w
+	RASTER_CLIP_VIEWPORT_LEFT,                            // -w <= x
+	RASTER_CLIP_VIEWPORT_BOTTOM,                          // -w <= y
+};
+
+constexpr f32 RASTER_CLIP_W_EPSILON = 1e-5f; // far below w of any vertex in front of a near plane, 1 / w stays finite
+constexpr u32 RASTER_CLIP_PLANES_MASK = (1u << RASTER_CLIP_PLANE_COUNT) - 1;
+constexpr u32 RASTER_CLIP_VIEWPORT_MASK = 0xFu << RASTER_CLIP_VIEWPORT_RIGHT;
+constexpr u32 RASTER_CLIP_MAX_VERTICES = 3 + RASTER_CLIP_PLANE_COUNT; // every plane adds at most one vertex to a convex polygon
+constexpr u32 RASTER_CLIP_MAX_TRIANGLES = RASTER_CLIP_MAX_VERTICES - 2;
+
+//? Every submitted triangle ends up in exactly one of "culled", "inside", "guard_band" or "clipped"
+struct Raster_Clip_Stats
+{
+	u64 triangles_submitted;
+	u64 culled;        // all vertices outside of the same viewport side, near, far or minimum w plane
+	u64 inside;        // all vertices inside of the viewport, divide only
+	u64 guard_band;    // crossing viewport sides inside of the guard band, divide only, scissored by setup
+	u64 clipped;       // crossing near / far plane or guard band, replaced by a fan of the clipped polygon
+	u64 clipped_empty; // subset of "clipped" with nothing left, outside of the volume near one of its edges
+	u64 triangles_out;
+};
+
+inline void raster_clip_stats_add(Raster_Clip_Stats *to, const Raster_Clip_Stats *from)
+{
+	to->triangles_submitted += from->triangles_submitted;
+	to->culled += from->culled;
+	to->inside += from->inside;
+	to->guard_band += from->guard_band;
+	to->clipped += from->clipped;
+	to->clipped_empty += from->clipped_empty;
+	to->triangles_out += from->triangles_out;
+}
+
+//? Everything the clipper needs of a viewport, prepared once per batch
+struct Raster_Clipper
+{
+	__m128 guard_max; // (guard_x, guard_y, 1, 0), multiplied by w
+	__m128 guard_min; // (-guard_x, -guard_y, 0, 0), multiplied by w
+	lib::Vec4 planes[RASTER_CLIP_PLANE_COUNT]; // dot(plane, position) + offset >= 0 is inside
+	f32 offsets[RASTER_CLIP_PLANE_COUNT];      // 0 but for the minimum w plane, the only one not through the origin
+
+	lib::Vec3 screen_offset; // viewport center and min depth
+	lib::Vec3 screen_scale;  // half extent (y flipped) and depth range
+};
+
+//? Guard band is the largest |x / w|, |y / w| that keeps a vertex within RASTER_GUARD_BAND pixels after the divide,
+//? with a pixel of margin for rounding of the divide and of interpolated vertices
+inline Raster_Clipper raster_clipper_create(const Viewport &viewport)
+{
+	f32 half_width = 0.5f * viewport.width;
+	f32 half_height = 0.5f * viewport.height;
+	f32 center_x = viewport.x + half_width;
+	f32 center_y = viewport.y + half_height;
+	f32 guard_x = ((f32)RASTER_GUARD_BAND - 1.0f - lib::abs(center_x)) / half_width;
+	f32 guard_y = ((f32)RASTER_GUARD_BAND - 1.0f - lib::abs(center_y)) / half_height;
+	GameAssert(guard_x >= 1.0f && guard_y >= 1.0f && "Viewport does not fit into the guard band");
+
+	Raster_Clipper out{};
+	out.guard_max = _mm_setr_ps(guard_x, guard_y, 1.0f, 0.0f);
+	out.guard_min = _mm_setr_ps(-guard_x, -guard_y, 0.0f, 0.0f);
+	out.planes[RASTER_CLIP_GUARD_RIGHT] = { -1.0f, 0.0f, 0.0f, guard_x };
+	out.planes[RASTER_CLIP_GUARD_TOP] = { 0.0f, -1.0f, 0.0f, guard_y };
+	out.planes[RASTER_CLIP_FAR] = { 0.0f, 0.0f, -1.0f, 1.0f };
+	out.planes[RASTER_CLIP_GUARD_LEFT] = { 1.0f, 0.0f, 0.0f, guard_x };
+	out.planes[RASTER_CLIP_GUARD_BOTTOM] = { 0.0f, 1.0f, 0.0f, guard_y };
+	out.planes[RASTER_CLIP_NEAR] = { 0.0f, 0.0f, 1.0f, 0.0f };
+	out.planes[RASTER_CLIP_MIN_W] = { 0.0f, 0.0f, 0.0f, 1.0f };
+	out.offsets[RASTER_CLIP_MIN_W] = -RASTER_CLIP_W_EPSILON;
+	out.screen_offset = { center_x, center_y, viewport.min_depth };
+	out.screen_scale = { half_width, -half_height, viewport.max_depth - viewport.min_depth };
+	return out;
+}
+
+//? Both halves of the outcode with 4 compares: guard band / near / far in one pair, viewport sides in the other, and w
+//? against RASTER_CLIP_W_EPSILON
+inline u32 raster_clip_outcode(const Raster_Clipper *clipper, const lib::Vec4 position)
+{
+	__m128 p = position.simd;
+	__m128 w = _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 3, 3));
+	u32 guard_max = (u32)_mm_movemask_ps(_mm_cmpgt_ps(p, _mm_mul_ps(w, clipper->guard_max))) & 0x7;
+	u32 guard_min = (u32)_mm_movemask_ps(_mm_cmplt_ps(p, _mm_mul_ps(w, clipper->guard_min))) & 0x7;
+	u32 viewport_max = (u32)_mm_movemask_ps(_mm_cmpgt_ps(p, w)) & 0x3;
+	u32 viewport_min = (u32)_mm_movemask_ps(_mm_cmplt_ps(p, _mm_sub_ps(_mm_setzero_ps(), w))) & 0x3;
+	u32 min_w = _mm_cvtss_f32(w) < RASTER_CLIP_W_EPSILON;
+	return guard_max | (guard_min << RASTER_CLIP_GUARD_LEFT) | (min_w << RASTER_CLIP_MIN_W)
+	     | (viewport_max << RASTER_CLIP_VIEWPORT_RIGHT) | (viewport_min << RASTER_CLIP_VIEWPORT_LEFT);
+}
+
+inline Raster_Vertex raster_clip_project(const Raster_Clipper *clipper, const Raster_Clip_Vertex &v)
+{
+	f32 inv_w = 1.0f / v.position.w;
+	Raster_Vertex out;
+	out.position = clipper->screen_offset + v.position.xyz * inv_w * clipper->screen_scale;
+	out.color = v.color;
+	return out;
+}
+
+//? Sutherland-Hodgman against every plane set in "planes", near and minimum w first so that w > 0 for the rest. Intersection is
+//? always interpolated from the inside vertex towards the outside one, so an edge shared by two triangles gets bitwise
+//? the same new vertex in both of them and clipped meshes stay watertight. Returns vertex count of the polygon
+//? left in "polygon" (at most RASTER_CLIP_MAX_VERTICES), 0 when nothing is left
+internal u32 raster_clip_polygon(const Raster_Clipper *clipper, u32 planes, Raster_Clip_Vertex *polygon, u32 count)
+{
+	constexpr Raster_Clip_Plane order[] = { RASTER_CLIP_NEAR, RASTER_CLIP_MIN_W, RASTER_CLIP_FAR, RASTER_CLIP_GUARD_LEFT, RASTER_CLIP_GUARD_RIGHT,
+	                                        RASTER_CLIP_GUARD_TOP, RASTER_CLIP_GUARD_BOTTOM };
+	Raster_Clip_Vertex scratch[RASTER_CLIP_MAX_VERTICES];
+	Raster_Clip_Vertex *in = polygon;
+	Raster_Clip_Vertex *out = scratch;
+
+	for (Raster_Clip_Plane plane : order)
+	{
+		if (!(planes & (1u << plane)))
+			continue;
+
+		const lib::Vec4 equation = clipper->planes[plane];
+		const f32 offset = clipper->offsets[plane];
+		u32 out_count = 0;
+		f32 d_prev = lib::dot(equation, in[count - 1].position) + offset;
+		for (u32 i = 0, prev = count - 1; i < count; prev = i++)
+		{
+			f32 d = lib::dot(equation, in[i].position) + offset;
+			if ((d >= 0.0f) != (d_prev >= 0.0f))
+			{
+				const Raster_Clip_Vertex &inside = d >= 0.0f ? in[i] : in[prev];
+				const Raster_Clip_Vertex &outside = d >= 0.0f ? in[prev] : in[i];
+				f32 d_inside = d >= 0.0f ? d : d_prev;
+				f32 d_outside = d >= 0.0f ? d_prev : d;
+				f32 t = d_inside / (d_inside - d_outside);
+				out[out_count].position = inside.position + t * (outside.position - inside.position);
+				out[out_count].color = inside.color + t * (outside.color - inside.color);
+				out_count++;
+			}
+			if (d >= 0.0f)
+				out[out_count++] = in[i];
+			d_prev = d;
+		}
+
+		count = out_count;
+		swap(in, out);
+		if (count < 3)
+			return 0;
+	}
+
+	if (in != polygon)
+		memcpy(polygon, in, count * sizeof(Raster_Clip_Vertex));
+	return count;
+}
+
+struct Raster_Clip_Output
+{
+	Raster_Triangle *triangles;
+	u32 count;
+};
+
+//? Culls, clips, divides and maps "count" clip space triangles through "viewport" into screen space triangles ready for
+//? "raster_render". Submission order is kept, a clipped triangle is replaced in place by the fan of its polygon.
+//? First pass only classifies, so the output is a single block from "arena" sized for what actually needs clipping,
+//? trimmed to what was written at the end (it is the last allocation of "arena" when the function returns).
+//? "stats" is added to, so it can sum several batches (e.g. a range of the stream per thread, each with its own arena)
+[[nodiscard]]
+inline Raster_Clip_Output raster_clip_triangles(Alloc_Arena *arena, const Viewport &viewport, const Raster_Clip_Triangle *triangles,
+                                                u32 count, Raster_Clip_Stats *stats)
+{
+	ProfileFunction();
+	constexpr u8 culled = 0xFF; // outcodes of the rest fit into RASTER_CLIP_PLANES_MASK
+	Raster_Clipper clipper = raster_clipper_create(viewport);
+	Raster_Clip_Stats batch{};
+	batch.triangles_submitted = count;
+
+	u8 *classes = (u8 *)allocate(arena, lib::max(count, 1u));
+	for (u32 i = 0; i < count; ++i)
+	{
+		u32 c0 = raster_clip_outcode(&clipper, triangles[i].v[0].position);
+		u32 c1 = raster_clip_outcode(&clipper, triangles[i].v[1].position);
+		u32 c2 = raster_clip_outcode(&clipper, triangles[i].v[2].position);
+		u32 all = c0 & c1 & c2;
+		u32 any = c0 | c1 | c2;
+		u32 planes = any & RASTER_CLIP_PLANES_MASK;
+
+		classes[i] = all ? culled : (u8)planes;
+		batch.culled += all != 0;
+		batch.inside += !all && !any;
+		batch.guard_band += !all && any && !planes;
+		batch.clipped += !all && planes;
+	}
+
+	u64 max_out = batch.inside + batch.guard_band + batch.clipped * RASTER_CLIP_MAX_TRIANGLES;
+	Raster_Triangle *out = (Raster_Triangle *)allocate(arena, lib::max(max_out, (u64)1) * sizeof(Raster_Triangle), 64);
+	u32 out_count = 0;
+	for (u32 i = 0; i < count; ++i)
+	{
+		const Raster_Clip_Triangle *tri = &triangles[i];
+		if (classes[i] == culled)
+			continue;
+
+		if (classes[i] == 0)
+		{
+			for (u32 v = 0; v < 3; ++v)
+				out[out_count].v[v] = raster_clip_project(&clipper, tri->v[v]);
+			out_count++;
+			continue;
+		}
+
+		Raster_Clip_Vertex polygon[RASTER_CLIP_MAX_VERTICES] = { tri->v[0], tri->v[1], tri->v[2] };
+		u32 polygon_count = raster_clip_polygon(&clipper, classes[i], polygon, 3);
+		batch.clipped_empty += polygon_count == 0;
+		if (polygon_count == 0)
+			continue;
+
+		Raster_Vertex projected[RASTER_CLIP_MAX_VERTICES];
+		for (u32 v = 0; v < polygon_count; ++v)
+			projected[v] = raster_clip_project(&clipper, polygon[v]);
+		for (u32 v = 2; v < polygon_count; ++v)
+			out[out_count++] = { projected[0], projected[v - 1], projected[v] };
+	}
+
+	batch.triangles_out = out_count;
+	raster_clip_stats_add(stats, &batch);
+	out = (Raster_Triangle *)arena_resize_last(arena, out, (u64)lib::max(out_count, 1u) * sizeof(Raster_Triangle));
+	return { out, out_count };
+}
+
+// ===============================================================================================================================
+// ==================================================== COVERAGE VALIDATION ======================================================
+// ===============================================================================================================================
+struct Raster_Coverage_Report
+{
+	u64 missing;    // pixels not hit by any triangle
+	u64 double_hit; // pixels hit more than once
+};
+
+//? Jittered grid spanning one cell past every border of the target, each cell split along a random diagonal,
+//? so every edge is shared and the mesh covers whole target. Returns triangle count, "out" must hold 2*cells_x*cells_y
+inline u32 raster_build_shared_edge_mesh(Raster_Triangle *out, u32 cells_x, u32 cells_y, f32 width, f32 height, u32 seed)
+{
+	auto next_random = [&seed]()
+	{
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		return (f32)(seed & 0xFFFFFF) / (f32)0xFFFFFF;
+	};
+
+	f32 cell_w = width / (f32)(cells_x - 2);
+	f32 cell_h = height / (f32)(cells_y - 2);
+	auto vertex = [&](u32 x, u32 y, u32 salt)
+	{
+		// Jitter has to be a pure function of grid point, so neighbouring cells share exactly the same vertex
+		u32 hash = (x * 73856093u) ^ (y * 19349663u) ^ (salt * 83492791u);
+		hash ^= hash >> 13; hash *= 0x5bd1e995u; hash ^= hash >> 15;
+		f32 jx = ((f32)(hash & 0xFFFF) / 65535.0f - 0.5f) * 0.4f;
+		f32 jy = ((f32)(hash >> 16) / 65535.0f - 0.5f) * 0.4f;
+		Raster_Vertex out{};
+		out.position = { ((f32)x - 1.0f + jx) * cell_w, ((f32)y - 1.0f + jy) * cell_h, 0.5f };
+		out.color = { 1.0f, 1.0f, 1.0f };
+		return out;
+	};
+
+	u32 salt = seed;
+	u32 count = 0;
+	for (u32 y = 0; y < cells_y; ++y)
+	{
+		for (u32 x = 0; x < cells_x; ++x)
+		{
+			Raster_Vertex v00 = vertex(x, y, salt), v10 = vertex(x + 1, y, salt);
+			Raster_Vertex v01 = vertex(x, y + 1, salt), v11 = vertex(x + 1, y + 1, salt);
+			if (next_random() < 0.5f)
+			{
+				out[count++] = { v00, v10, v11 };
+				out[count++] = { v00, v11, v01 };
+			}
+			else
+			{
+				out[count++] = { v00, v10, v01 };
+				out[count++] = { v10, v11, v01 };
+			}
+		}
+	}
+	return count;
+}
+
+//? Renders "triangles" through "raster_render" with the setup and triangle kernels of "isa" (or the scalar reference kernel)
+//? and counts how often every pixel was inside of a triangle, taken from the coverage masks of the kernels themselves
+//? ("Raster_Context::coverage_hits"). So binning, the block walk with its edge and HiZ rejection and the clamped 32bit edge
+//? stepping are what is validated, not a separate reference. Every triangle is drawn nearer than all of the ones before it
+//? (flat depth), so hierarchical Z never rejects a block that holds a hit.
+//? For a closed shared-edge mesh covering whole target every pixel must be hit exactly once.
+//! Must be called from worker 0 of "jobs", like "raster_render"
+inline Raster_Coverage_Report raster_validate_coverage(Alloc_Arena *scratch, Job_System *jobs, Cpu_Isa isa, Raster_Kernel kernel,
+                                                       const Raster_Triangle *triangles, u32 triangle_count, u32 width, u32 height)
+{
+	arena_start_temp(scratch);
+	Raster_Triangle *ordered = push_type<Raster_Triangle>(scratch, lib::max(triangle_count, 1u));
+	for (u32 t = 0; t < triangle_count; ++t)
+	{
+		// Steps of 0.5 / count stay far above f32 spacing around 0.5 for any mesh that fits into memory
+		ordered[t] = triangles[t];
+		f32 z = 0.75f - 0.5f * (f32)t / (f32)triangle_count;
+		for (u32 v = 0; v < 3; ++v)
+			ordered[t].v[v].position.z = z;
+	}
+
+	u64 frame_memory_size = (u64)triangle_count * (sizeof(Raster_Setup) + 16 * sizeof(u32)) + MiB(1);
+	Raster_Context ctx = raster_create(scratch, frame_memory_size, jobs, width, height);
+	ctx.isa = isa;
+	ctx.kernel = kernel;
+	u64 texels = tiled_texel_count(width, height);
+	ctx.coverage_hits = (u32 *)allocate(scratch, texels * sizeof(u32), 64);
+	memset(ctx.coverage_hits, 0, texels * sizeof(u32));
+
+	Game_Framebuffer target
+	{
+		.base = (u32 *)allocate(scratch, texels * sizeof(u32), 64),
+		.width = width,
+		.height = height,
+		.max_width = width,
+		.max_height = height,
+		.pitch = 0,
+		.format = Game_Pixel_Format::RGBA8,
+		.layout = Game_Framebuffer_Layout::Tiled,
+		.tile_size = TILED_TILE_SIZE,
+		.block_size = TILED_BLOCK_SIZE,
+	};
+	raster_render(&ctx, &target, 0, ordered, triangle_count);
+
+	Raster_Coverage_Report out{};
+	for (u32 y = 0; y < height; ++y)
+	{
+		for (u32 x = 0; x < width; ++x)
+		{
+			u32 hits = ctx.coverage_hits[tiled_texel_index(x, y, ctx.tiles_x)];
+			out.missing += hits == 0;
+			out.double_hit += hits > 1;
+		}
+	}
+
+	arena_end_temp(scratch);
+	return out;
+}
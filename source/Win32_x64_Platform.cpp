@@ -5,14 +5,19 @@
 //? In case of porting to a different platform, this is the ONLY file you need to change
 
 #include <stdio.h> //temporary
-#include <omp.h>
 
 #include "Utils.hpp"
 #include "GameAsserts.hpp"
 #include "Game_Services.hpp"
+#include "Game.hpp"
+#include "Frame_Ring.hpp"
+#include "Frame_Pacing.hpp"
+#include "Cpu_Features.hpp"
 #include "Win32_x64_Platform.hpp"
 #include "DxManagment.hpp"
+#include "Input_Recording.hpp"
 #include "Allocators.hpp"
+#include "VM_Pages.hpp"
 #include "Views.hpp"
 #include "Math.hpp"
 
@@ -28,40 +33,126 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 	auto cores_count = windows_info.dwNumberOfProcessors;
 	AlwaysAssert(windows_info.wProcessorArchitecture == PROCESSOR_ARCHITECTURE_AMD64 
 	             && "This is not a 64-bit OS!");
+	// Before anything else, every hot path picks its kernels by "g_cpu.isa"
+	AlwaysAssert(cpu_init(Win32::parse_max_isa(lpCmdLine)) && "CPU without SSE4.2 and POPCNT, this build can not run on it");
 	
-	Win32::Platform_Clock clock = Win32::clock_create();
+	Win32::Platform_Clock clock = Win32::clock_create(Win32::parse_fps(lpCmdLine, Win32::get_monitor_freq()));
 	UINT schedulerGranularity = 1;
 	b32 schedulerError = (timeBeginPeriod(schedulerGranularity) == TIMERR_NOERROR);
+	// Without 1ms scheduler period "Sleep" may overshoot by a whole 15.6ms tick, margin starts pessimistic
+	Frame_Pacer pacer = frame_pacer_create((f64)clock.target_fps, schedulerError ? 0.002 : 0.016);
+	Frame_Time_Stats frame_stats{};
+	
+	// "-record FILE" writes every frame's input, "-replay FILE" feeds a recording back and returns to live input after it (not both).
+	// Replay renders at the extent it was recorded at, otherwise frames would not be the same
+	Input_Recording input_recording{};
+	const char *record_file = nullptr;
+	const char *replay_file = nullptr;
+	for (s32 i = 1; i + 1 < __argc; ++i)
+	{
+		if (!strcmp(__argv[i], "-record"))
+			record_file = __argv[i + 1];
+		else if (!strcmp(__argv[i], "-replay"))
+			replay_file = __argv[i + 1];
+	}
+	if (record_file && replay_file)
+	{
+		MessageBoxA(NULL, "-record and -replay are exclusive", "error", 0);
+		return 1;
+	}
+	if (replay_file && !input_replay_begin(&input_recording, replay_file))
+	{
+		char error_buf[320];
+		sprintf_s(error_buf, sizeof(error_buf), "Could not replay \"%s\", missing file or recording of a different build",
+		          replay_file);
+		MessageBoxA(NULL, error_buf, "error", 0);
+		return 1;
+	}
 	
 	Win32::register_mouse_raw_input();
 	HWND win_handle = Win32::create_window(1280, 720, "Raster");
+	if (input_recording.is_replaying)
+		Win32::set_window_client_dims(win_handle, (s32)input_recording.header.width, (s32)input_recording.header.height);
 	auto&& [width, height] = Win32::get_window_client_dims(win_handle);
+	auto&& [max_width, max_height] = Win32::get_max_client_dims();
+	if (input_recording.is_replaying && (width != input_recording.header.width || height != input_recording.header.height))
+	{
+		char error_buf[160];
+		sprintf_s(error_buf, sizeof(error_buf), "Recording was made at %ux%u, window is %ux%u, replayed frames will differ",
+		          input_recording.header.width, input_recording.header.height, width, height);
+		MessageBoxA(NULL, error_buf, "warning", 0);
+	}
+	if (record_file && !input_recording_begin(&input_recording, record_file, width, height))
+	{
+		char error_buf[320];
+		sprintf_s(error_buf, sizeof(error_buf), "Could not create recording \"%s\"", record_file);
+		MessageBoxA(NULL, error_buf, "error", 0);
+		return 1;
+	}
+	
+	// Only reserved, application memory is committed as it grows
+	Alloc_Arena global_memory = arena_reserve(GiB(2));
+	AlwaysAssert(global_memory.base && "Failed to reserve memory from Windows");
 	
-	Alloc_Arena global_memory
+	// Tiled frame ring slots are reserved once for the biggest possible client area (whole virtual screen), but only
+	// the active extent of them is ever committed, see "ring_slots_allocate"
+	Alloc_Arena ring_memory = arena_reserve(FRAME_RING_MAX_SLOTS * (frame_ring_slot_size(max_width, max_height, 0, true) + 64));
+	AlwaysAssert(ring_memory.base && "Failed to reserve memory from Windows");
+	
+	// Worker threads live for the whole run, main thread is worker 0 and joins every fork inside of the frame
+	constexpr u32 profiler_events_per_thread = 1 << 16;
+	u64 platform_memory_size = job_system_memory_size(cores_count) + profiler_memory_size(cores_count + 1, profiler_events_per_thread);
+	Alloc_Arena platform_memory
 	{
-		.max_size = GiB(2),
-		.base = (byte*)VirtualAlloc(0, GiB(2), MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE)
+		.max_size = platform_memory_size,
+		.base = (byte*)VirtualAlloc(0, platform_memory_size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE)
 	};
-	AlwaysAssert(global_memory.base && "Failed to allocate memory from Windows");
-	
-	omp_set_max_active_levels(2);
-	omp_set_num_threads(cores_count);
+	AlwaysAssert(platform_memory.base && "Failed to allocate memory from Windows");
+	profiler_init(&platform_memory, cores_count + 1, profiler_events_per_thread);
+	profiler_register_thread("Main");
+	Job_System jobs{};
+	job_system_create(&jobs, &platform_memory, cores_count);
 	
 	DX_Machine machine{};
 	DX_Context context{};
-	ID3D11Texture2D *back_buffer = nullptr;
-	ID3D11Texture2D *cpu_buffer = nullptr;
 	HRESULT hr;
 	
 	if (!dx_init_resources(&machine, &context, win_handle))
 		return 0;
 	
+	// Frames are rendered into tiled CPU side slots, present thread detiles them into the mapped texture and presents.
+	//! Not rendering straight into the mapped texture is deliberate: D3D11 immediate context belongs to the present thread,
+	//! keeping the texture mapped while game renders would serialize rendering with presenting (no frame overlap of the ring)
+	//! and "Map" with WRITE_DISCARD may stall on the GPU. Detiling costs one streaming pass of the frame on the present thread
+	DX_Present_Target present_target{ .machine = &machine, .context = &context };
+	if (!dx_create_cpu_buffer(&machine, &present_target, max_width, max_height))
+		return 0;
+	Frame_Ring frame_ring{};
+	frame_ring_create(&frame_ring, FRAME_RING_MAX_SLOTS, dx_present_frame, &present_target);
+	u32 *ring_pixels[FRAME_RING_MAX_SLOTS] = {};
+	// Slots of the active extent, called on resize with the ring flushed. Carving them out twice is on purpose: reset with
+	// "Decommit" keeps only what the first pass used, so pages of a bigger previous extent go back to the OS, and the
+	// second pass gets the very same (still committed) addresses
+	auto ring_slots_allocate = [&](u32 slot_width, u32 slot_height)
+	{
+		u64 slot_size = frame_ring_slot_size(slot_width, slot_height, 0, true);
+		for (u32 pass = 0; pass < 2; ++pass)
+		{
+			arena_reset(&ring_memory, pass ? Arena_Reset::Decommit : Arena_Reset::Keep);
+			for (u32 i = 0; i < frame_ring.slot_count; ++i)
+				ring_pixels[i] = (u32 *)allocate(&ring_memory, slot_size, 64);
+		}
+	};
+	u32 extent_width = 0;
+	u32 extent_height = 0;
+	
 	Game_Input gameInputBuffer[2] = {};
 	Game_Input *newInputs = &gameInputBuffer[0];
 	Game_Input *oldInputs = &gameInputBuffer[1];
 	
 	while (Win32::g_is_running)
 	{
+		ProfileScope("Frame");
 		u64 tick_start = Win32::get_performance_ticks();
 		static u32 counter;
 		
@@ -75,6 +166,7 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 			newKeyboardMouseController->mouse.x = oldKeyboardMouseController->mouse.x;
 			newKeyboardMouseController->mouse.y = oldKeyboardMouseController->mouse.y;
 		}
+		newInputs->delta_s = 1.0f / (f32)(clock.target_fps ? clock.target_fps : 60);
 
 		MSG msg = {};
 		while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
@@ -89,93 +181,102 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 			}
 		}
 		
+		// Messages are still pumped while replaying, only their input is replaced
+		if (input_recording.is_replaying)
+		{
+			if (!input_replay_read(&input_recording, newInputs))
+				input_recording_end(&input_recording);
+		}
+		else if (input_recording.file && !input_recording_write(&input_recording, newInputs))
+			input_recording_end(&input_recording);
+		
 		auto&& [new_width, new_height] = Win32::get_window_client_dims(win_handle);
-		if ((width != new_width || height != new_height) || !cpu_buffer)
+		if ((width != new_width || height != new_height) || !present_target.back_buffer)
 		{
-			if (cpu_buffer)
+			// Swap chain and ring slots follow the window, upload texture stays and only its active extent is written.
+			// Present thread must be idle before back buffer goes away
+			frame_ring_flush(&frame_ring);
+			if (present_target.back_buffer)
 			{
-				back_buffer->Release();
-				cpu_buffer->Release();
-				back_buffer = nullptr;
-				cpu_buffer = nullptr;
+				present_target.back_buffer->Release();
+				present_target.back_buffer = nullptr;
 			}
 			
 			width = new_width;
 			height = new_height;
+			extent_width = lib::min(width, max_width);
+			extent_height = lib::min(height, max_height);
 			
 			if (width && height)
 			{
 				hr = machine.swap_chain->ResizeBuffers(1, width, height, DXGI_FORMAT_R8G8B8A8_UNORM, 0);
 				AssertHR(hr);
-				hr =  machine.swap_chain->GetBuffer(0, __uuidof(ID3D11Texture2D), (void **)&back_buffer);
-				AssertHR(hr);
-					
-				D3D11_TEXTURE2D_DESC tex_desc
-				{
-					.Width = width,
-					.Height = height,
-					.MipLevels = 1,
-					.ArraySize = 1,
-					.Format = DXGI_FORMAT_R8G8B8A8_UNORM,
-					.SampleDesc = { 1, 0 },
-					.Usage = D3D11_USAGE_DYNAMIC,
-					.BindFlags = D3D11_BIND_SHADER_RESOURCE,
-					.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE,
-				};
-
-				hr = machine.device->CreateTexture2D(&tex_desc, nullptr, &cpu_buffer);
+				hr =  machine.swap_chain->GetBuffer(0, __uuidof(ID3D11Texture2D), (void **)&present_target.back_buffer);
 				AssertHR(hr);
+				
+				ring_slots_allocate(extent_width, extent_height);
+				for (u32 i = 0; i < frame_ring.slot_count; ++i)
+					frame_ring_bind_slot(&frame_ring, i, ring_pixels[i], extent_width, extent_height, 0, true);
 			}
 		}
 		
 		if (width && height)
 		{
-			D3D11_MAPPED_SUBRESOURCE mapped;
-			// Stop GPU access to the CPU-pixel buffer data
-			hr = context.imm_context->Map((ID3D11Resource *)cpu_buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
-			AssertHR(hr);
-			
-			// Drawing CPU-pixels
-			//TODO: Move drawing code out to application layer
-			//TODO: Consider memcpy from/to additional buffer instead of directly from/to mapped, basedo on
-			//		https://learn.microsoft.com/en-us/windows/win32/api/d3d11/nf-d3d11-id3d11devicecontext-map
-			// 		To never actually read directly from mapped resource
-			u32 *pixel = (u32 *)mapped.pData;
-			#pragma omp parallel shared(counter, pixel) // seems to be "stuttering" sometimes
+			// Blocks only when present thread is a whole ring behind
+			Frame_Ring_Slot *slot;
 			{
-				#pragma omp for
-				for (u32 xy = 0; xy < width*height; ++xy) 
-				{
-//					u32 x = xy % width;
-//					u32 y = xy / width;
-//		
-//					u32 r = (((x + counter) % width) * 255 / width);;
-//					u32 g = (y * 255 / height);
-//					u32 b = 0;
-					
-					
-					pixel[xy] = (b << 16) | (g << 8) | (r << 0);
-				}
+				ProfileScope("Frame Ring Acquire");
+				slot = frame_ring_acquire(&frame_ring);
 			}
-
+			Game_Framebuffer game_framebuffer
+			{
+				.base = slot->pixels,
+				.width = slot->width,
+				.height = slot->height,
+				.max_width = max_width,
+				.max_height = max_height,
+				.pitch = slot->pitch,
+				.format = Game_Pixel_Format::RGBA8,
+				.layout = slot->is_tiled ? Game_Framebuffer_Layout::Tiled : Game_Framebuffer_Layout::Linear,
+				.tile_size = TILED_TILE_SIZE,
+				.block_size = TILED_BLOCK_SIZE,
+			};
+			game_update_and_render(&global_memory, &jobs, newInputs, &game_framebuffer);
+			frame_ring_submit(&frame_ring);
 			counter++;
-			// Allow GPU access to the CPU-pixel buffer data
-			context.imm_context->Unmap((ID3D11Resource *)cpu_buffer, 0);
-			context.imm_context->CopyResource((ID3D11Resource *)back_buffer, (ID3D11Resource *)cpu_buffer);
 		}
 		
-		hr = machine.swap_chain->Present(0,0);
-		AssertHR(hr);
-		f64 frame_time_ms = Win32::get_elapsed_ms_here(clock, tick_start);
+		Game_Input *temp_inputs = newInputs;
+		newInputs = oldInputs;
+		oldInputs = temp_inputs;
+		
+		// Whole frame period including pacing wait, which is what ends up on screen
+		{
+			ProfileScope("Pacing Wait");
+			Win32::clock_update_and_wait(clock, &pacer, tick_start);
+		}
+		frame_stats_push(&frame_stats, clock.delta_s * 1000.0f);
 		
-		if (counter % 100 == 0)
+		if (counter % 100 == 0 && width && height)
 		{
-			char time_buf[32];
-			sprintf_s(time_buf, sizeof(time_buf), "%.3lf ms", frame_time_ms);
+			Frame_Time_Report report = frame_stats_report(&frame_stats);
+			char time_buf[160];
+			sprintf_s(time_buf, sizeof(time_buf), "avg %.2f | p50 %.2f | p95 %.2f | p99 %.2f | max %.2f ms | oversleep %.3f ms | %s",
+			          report.avg_ms, report.p50_ms, report.p95_ms, report.p99_ms, report.max_ms, pacer.oversleep_mean_s * 1000.0,
+			          cpu_isa_name(g_cpu.isa));
 			SetWindowText(win_handle, time_buf);
 		}
 	}
 	
+	frame_ring_destroy(&frame_ring);
+	vm_pages_release(ring_memory.base, ring_memory.max_size);
+	job_system_destroy(&jobs);
+	input_recording_end(&input_recording);
+	profiler_export_chrome_trace("trace.json");
+	if (present_target.back_buffer)
+		present_target.back_buffer->Release();
+	if (present_target.cpu_buffer)
+		present_target.cpu_buffer->Release();
 	UnregisterClassA("Raster", GetModuleHandle(nullptr));
 	return 0;
 }
\ No newline at end of file
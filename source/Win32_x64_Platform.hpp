@@ -135,6 +135,31 @@ namespace Win32
 		return out;
 	}
 	
+	// Resizes window so its client area (not the outer frame) is exactly "w" x "h", window styles are not known upfront
+	internal void set_window_client_dims(HWND window, const s32 w, const s32 h)
+	{
+		RECT window_rect, client_rect;
+		GetWindowRect(window, &window_rect);
+		GetClientRect(window, &client_rect);
+		s32 frame_w = (window_rect.right - window_rect.left) - (client_rect.right - client_rect.left);
+		s32 frame_h = (window_rect.bottom - window_rect.top) - (client_rect.bottom - client_rect.top);
+		SetWindowPos(window, nullptr, 0, 0, w + frame_w, h + frame_h, SWP_NOMOVE | SWP_NOZORDER | SWP_NOACTIVATE);
+	}
+
+	//? Bounding box of all monitors, client area of a window can not grow past it with default tracking size,
+	//? so everything sized for it never has to be reallocated on resize
+	internal auto get_max_client_dims()
+	{
+		struct Output
+		{
+			u32 w; u32 h;
+		} out;
+
+		out.w = (u32)GetSystemMetrics(SM_CXVIRTUALSCREEN);
+		out.h = (u32)GetSystemMetrics(SM_CYVIRTUALSCREEN);
+		return out;
+	}
+	
 	// ===============================================================================================================================
 	// =========================================== MOUSE & KEYBOARD EVENTS HANDLING ==================================================
 	// ===============================================================================================================================
@@ -321,13 +346,37 @@ namespace Win32
 		EnumDisplaySettingsA(0, ENUM_CURRENT_SETTINGS, &devInfo);
 		return (s32)devInfo.dmDisplayFrequency;
 	}
+
+	//? "-isa sse42|avx2|avx512" anywhere in the command line caps kernels for benchmarking (see "Cpu_Features.hpp")
+	internal Cpu_Isa parse_max_isa(const char *cmd_line)
+	{
+		Cpu_Isa out = Cpu_Isa::AVX512;
+		const char *arg = strstr(cmd_line, "-isa ");
+		if (arg)
+		{
+			char name[16] = {};
+			sscanf_s(arg + 5, "%15s", name, (unsigned)sizeof(name));
+			cpu_isa_parse(name, &out);
+		}
+		return out;
+	}
+	
+	//? "-fps N" anywhere in the command line paces at N instead of the monitor refresh rate, 0 means unpaced (as POSIX "-fps")
+	internal s32 parse_fps(const char *cmd_line, s32 monitor_fps)
+	{
+		s32 out = monitor_fps;
+		const char *arg = strstr(cmd_line, "-fps ");
+		if (arg)
+			sscanf_s(arg + 5, "%d", &out);
+		return out > 0 ? out : 0;
+	}
 	
 	// ===============================================================================================================================
 	// ========================================================= TIMERS ==============================================================
 	// ===============================================================================================================================
 	internal Platform_Clock clock_create(s32 fps = 60)
 	{
-		Platform_Clock out{ .target_fps = 60};
+		Platform_Clock out{ .target_fps = fps };
 		LARGE_INTEGER temp{};
 		QueryPerformanceFrequency(&temp);
 		out.clock_freq = temp.QuadPart;
@@ -348,18 +397,23 @@ namespace Win32
 		return (f64)((end.QuadPart - tick_start) * 1000) / clock.clock_freq;
 	}
 	
-	internal void clock_update_and_wait(Platform_Clock &clock, u64 tick_start)
+	//? Hybrid pacing: coarse "Sleep" (1ms scheduler period) until calibrated margin before the deadline, then spin.
+	//? Every sleep is measured, so the margin follows oversleep of this machine instead of a guessed constant
+	internal void clock_update_and_wait(Platform_Clock &clock, Frame_Pacer *pacer, u64 tick_start)
 	{
-		f64 time_work_s = get_elapsed_seconds_here(clock, tick_start);
-		f64 target_s = 1.0 / (f64)clock.target_fps;
-		f64 time_to_wait_s = target_s - time_work_s;
-
-		if (time_to_wait_s > 0 && time_to_wait_s < target_s)
+		if (pacer->target_s > 0.0)
 		{
-			Sleep((DWORD)(time_to_wait_s * 1000));
-			time_to_wait_s = get_elapsed_seconds_here(clock, tick_start);
-			while (time_to_wait_s < target_s)
-				time_to_wait_s = get_elapsed_seconds_here(clock, tick_start);
+			f64 sleep_s = frame_pacer_sleep_budget(pacer, pacer->target_s - get_elapsed_seconds_here(clock, tick_start));
+			DWORD sleep_ms = (DWORD)(sleep_s * 1000.0);
+			if (sleep_ms > 0)
+			{
+				LARGE_INTEGER sleep_start{};
+				QueryPerformanceCounter(&sleep_start);
+				Sleep(sleep_ms);
+				frame_pacer_record_sleep(pacer, (f64)sleep_ms / 1000.0, get_elapsed_seconds_here(clock, sleep_start.QuadPart));
+			}
+			while (get_elapsed_seconds_here(clock, tick_start) < pacer->target_s)
+				_mm_pause();
 		}
 
 		clock.delta_s = (f32)get_elapsed_seconds_here(clock, tick_start);